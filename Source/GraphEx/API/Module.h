@@ -2,6 +2,8 @@
 
 #include "ModuleRegistry.h"
 
+#include "Core/Plugin.h"
+
 
 namespace GraphEx
 {
@@ -32,6 +34,12 @@ struct GRAPHEX_EXPORTABLE ModuleContainerBase
     std::tuple<ModuleTs&...> getsContained() const;
 
     virtual ModuleContainerId getModuleContainerId() const = 0;
+
+protected:
+    friend class ModuleRegistry;
+
+    // Called by the registry when it registered a plugin module, and again whenever a reload recreated it
+    virtual void onPluginModuleRegistered(const std::shared_ptr<PluginModule>& pModule) {}
 };
 
 
@@ -116,6 +124,46 @@ struct GRAPHEX_EXPORTABLE Module
 };
 
 
+// Module that lives in a shared library loaded through the Falcor plugin manager, and that is swapped at runtime when the
+//    library is rebuilt. The library must export a registerPlugin function registering the module class, see GRAPHEX_PLUGIN_MODULE,
+//    and link against GraphEx built as a shared library (GRAPHEX_PLUGIN_MODULES), so that it shares the registries of the host.
+// Its state (if any) is carried over the reload, but nothing else is, so do not hand out references to the module or register
+//    EventManager handlers from it, as those cannot be unregistered when the old library is released!
+struct GRAPHEX_EXPORTABLE PluginModule : Module
+{
+    struct PluginInfo
+    {
+        std::string desc;
+    };
+
+    using PluginCreate = std::shared_ptr<PluginModule>(*)(ModuleContainerBase* pContainer);
+
+    FALCOR_PLUGIN_BASE_CLASS(PluginModule);
+
+    explicit PluginModule(ModuleContainerBase* pContainer)
+        : Module(pContainer) {}
+
+    // Overridden by GRAPHEX_PLUGIN_MODULE, as the state type is only known inside the plugin library
+    virtual std::unique_ptr<Internal::ModuleStateSerializerBase> createStateSerializer(const std::shared_ptr<PluginModule>&) const
+    {
+        return nullptr;
+    }
+};
+
+
+#define GRAPHEX_PLUGIN_MODULE(cls, type, desc)                                                                                  \
+    FALCOR_PLUGIN_CLASS(cls, type, desc);                                                                                       \
+    static std::shared_ptr<GraphEx::PluginModule> create(GraphEx::ModuleContainerBase* pContainer)                              \
+    {                                                                                                                           \
+        return std::make_shared<cls>(pContainer);                                                                               \
+    }                                                                                                                           \
+    std::unique_ptr<GraphEx::Internal::ModuleStateSerializerBase> createStateSerializer(                                        \
+        const std::shared_ptr<GraphEx::PluginModule>& pSelf) const override                                                     \
+    {                                                                                                                           \
+        return GraphEx::ModuleRegistry::createStateSerializer<cls>(std::static_pointer_cast<cls>(pSelf));                        \
+    }
+
+
 template<typename ModuleBaseT>
 struct ModuleContainer : ModuleContainerBase
 {
@@ -124,9 +172,14 @@ struct ModuleContainer : ModuleContainerBase
     template<typename ModuleT, typename... Args>
     void registerModule(Args&&... args);
 
+    // Loads the module of type pluginType from the given library, and reloads it whenever the library changes on disk
+    void registerPluginModule(const std::filesystem::path& libraryPath, const std::string& pluginType);
+
 protected:
     virtual void onModuleRegistered(const std::shared_ptr<ModuleBaseT>& pModule);
     virtual std::vector<std::shared_ptr<ModuleBaseT>> getAllModules() const;
+
+    void onPluginModuleRegistered(const std::shared_ptr<PluginModule>& pModule) override;
 };
 
 
@@ -144,6 +197,27 @@ void ModuleContainer<ModuleBaseT>::registerModule(Args&&... args)
 }
 
 
+template<typename ModuleBaseT>
+void ModuleContainer<ModuleBaseT>::registerPluginModule(const std::filesystem::path& libraryPath, const std::string& pluginType)
+{
+    static_assert(std::is_same_v<ModuleBaseT, Module>, "Plugin modules can only be registered in containers of plain Modules.");
+
+    // Announced through onPluginModuleRegistered, here and after every reload
+    ModuleRegistry::get().registerPluginModuleForContainer(getModuleContainerId(), static_cast<ModuleContainerBase*>(this), libraryPath,
+                                                           pluginType);
+}
+
+
+template<typename ModuleBaseT>
+void ModuleContainer<ModuleBaseT>::onPluginModuleRegistered(const std::shared_ptr<PluginModule>& pModule)
+{
+    if constexpr (std::is_same_v<ModuleBaseT, Module>)
+    {
+        onModuleRegistered(pModule);
+    }
+}
+
+
 template<typename ModuleBaseT>
 void ModuleContainer<ModuleBaseT>::onModuleRegistered(const std::shared_ptr<ModuleBaseT>& pModule)
 {
@@ -371,6 +445,10 @@ struct HasSerializableState : Internal::HasSerializableStateTag
     virtual void setState(std::shared_ptr<ModuleStateT> pState);
     virtual const std::shared_ptr<ModuleStateT>& getState() const;
 
+    // Call this at every mutation point of the module that changes what getState() returns, incremental saves rely on it
+    void markStateDirty() const;
+    uint64_t getStateRevision() const;
+
 protected:
     std::shared_ptr<ModuleStateT> mpState;
 
@@ -378,6 +456,8 @@ private:
     // For ModuleRegistry, to access ModuleStateT
     using StateType = ModuleStateT;
 
+    mutable uint64_t mStateRevision = 1;
+
     friend class ModuleRegistry;
 };
 
@@ -391,6 +471,7 @@ template<typename ModuleStateT>
 void HasSerializableState<ModuleStateT>::setState(std::shared_ptr<ModuleStateT> pState)
 {
     mpState = std::move(pState);
+    markStateDirty();
 }
 
 
@@ -400,6 +481,20 @@ const std::shared_ptr<ModuleStateT>& HasSerializableState<ModuleStateT>::getStat
     return mpState;
 }
 
+
+template<typename ModuleStateT>
+void HasSerializableState<ModuleStateT>::markStateDirty() const
+{
+    ++mStateRevision;
+}
+
+
+template<typename ModuleStateT>
+uint64_t HasSerializableState<ModuleStateT>::getStateRevision() const
+{
+    return mStateRevision;
+}
+
 } // namespace GraphEx
 
 
@@ -59,12 +59,676 @@ std::optional<ModuleId> ModuleRegistry::getModuleIdForTypeId(const TypeId& typeI
 }
 
 
+auto ModuleRegistry::registerPluginModuleForContainer(
+    const ModuleContainerId& containerId,
+    ModuleContainerBase* pContainer,
+    const std::filesystem::path& libraryPath,
+    const std::string& pluginType
+) -> ModulePtr<PluginModule>
+{
+#ifndef GRAPHEX_PLUGIN_MODULES
+    FALCOR_THROW("Attempted to register plugin module '{}', but GraphEx was built without GRAPHEX_PLUGIN_MODULES", pluginType);
+#endif // GRAPHEX_PLUGIN_MODULES
+
+    const auto libraryKey = std::filesystem::absolute(libraryPath).lexically_normal().string();
+
+    if (const auto it = mPluginLibraries.find(libraryKey); it == mPluginLibraries.end())
+    {
+        auto library = PluginLibrary{ };
+        library.libraryPath = libraryKey;
+        loadPluginLibrary(library);
+        mPluginLibraries.emplace(libraryKey, std::move(library));
+    }
+
+    auto record = PluginModuleRecord{ containerId, pContainer, libraryKey, pluginType, std::nullopt };
+    const auto pModule = instantiatePluginModule("", record);
+    const auto moduleId = std::static_pointer_cast<Module>(pModule)->getModuleId();
+
+    mPluginModules.emplace(moduleId, std::move(record));
+    getModuleIdsForContainerMutable(containerId).insert(moduleId);
+    pContainer->onPluginModuleRegistered(pModule);
+
+    return pModule;
+}
+
+
+void ModuleRegistry::reloadChangedPluginModules(Falcor::RenderContext* pRenderContext)
+{
+    for (auto& [ libraryKey, library ] : mPluginLibraries)
+    {
+        if (hasPluginLibraryChanged(library))
+        {
+            reloadPluginLibrary(libraryKey, library, pRenderContext);
+        }
+    }
+}
+
+
+auto ModuleRegistry::instantiatePluginModule(const ModuleId& moduleId, PluginModuleRecord& record) -> ModulePtr<PluginModule>
+{
+    const auto pModule = Falcor::PluginManager::instance().createClass<PluginModule>(record.pluginType, record.pContainer);
+
+    if (!pModule)
+    {
+        FALCOR_THROW("Plugin library '{}' does not provide a plugin module of type '{}'", record.libraryKey, record.pluginType);
+    }
+
+    const auto newModuleId = std::static_pointer_cast<Module>(pModule)->getModuleId();
+
+    if (!moduleId.empty() && newModuleId != moduleId)
+    {
+        FALCOR_THROW("Reloaded plugin module of type '{}' changed its ID from '{}' to '{}'. This is illegal", record.pluginType, moduleId,
+                     newModuleId);
+    }
+
+    if (hasModule(newModuleId))
+    {
+        FALCOR_THROW(
+            "Attempted register a Module with an ID that is already associated with another module: '{}' "
+            "Module IDs must be unqiue. This is illegal",
+            newModuleId
+        );
+    }
+
+    // Plugin modules are not added to the type dictionary: their type info lives in a library that may be unloaded
+    mModules.emplace(newModuleId, pModule);
+
+    if (auto pSerializer = pModule->createStateSerializer(pModule))
+    {
+        mModuleStateSerializers.emplace(newModuleId, std::move(pSerializer));
+    }
+
+    return pModule;
+}
+
+
+void ModuleRegistry::loadPluginLibrary(PluginLibrary& library)
+{
+    const auto shadowDirectory = std::filesystem::temp_directory_path() / "GraphEx" / "Plugins";
+    const auto shadowFileName =
+        library.libraryPath.stem().string() + "." + std::to_string(++library.generation) + library.libraryPath.extension().string();
+
+    std::filesystem::create_directories(shadowDirectory);
+
+    library.loadedWriteTime = std::filesystem::last_write_time(library.libraryPath);
+    library.observedWriteTime = library.loadedWriteTime;
+    library.loadedLibraryPath = shadowDirectory / shadowFileName;
+
+    std::filesystem::copy_file(library.libraryPath, library.loadedLibraryPath, std::filesystem::copy_options::overwrite_existing);
+
+    if (!Falcor::PluginManager::instance().loadPlugin(library.loadedLibraryPath))
+    {
+        FALCOR_THROW("Failed to load plugin library '{}'", library.libraryPath.string());
+    }
+}
+
+
+void ModuleRegistry::releasePluginLibrary(PluginLibrary& library)
+{
+    if (library.loadedLibraryPath.empty())
+    {
+        return;
+    }
+
+    Falcor::PluginManager::instance().releasePlugin(library.loadedLibraryPath);
+
+    std::error_code ec;
+    std::filesystem::remove(library.loadedLibraryPath, ec);
+    library.loadedLibraryPath.clear();
+}
+
+
+bool ModuleRegistry::hasPluginLibraryChanged(PluginLibrary& library) const
+{
+    // The build may still be writing the library, so we only report a change once its write time has settled
+    constexpr auto SETTLE_TIME = std::chrono::milliseconds(500);
+
+    std::error_code ec;
+    const auto writeTime = std::filesystem::last_write_time(library.libraryPath, ec);
+
+    if (ec || writeTime == library.loadedWriteTime)
+    {
+        return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+
+    if (writeTime != library.observedWriteTime)
+    {
+        library.observedWriteTime = writeTime;
+        library.observedAt = now;
+        return false;
+    }
+
+    return now - library.observedAt >= SETTLE_TIME;
+}
+
+
+void ModuleRegistry::reloadPluginLibrary(const std::string& libraryKey, PluginLibrary& library, Falcor::RenderContext* pRenderContext)
+{
+    std::vector<ModuleId> moduleIds;
+
+    for (const auto& [ moduleId, record ] : mPluginModules)
+    {
+        if (record.libraryKey == libraryKey)
+        {
+            moduleIds.push_back(moduleId);
+        }
+    }
+
+    // Preserve the states of the live modules first, so that a failure leaves the old modules running untouched
+    for (const auto& moduleId : moduleIds)
+    {
+        const auto itModule = mModules.find(moduleId);
+
+        if (itModule == mModules.end())
+        {
+            continue;  // Module is missing since a previous failed reload, its state is still carried
+        }
+
+        // The state serializer of the module holds a reference to it as well
+        const auto itSerializer = mModuleStateSerializers.find(moduleId);
+        const auto registryRefCount = itSerializer != mModuleStateSerializers.end() ? 2 : 1;
+
+        if (itModule->second.use_count() > registryRefCount)
+        {
+            Falcor::logError("Could not reload plugin library '{}': module '{}' is still referenced outside of the module registry.",
+                             library.libraryPath.string(), moduleId);
+            library.loadedWriteTime = library.observedWriteTime;
+            return;
+        }
+
+        if (itSerializer != mModuleStateSerializers.end())
+        {
+            std::ostringstream oss;
+
+            try
+            {
+                if (auto ar = Internal::SerializationManager::get().beginBinarySave(oss))
+                {
+                    itSerializer->second->saveState(*ar);
+                }
+
+                Internal::SerializationManager::get().finish();
+            }
+            catch (const std::exception& e)
+            {
+                Internal::SerializationManager::get().finish();
+                Falcor::logError("Could not reload plugin library '{}': failed to preserve the state of module '{}':\n{}",
+                                 library.libraryPath.string(), moduleId, e.what());
+                library.loadedWriteTime = library.observedWriteTime;
+                return;
+            }
+
+            mPluginModules.at(moduleId).carriedState = oss.str();
+        }
+    }
+
+    // Tear down the old modules, every object and type info from the old library must be gone before it is released
+    for (const auto& moduleId : moduleIds)
+    {
+        if (const auto itModule = mModules.find(moduleId); itModule != mModules.end())
+        {
+            itModule->second->cleanup();
+            mModuleStateSerializers.erase(moduleId);
+            mModules.erase(itModule);
+        }
+
+        const auto& record = mPluginModules.at(moduleId);
+        getModuleIdsForContainerMutable(record.containerId).erase(moduleId);
+    }
+
+    releasePluginLibrary(library);
+
+    try
+    {
+        loadPluginLibrary(library);
+    }
+    catch (const std::exception& e)
+    {
+        // Try again when the library changes next time, the carried states are kept until then
+        Falcor::logError("Failed to reload plugin library '{}':\n{}", library.libraryPath.string(), e.what());
+        library.loadedWriteTime = library.observedWriteTime;
+        return;
+    }
+
+    for (const auto& moduleId : moduleIds)
+    {
+        auto& record = mPluginModules.at(moduleId);
+        ModulePtr<PluginModule> pModule;
+
+        try
+        {
+            pModule = instantiatePluginModule(moduleId, record);
+            getModuleIdsForContainerMutable(record.containerId).insert(moduleId);
+            pModule->init(pRenderContext);
+        }
+        catch (const std::exception& e)
+        {
+            Falcor::logError("Failed to recreate plugin module '{}' from plugin library '{}':\n{}", moduleId,
+                             library.libraryPath.string(), e.what());
+            mModuleStateSerializers.erase(moduleId);
+            mModules.erase(moduleId);
+            getModuleIdsForContainerMutable(record.containerId).erase(moduleId);
+            continue;
+        }
+
+        const auto itSerializer = mModuleStateSerializers.find(moduleId);
+
+        if (record.carriedState && itSerializer != mModuleStateSerializers.end())
+        {
+            std::istringstream iss(*record.carriedState);
+
+            try
+            {
+                if (auto ar = Internal::SerializationManager::get().beginBinaryLoad(iss))
+                {
+                    itSerializer->second->loadState(*ar);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                Falcor::logWarning("Could not restore the state of reloaded plugin module '{}', it starts from its default state:\n{}",
+                                   moduleId, e.what());
+            }
+
+            Internal::SerializationManager::get().finish();
+        }
+
+        record.carriedState.reset();
+
+        // Announced like the original registration, once the module got its state
+        record.pContainer->onPluginModuleRegistered(pModule);
+    }
+
+    showDeferredLoadWarnings();
+
+    Falcor::logInfo("Reloaded plugin library '{}'", library.libraryPath.string());
+}
+
+
+auto ModuleRegistry::takeStateSnapshot() const -> ModuleStateSnapshot
+{
+    ModuleStateSnapshot snapshot;
+    snapshot.reserve(mModuleStateSerializers.size());
+
+    for (const auto& [ moduleId, serializer ] : mModuleStateSerializers)
+    {
+        snapshot.emplace_back(moduleId, serializer->snapshotState());
+    }
+
+    return snapshot;
+}
+
+
+size_t ModuleRegistry::saveChangedModuleStates(Internal::SegmentedProjectFile& file) const
+{
+    std::vector<std::pair<ModuleId, uint64_t>> writtenRevisions;
+
+    for (const auto& [ moduleId, serializer ] : mModuleStateSerializers)
+    {
+        const auto revision = serializer->getStateRevision();
+
+        if (file.getWrittenRevision(moduleId) == revision)
+        {
+            continue;
+        }
+
+        std::ostringstream oss(std::ios::out | std::ios::binary);
+
+        try
+        {
+            if (auto ar = Internal::SerializationManager::get().beginBinarySave(oss))
+            {
+                serializer->saveState(*ar);
+            }
+
+            Internal::SerializationManager::get().finish();
+        }
+        catch (const std::exception& e)
+        {
+            Internal::SerializationManager::get().finish();
+            Falcor::logError("Could not save the state of module '{}', its previously saved state is kept:\n{}", moduleId, e.what());
+            continue;
+        }
+
+        if (!file.writeSegment(moduleId, oss.str()))
+        {
+            Falcor::logError("Could not write the state of module '{}' to '{}'.", moduleId, file.getFilePath().string());
+            continue;
+        }
+
+        writtenRevisions.emplace_back(moduleId, revision);
+    }
+
+    if (writtenRevisions.empty() || !file.commit())
+    {
+        return 0;
+    }
+
+    for (const auto& [ moduleId, revision ] : writtenRevisions)
+    {
+        file.setWrittenRevision(moduleId, revision);
+    }
+
+    return writtenRevisions.size();
+}
+
+
+bool ModuleRegistry::loadModuleStates(Internal::SegmentedProjectFile& file, const ModuleStateFilter& filter) const
+{
+    struct LoadedState
+    {
+        ModuleId moduleId;
+        const Internal::ModuleStateSerializerBase* pSerializer = nullptr;
+        std::string segment;
+        std::shared_ptr<ModuleState> pState;
+        std::string error;
+    };
+
+    auto hadIssues = false;
+    std::vector<LoadedState> loadedStates;
+
+    // The file is read on this thread, only the deserialization of the segments is spread over the workers
+    for (const auto& moduleId : file.getSegmentKeys())
+    {
+        // Segments of unselected modules are not even read
+        if (filter && !filter(moduleId))
+        {
+            continue;
+        }
+
+        const auto itSerializer = mModuleStateSerializers.find(moduleId);
+
+        if (itSerializer == mModuleStateSerializers.end())
+        {
+            hadIssues = true;
+            Falcor::logError("Could not load state for module with ID '{}'. This module is not currently registered or has no "
+                             "serializable state.", moduleId);
+            continue;
+        }
+
+        auto segment = file.readSegment(moduleId);
+
+        if (!segment)
+        {
+            hadIssues = true;
+            Falcor::logError("Could not read the state of module '{}' from '{}'.", moduleId, file.getFilePath().string());
+            continue;
+        }
+
+        loadedStates.push_back({ moduleId, itSerializer->second.get(), std::move(*segment) });
+    }
+
+    runSerializationTasks(loadedStates.size(), [&loadedStates](const size_t i) {
+        auto& loadedState = loadedStates[i];
+        std::istringstream iss(loadedState.segment, std::ios::in | std::ios::binary);
+
+        try
+        {
+            if (auto ar = Internal::SerializationManager::get().beginBinaryLoad(iss))
+            {
+                loadedState.pState = loadedState.pSerializer->readState(*ar);
+            }
+            else
+            {
+                loadedState.error = "The saved state has an invalid format.";
+            }
+        }
+        catch (const std::exception& e)
+        {
+            loadedState.error = e.what();
+        }
+    });
+
+    for (const auto& loadedState : loadedStates)
+    {
+        if (!loadedState.pState)
+        {
+            hadIssues = true;
+            Falcor::logError("Could not load the state of module '{}':\n{}", loadedState.moduleId, loadedState.error);
+            continue;
+        }
+
+        loadedState.pSerializer->setStateBase(loadedState.pState);
+    }
+
+    showDeferredLoadWarnings();
+    return !hadIssues;
+}
+
+
+auto ModuleRegistry::getStateRevisions() const -> ModuleStateRevisions
+{
+    ModuleStateRevisions revisions;
+
+    for (const auto& [ moduleId, serializer ] : mModuleStateSerializers)
+    {
+        revisions.emplace(moduleId, serializer->getStateRevision());
+    }
+
+    return revisions;
+}
+
+
+auto ModuleRegistry::saveModuleState(const ModuleId& moduleId) const -> std::optional<SavedModuleState>
+{
+    const auto itSerializer = mModuleStateSerializers.find(moduleId);
+
+    if (itSerializer == mModuleStateSerializers.end())
+    {
+        return std::nullopt;
+    }
+
+    // Kept in memory only, so nothing may go to the blob store of the project
+    auto& serializationManager = Internal::SerializationManager::get();
+    const auto pBlobs = std::make_shared<Internal::SerializationManager::SharedBlobs>();
+    auto pPreviousSharedBlobs = serializationManager.exchangeSharedBlobs(pBlobs);
+
+    std::ostringstream oss(std::ios::out | std::ios::binary);
+
+    try
+    {
+        if (auto ar = serializationManager.beginBinarySave(oss))
+        {
+            itSerializer->second->saveState(*ar);
+        }
+
+        serializationManager.finish();
+    }
+    catch (const std::exception& e)
+    {
+        serializationManager.exchangeSharedBlobs(std::move(pPreviousSharedBlobs));
+        serializationManager.finish();
+        Falcor::logError("Could not save the state of module '{}':\n{}", moduleId, e.what());
+        return std::nullopt;
+    }
+
+    serializationManager.exchangeSharedBlobs(std::move(pPreviousSharedBlobs));
+    return SavedModuleState{ oss.str(), std::move(*pBlobs) };
+}
+
+
+bool ModuleRegistry::loadModuleState(
+    const ModuleId& moduleId,
+    const std::string& data,
+    const Internal::SerializationManager::SharedBlobs& blobs
+) const
+{
+    const auto itSerializer = mModuleStateSerializers.find(moduleId);
+
+    if (itSerializer == mModuleStateSerializers.end())
+    {
+        return false;
+    }
+
+    auto& serializationManager = Internal::SerializationManager::get();
+    const auto pBlobs = std::make_shared<Internal::SerializationManager::SharedBlobs>(blobs);
+    auto pPreviousSharedBlobs = serializationManager.exchangeSharedBlobs(pBlobs);
+
+    std::istringstream iss(data, std::ios::in | std::ios::binary);
+    auto loaded = false;
+
+    try
+    {
+        if (auto ar = serializationManager.beginBinaryLoad(iss))
+        {
+            itSerializer->second->loadState(*ar);
+            loaded = true;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        Falcor::logError("Could not load the state of module '{}':\n{}", moduleId, e.what());
+    }
+
+    serializationManager.exchangeSharedBlobs(std::move(pPreviousSharedBlobs));
+    serializationManager.finish();
+    showDeferredLoadWarnings();
+    return loaded;
+}
+
+
+void ModuleRegistry::applyModuleStates(const ModuleStateStore& moduleStateStore, const ModuleStateFilter& filter) const
+{
+    auto hadIssues = false;
+
+    for (const auto& serializedState : moduleStateStore)
+    {
+        const auto& [ moduleId, pStateBase ] = serializedState.get();
+
+        if (filter && !filter(moduleId))
+        {
+            continue;
+        }
+
+        if (!serializedState.success())
+        {
+            hadIssues = true;
+            Falcor::logError("Could not load module state for module '{}'. The state for this module was unknown for the serialization "
+                             "framework or the written state was invalid. Semi-compatible project file? Forgot to register module state?",
+                             moduleId);
+            continue;
+        }
+
+        if (!hasModule(moduleId))
+        {
+            hadIssues = true;
+            Falcor::logError("Could not load state for module with ID '{}'. This module is not currently registered.",
+                             moduleId);
+            continue;
+        }
+
+        if (mModuleStateSerializers.find(moduleId) == mModuleStateSerializers.end())
+        {
+            hadIssues = true;
+            Falcor::logError("Could not find serializer for module '{}'. This should not happen. The state will not be loaded for this "
+                               "module!", moduleId);
+        }
+
+        const auto& serializer = mModuleStateSerializers.at(moduleId);
+        serializer->setStateBase(pStateBase);
+    }
+
+    showDeferredLoadWarnings();
+
+    if (hadIssues)
+    {
+        Falcor::logWarning("Some module states were not loaded properly. This may be because a project file was loaded that is not directly "
+                           "compatible with the module set of the current running version of the program, or because you forgot to register "
+                           "some module states with the GRAPHEX_REGISTER_MODULE_STATE macro, or maybe because you forgot to declare that "
+                           "the module has a serializable state by deriving from SerializableModuleState.");
+    }
+}
+
+
+void ModuleRegistry::showDeferredLoadWarnings()
+{
+    const auto warnings = Internal::SerializationManager::takeDeferredWarnings();
+
+    if (warnings.empty())
+    {
+        return;
+    }
+
+    std::ostringstream os;
+
+    for (size_t i = 0; i < warnings.size(); ++i)
+    {
+        os << (i > 0 ? "\n\n" : "") << warnings[i];
+    }
+
+    msgBox("Warning", os.str(), Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Warning);
+}
+
+
+void ModuleRegistry::runSerializationTasks(const size_t taskCount, const std::function<void(size_t)>& task)
+{
+    std::vector<std::exception_ptr> exceptions(taskCount);
+    std::atomic<size_t> nextTask = 0;
+
+    // Workers read the blobs of the project from the same store as the calling thread
+    const auto pBlobStore = Internal::SerializationManager::get().getBlobStore();
+
+    const auto runTasks = [&]()
+    {
+        Internal::SerializationManager::get().setBlobStore(pBlobStore);
+
+        for (auto i = nextTask++; i < taskCount; i = nextTask++)
+        {
+            try
+            {
+                task(i);
+            }
+            catch (...)
+            {
+                exceptions[i] = std::current_exception();
+            }
+
+            // Tracked references and invalidity lists of one task must not leak into the next one on the same thread
+            Internal::SerializationManager::get().finish();
+        }
+    };
+
+    // The calling thread stays out, as it may be in the middle of a serialization scope of its own
+    const auto workerCount = std::min<size_t>(taskCount, std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::future<void>> workers;
+    workers.reserve(workerCount);
+
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        workers.push_back(std::async(std::launch::async, runTasks));
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+
+    for (const auto& exception : exceptions)
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
+
 void ModuleRegistry::cleanup()
 {
     mModules.clear();
     mModuleIdsForContainer.clear();
     mModuleIdForTypeId.clear();
     mModuleStateSerializers.clear();
+    mPluginModules.clear();
+
+    for (auto& [ libraryKey, library ] : mPluginLibraries)
+    {
+        releasePluginLibrary(library);
+    }
+
+    mPluginLibraries.clear();
 }
 
 
@@ -9,6 +9,8 @@ namespace GraphEx
 
 // Forward declare Module as Module.h includes this header file
 struct GRAPHEX_EXPORTABLE Module;
+struct GRAPHEX_EXPORTABLE PluginModule;
+struct GRAPHEX_EXPORTABLE ModuleContainerBase;
 
 
 class GRAPHEX_EXPORTABLE ModuleRegistry final
@@ -24,7 +26,34 @@ class GRAPHEX_EXPORTABLE ModuleRegistry final
     using ModuleStateStore = std::vector<SerializedModuleState>;
     using ModuleStateSerializerDictionary = std::unordered_map<ModuleId, std::unique_ptr<Internal::ModuleStateSerializerBase>>;
 
+    struct PluginLibrary
+    {
+        std::filesystem::path libraryPath;
+        std::filesystem::path loadedLibraryPath;  // Shadow copy, so that the original can be overwritten by the build
+        std::filesystem::file_time_type loadedWriteTime;
+        std::filesystem::file_time_type observedWriteTime;
+        std::chrono::steady_clock::time_point observedAt;
+        uint32_t generation = 0;
+    };
+
+    struct PluginModuleRecord
+    {
+        ModuleContainerId containerId;
+        ModuleContainerBase* pContainer = nullptr;
+        std::string libraryKey;
+        std::string pluginType;
+        std::optional<std::string> carriedState;  // Serialized state waiting to be applied to the module after a failed reload
+    };
+
+    using PluginLibraryDictionary = std::unordered_map<std::string, PluginLibrary>;
+    using PluginModuleDictionary = std::unordered_map<ModuleId, PluginModuleRecord>;
+
 public:
+    using ModuleStateSnapshot = std::vector<std::pair<ModuleId, std::shared_ptr<ModuleState>>>;
+    using StateSavedCallback = std::function<void(size_t savedStateCount)>;
+    using ModuleStateFilter = std::function<bool(const ModuleId& moduleId)>;  // Selects the modules whose state is loaded
+    using ModuleStateRevisions = std::unordered_map<ModuleId, uint64_t>;
+
     MAKE_MOVE_ONLY(ModuleRegistry)
     DEFAULT_MOVE_SEMANTICS(ModuleRegistry)
 
@@ -35,11 +64,53 @@ public:
     std::optional<std::reference_wrapper<const ModuleIds>> getModuleIdsForContainer(const ModuleContainerId& containerId) const;
     std::optional<ModuleId> getModuleIdForTypeId(const TypeId& typeId) const;
 
+    ModulePtr<PluginModule> registerPluginModuleForContainer(
+        const ModuleContainerId& containerId,
+        ModuleContainerBase* pContainer,
+        const std::filesystem::path& libraryPath,
+        const std::string& pluginType
+    );
+
+    // Swaps plugin modules whose library was rebuilt since it was loaded. Call this at a frame boundary only!
+    void reloadChangedPluginModules(Falcor::RenderContext* pRenderContext);
+
+    template<typename ModuleT>
+    static std::unique_ptr<Internal::ModuleStateSerializerBase> createStateSerializer(const ModulePtr<ModuleT>& pModule);
+
     template<typename Archive>
     void saveModuleStates(Archive& ar) const;
 
+    // Copies of every module state, to be saved later on any thread while the modules go on. Call this at a frame boundary only!
+    ModuleStateSnapshot takeStateSnapshot() const;
+
+    // Does not touch the modules, so it is safe to call on a worker thread
+    template<typename Archive>
+    static void saveModuleStateSnapshot(Archive& ar, const ModuleStateSnapshot& snapshot, const StateSavedCallback& onStateSaved = nullptr);
+
+    // States are deserialized concurrently where the archive allows reading them independently, then set in their saved order.
+    // With a filter, only the selected states are set. The others are not even deserialized where the archive allows skipping them
     template<typename Archive>
-    void loadModuleStates(Archive& ar) const;
+    void loadModuleStates(Archive& ar, const ModuleStateFilter& filter = nullptr) const;
+
+    // Only (re)writes the states whose revision changed since they were last written to the file, each into its own segment.
+    // Returns the number of states written
+    size_t saveChangedModuleStates(Internal::SegmentedProjectFile& file) const;
+    bool loadModuleStates(Internal::SegmentedProjectFile& file, const ModuleStateFilter& filter = nullptr) const;
+
+    // The revision of every serializable module state, to tell which ones changed since they were last looked at
+    ModuleStateRevisions getStateRevisions() const;
+
+    // A single module state in the binary format, to be kept in memory. Its blobs are shared with the module instead of being written
+    // to the blob store, and are handed back for loading
+    struct SavedModuleState
+    {
+        std::string data;
+        Internal::SerializationManager::SharedBlobs blobs;
+    };
+
+    // Nothing is returned if the module has no serializable state or it could not be saved
+    std::optional<SavedModuleState> saveModuleState(const ModuleId& moduleId) const;
+    bool loadModuleState(const ModuleId& moduleId, const std::string& data, const Internal::SerializationManager::SharedBlobs& blobs) const;
 
     void cleanup();
 
@@ -59,13 +130,30 @@ private:
     bool hasModule(const ModuleId& moduleId) const;
     ModulePtr<Module> getModule(const ModuleId& moduleId) const;
 
+    void applyModuleStates(const ModuleStateStore& moduleStateStore, const ModuleStateFilter& filter) const;
+    // Shows the warnings deferred while loading and applying states, which may have been loaded on worker threads. Main thread only
+    static void showDeferredLoadWarnings();
+
+    // Runs the task for every index on a pool of worker threads, and returns once all of them finished. Each task gets its own
+    // serialization scope. The first exception thrown, in the order of the indices, is rethrown
+    static void runSerializationTasks(size_t taskCount, const std::function<void(size_t)>& task);
+
     ModuleIds& getModuleIdsForContainerMutable(const ModuleContainerId& containerId);
 
+    void loadPluginLibrary(PluginLibrary& library);
+    void releasePluginLibrary(PluginLibrary& library);
+    bool hasPluginLibraryChanged(PluginLibrary& library) const;
+    void reloadPluginLibrary(const std::string& libraryKey, PluginLibrary& library, Falcor::RenderContext* pRenderContext);
+    ModulePtr<PluginModule> instantiatePluginModule(const ModuleId& moduleId, PluginModuleRecord& record);
+
     ModuleDictionary mModules;
     ModuleContainerDictionary mModuleIdsForContainer;
     ModuleTypeDictionary mModuleIdForTypeId;
 
     ModuleStateSerializerDictionary mModuleStateSerializers;
+
+    PluginLibraryDictionary mPluginLibraries;
+    PluginModuleDictionary mPluginModules;
 };
 
 
@@ -78,19 +166,51 @@ auto ModuleRegistry::registerModuleForContainer(const ModuleContainerId& contain
 }
 
 
+template<typename ModuleT>
+std::unique_ptr<Internal::ModuleStateSerializerBase> ModuleRegistry::createStateSerializer(const ModulePtr<ModuleT>& pModule)
+{
+    if constexpr (Internal::IsModuleSerializable<ModuleT>)
+    {
+        return std::make_unique<Internal::ModuleStateSerializer<ModuleT, typename ModuleT::StateType>>(pModule);
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+
 template<typename Archive>
 void ModuleRegistry::saveModuleStates(Archive& ar) const
 {
-    ModuleStateStore moduleStateStore;
+    // The live states are saved in place, without copying them
+    ModuleStateSnapshot moduleStates;
+    moduleStates.reserve(mModuleStateSerializers.size());
 
     for (const auto& [ moduleId, serializer ] : mModuleStateSerializers)
     {
-        moduleStateStore.emplace_back(moduleId, serializer->getStateBase());
+        moduleStates.emplace_back(moduleId, serializer->getStateBase());
+    }
+
+    saveModuleStateSnapshot(ar, moduleStates);
+}
+
+
+template<typename Archive>
+void ModuleRegistry::saveModuleStateSnapshot(Archive& ar, const ModuleStateSnapshot& snapshot, const StateSavedCallback& onStateSaved)
+{
+    ModuleStateStore moduleStateStore;
+    moduleStateStore.reserve(snapshot.size());
+
+    for (const auto& [ moduleId, pState ] : snapshot)
+    {
+        moduleStateStore.emplace_back(moduleId, pState);
     }
 
     try
     {
-        ar(SaveNamed("moduleStates", moduleStateStore));
+        auto moduleStates = Internal::ProgressReportingSequence<ModuleStateStore>{ moduleStateStore, onStateSaved };
+        ar(SerializeNamed<Archive>("moduleStates", moduleStates));
     }
     catch (...)
     {
@@ -113,61 +233,55 @@ void ModuleRegistry::saveModuleStates(Archive& ar) const
 
 
 template<typename Archive>
-void ModuleRegistry::loadModuleStates(Archive& ar) const
+void ModuleRegistry::loadModuleStates(Archive& ar, const ModuleStateFilter& filter) const
 {
-    auto hadIssues = false;
-
     ModuleStateStore moduleStateStore;
 
     try
     {
-        ar(LoadNamed("moduleStates", moduleStateStore));
-    }
-    catch (...)
-    {
-        Falcor::logError("Failed to load module states from project file. Check surrounding logs.");
-        throw;
-    }
+        auto loaded = false;
 
-    for (const auto& serializedState : moduleStateStore)
-    {
-        const auto& [ moduleId, pStateBase ] = serializedState.get();
-
-        if (!serializedState.success())
-        {
-            hadIssues = true;
-            Falcor::logError("Could not load module state for module '{}'. The state for this module was unknown for the serialization "
-                             "framework or the written state was invalid. Semi-compatible project file? Forgot to register module state?",
-                             moduleId);
-            continue;
-        }
-
-        if (!hasModule(moduleId))
+        // The elements of the parsed document can be read independently, while a binary stream must be read from start to end
+        if constexpr (std::is_same_v<Archive, InputArchive>)
         {
-            hadIssues = true;
-            Falcor::logError("Could not load state for module with ID '{}'. This module is not currently registered.",
-                             moduleId);
-            continue;
+            if (auto elementArchives = ar.splitArray("moduleStates"))
+            {
+                moduleStateStore.resize(elementArchives->size());
+
+                runSerializationTasks(moduleStateStore.size(), [&](const size_t i) {
+                    auto& elementArchive = *(*elementArchives)[i];
+
+                    if (!filter)
+                    {
+                        elementArchive(moduleStateStore[i]);
+                        return;
+                    }
+
+                    // The state of an unselected module is left unparsed, only its tag is read
+                    elementArchive.startNode();
+                    moduleStateStore[i].loadIf(elementArchive, filter);
+                    elementArchive.finishNode();
+                });
+
+                loaded = true;
+            }
         }
 
-        if (mModuleStateSerializers.find(moduleId) == mModuleStateSerializers.end())
+        // Read from start to end, as a skipped state may hold the first occurrence of a polymorphic type or a shared pointer
+        if (!loaded)
         {
-            hadIssues = true;
-            Falcor::logError("Could not find serializer for module '{}'. This should not happen. The state will not be loaded for this "
-                               "module!", moduleId);
+            ar(SerializeNamed<Archive>("moduleStates", moduleStateStore));
         }
-
-        const auto& serializer = mModuleStateSerializers.at(moduleId);
-        serializer->setStateBase(pStateBase);
     }
-
-    if (hadIssues)
+    catch (...)
     {
-        Falcor::logWarning("Some module states were not loaded properly. This may be because a project file was loaded that is not directly "
-                           "compatible with the module set of the current running version of the program, or because you forgot to register "
-                           "some module states with the GRAPHEX_REGISTER_MODULE_STATE macro, or maybe because you forgot to declare that "
-                           "the module has a serializable state by deriving from SerializableModuleState.");
+        Falcor::logError("Failed to load module states from project file. Check surrounding logs.");
+        // Nothing was applied, the load fails as a whole
+        Internal::SerializationManager::takeDeferredWarnings();
+        throw;
     }
+
+    applyModuleStates(moduleStateStore, filter);
 }
 
 
@@ -206,10 +320,7 @@ auto ModuleRegistry::registerModule(std::true_type, Args&&... args) -> std::tupl
     const auto& [ moduleId, pModule ] = result;
 
     // Additionally, register serialization mechanism
-    mModuleStateSerializers.emplace(
-        moduleId,
-        std::make_unique<Internal::ModuleStateSerializer<ModuleT, typename ModuleT::StateType>>(pModule)
-    );
+    mModuleStateSerializers.emplace(moduleId, createStateSerializer<ModuleT>(pModule));
 
     return result;
 }
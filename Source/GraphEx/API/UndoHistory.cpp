@@ -0,0 +1,456 @@
+#include "UndoHistory.h"
+
+
+using namespace GraphEx;
+
+
+namespace
+{
+
+// Random values for the gear hash that finds the chunk boundaries, generated with splitmix64
+constexpr auto GEAR_TABLE = [] {
+    std::array<uint64_t, 256> table{ };
+    uint64_t state = 0;
+
+    for (auto& value : table)
+    {
+        state += 0x9E3779B97F4A7C15ull;
+        auto z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        value = z ^ (z >> 31);
+    }
+
+    return table;
+}();
+
+} // namespace
+
+
+UndoHistory::~UndoHistory()
+{
+    if (mPendingRecord.valid())
+    {
+        mPendingRecord.wait();
+    }
+}
+
+
+void UndoHistory::update()
+{
+    // The changes since are looked at once the previous step is stored
+    if (isRecordPending())
+    {
+        return;
+    }
+
+    const auto revisions = ModuleRegistry::get().getStateRevisions();
+    const auto now = std::chrono::steady_clock::now();
+
+    // The first step is the state everything can be undone to, it is recorded right away
+    if (mSteps.empty())
+    {
+        record(revisions);
+        mObservedRevisions = revisions;
+        mLastChangeTime = now;
+        return;
+    }
+
+    if (revisions != mObservedRevisions)
+    {
+        mObservedRevisions = revisions;
+        mLastChangeTime = now;
+        return;
+    }
+
+    if (revisions != mRecordedRevisions && now - mLastChangeTime >= SETTLE_TIME)
+    {
+        record(revisions);
+    }
+}
+
+
+void UndoHistory::reset()
+{
+    finishPendingRecord();
+
+    mSteps.clear();
+    mCurrentStep = 0;
+    mChunks.clear();
+    mBlobReferenceCounts.clear();
+    mMemoryUsage = 0;
+    mRecordedRevisions.clear();
+    mObservedRevisions.clear();
+}
+
+
+bool UndoHistory::canUndo() const
+{
+    if (isRecordPending())
+    {
+        return mPendingRecordUndoable;
+    }
+
+    return !mSteps.empty() && mCurrentStep > 0;
+}
+
+
+bool UndoHistory::canRedo() const
+{
+    // A new step replaces the steps that were undone
+    if (isRecordPending())
+    {
+        return false;
+    }
+
+    return mCurrentStep + 1 < mSteps.size();
+}
+
+
+bool UndoHistory::undo()
+{
+    finishPendingRecord();
+
+    if (mSteps.empty())
+    {
+        return false;
+    }
+
+    // Changes that have not settled yet make a step of their own, so that they can be redone
+    if (const auto revisions = ModuleRegistry::get().getStateRevisions(); revisions != mRecordedRevisions)
+    {
+        record(revisions);
+        finishPendingRecord();
+    }
+
+    return canUndo() && moveTo(mCurrentStep - 1);
+}
+
+
+bool UndoHistory::redo()
+{
+    finishPendingRecord();
+    return canRedo() && moveTo(mCurrentStep + 1);
+}
+
+
+size_t UndoHistory::getStepCount() const
+{
+    finishPendingRecord();
+    return mSteps.size();
+}
+
+
+size_t UndoHistory::getMemoryUsage() const
+{
+    finishPendingRecord();
+    return mMemoryUsage;
+}
+
+
+size_t UndoHistory::getMemoryBudget() const
+{
+    return mMemoryBudget;
+}
+
+
+void UndoHistory::setMemoryBudget(const size_t memoryBudget)
+{
+    finishPendingRecord();
+    mMemoryBudget = memoryBudget;
+}
+
+
+void UndoHistory::record(const ModuleRegistry::ModuleStateRevisions& revisions)
+{
+    finishPendingRecord();
+
+    // Only the changed states are saved here, they are compared with the current step and stored on a worker
+    const auto* pCurrentStep = mSteps.empty() ? nullptr : &mSteps[mCurrentStep];
+    SavedStates savedStates;
+
+    for (const auto& [ moduleId, revision ] : revisions)
+    {
+        const auto itRecorded = mRecordedRevisions.find(moduleId);
+        const auto isRecorded = pCurrentStep && pCurrentStep->find(moduleId) != pCurrentStep->end();
+
+        if (itRecorded != mRecordedRevisions.end() && itRecorded->second == revision && isRecorded)
+        {
+            continue;
+        }
+
+        if (auto savedState = ModuleRegistry::get().saveModuleState(moduleId))
+        {
+            savedStates.emplace_back(moduleId, std::move(*savedState));
+        }
+    }
+
+    mRecordedRevisions = revisions;
+
+    if (savedStates.empty() && pCurrentStep)
+    {
+        return;
+    }
+
+    mPendingRecordUndoable = pCurrentStep != nullptr;
+    mPendingRecord = std::async(std::launch::async, [this, savedStates = std::move(savedStates)]() mutable {
+        storeStep(std::move(savedStates));
+    });
+}
+
+
+void UndoHistory::storeStep(SavedStates savedStates)
+{
+    // Starts out sharing every state with the current step
+    auto step = mSteps.empty() ? Step{ } : mSteps[mCurrentStep];
+    auto changed = mSteps.empty();
+
+    for (auto& [ moduleId, savedState ] : savedStates)
+    {
+        const auto itState = step.find(moduleId);
+        auto pState = storeState(std::move(savedState));
+
+        // Marked dirty without an actual change
+        if (itState != step.end() && isSameState(*itState->second, *pState))
+        {
+            releaseState(pState);
+            continue;
+        }
+
+        step[moduleId] = std::move(pState);
+        changed = true;
+    }
+
+    if (!changed)
+    {
+        return;
+    }
+
+    // A new step replaces the steps that were undone
+    while (mSteps.size() > mCurrentStep + 1)
+    {
+        releaseStep(mSteps.back());
+        mSteps.pop_back();
+    }
+
+    mSteps.push_back(std::move(step));
+    mCurrentStep = mSteps.size() - 1;
+
+    evictSteps();
+}
+
+
+bool UndoHistory::isRecordPending() const
+{
+    if (mPendingRecord.valid() && mPendingRecord.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        mPendingRecord.get();
+    }
+
+    return mPendingRecord.valid();
+}
+
+
+void UndoHistory::finishPendingRecord() const
+{
+    if (mPendingRecord.valid())
+    {
+        mPendingRecord.get();
+    }
+}
+
+
+bool UndoHistory::moveTo(const size_t stepIndex)
+{
+    finishPendingRecord();
+
+    const auto& currentStep = mSteps[mCurrentStep];
+    auto success = true;
+
+    // Only the states that differ between the two steps are set, the modules of the others are left alone
+    for (const auto& [ moduleId, pState ] : mSteps[stepIndex])
+    {
+        const auto itCurrent = currentStep.find(moduleId);
+
+        if (itCurrent != currentStep.end() && (itCurrent->second == pState || isSameState(*itCurrent->second, *pState)))
+        {
+            continue;
+        }
+
+        if (!ModuleRegistry::get().loadModuleState(moduleId, assembleChunks(pState->chunkList), pState->blobs))
+        {
+            Falcor::logWarning("Could not restore the state of module '{}' from the undo history.", moduleId);
+            success = false;
+        }
+    }
+
+    mCurrentStep = stepIndex;
+
+    // Setting the states changed their revisions, which must not be taken for a new edit
+    mRecordedRevisions = ModuleRegistry::get().getStateRevisions();
+    mObservedRevisions = mRecordedRevisions;
+    mLastChangeTime = std::chrono::steady_clock::now();
+
+    return success;
+}
+
+
+auto UndoHistory::storeState(ModuleRegistry::SavedModuleState savedState) -> std::shared_ptr<const StoredState>
+{
+    auto pState = std::make_shared<StoredState>();
+    auto data = std::string_view(savedState.data);
+
+    while (!data.empty())
+    {
+        const auto chunkSize = findChunkEnd(data);
+        pState->chunkList.push_back(storeChunk(data.substr(0, chunkSize)));
+        data.remove_prefix(chunkSize);
+    }
+
+    mMemoryUsage += pState->chunkList.size() * sizeof(ChunkId);
+
+    // The blobs are kept alive by the history, even once the modules let go of them
+    for (const auto& blob : savedState.blobs)
+    {
+        if (mBlobReferenceCounts[blob.getData()]++ == 0)
+        {
+            mMemoryUsage += blob.getSize();
+        }
+    }
+
+    pState->blobs = std::move(savedState.blobs);
+    return pState;
+}
+
+
+std::string UndoHistory::assembleChunks(const ChunkList& chunkList) const
+{
+    size_t size = 0;
+
+    for (const auto chunkId : chunkList)
+    {
+        size += mChunks.at(chunkId).bytes.size();
+    }
+
+    std::string result;
+    result.reserve(size);
+
+    for (const auto chunkId : chunkList)
+    {
+        result += mChunks.at(chunkId).bytes;
+    }
+
+    return result;
+}
+
+
+auto UndoHistory::storeChunk(const std::string_view bytes) -> ChunkId
+{
+    // Chunks are identified by the hash of their content, colliding ones take the next free id
+    auto chunkId = static_cast<ChunkId>(std::hash<std::string_view>{ }(bytes));
+
+    for (auto it = mChunks.find(chunkId); it != mChunks.end(); it = mChunks.find(++chunkId))
+    {
+        if (it->second.bytes == bytes)
+        {
+            ++it->second.referenceCount;
+            return chunkId;
+        }
+    }
+
+    mChunks.emplace(chunkId, Chunk{ std::string(bytes), 1 });
+    mMemoryUsage += bytes.size();
+
+    return chunkId;
+}
+
+
+void UndoHistory::releaseState(const std::shared_ptr<const StoredState>& pState)
+{
+    // States shared with other steps are released along with the last of them
+    if (pState.use_count() > 1)
+    {
+        return;
+    }
+
+    for (const auto chunkId : pState->chunkList)
+    {
+        const auto itChunk = mChunks.find(chunkId);
+
+        if (--itChunk->second.referenceCount == 0)
+        {
+            mMemoryUsage -= itChunk->second.bytes.size();
+            mChunks.erase(itChunk);
+        }
+    }
+
+    mMemoryUsage -= pState->chunkList.size() * sizeof(ChunkId);
+
+    for (const auto& blob : pState->blobs)
+    {
+        const auto itBlob = mBlobReferenceCounts.find(blob.getData());
+
+        if (--itBlob->second == 0)
+        {
+            mMemoryUsage -= blob.getSize();
+            mBlobReferenceCounts.erase(itBlob);
+        }
+    }
+}
+
+
+void UndoHistory::releaseStep(const Step& step)
+{
+    for (const auto& [ moduleId, pState ] : step)
+    {
+        releaseState(pState);
+    }
+}
+
+
+void UndoHistory::evictSteps()
+{
+    // The current step is always kept, even if it alone exceeds the budget
+    while (mMemoryUsage > mMemoryBudget && mCurrentStep > 0)
+    {
+        releaseStep(mSteps.front());
+        mSteps.pop_front();
+        --mCurrentStep;
+    }
+}
+
+
+size_t UndoHistory::findChunkEnd(const std::string_view data)
+{
+    if (data.size() <= MIN_CHUNK_SIZE)
+    {
+        return data.size();
+    }
+
+    // The boundaries depend on the content only, so the chunks after an insertion or removal are the same as before it
+    const auto end = std::min(data.size(), MAX_CHUNK_SIZE);
+    uint64_t hash = 0;
+
+    for (size_t i = MIN_CHUNK_SIZE; i < end; ++i)
+    {
+        hash = (hash << 1) + GEAR_TABLE[static_cast<uint8_t>(data[i])];
+
+        if ((hash >> (64 - CHUNK_BOUNDARY_BITS)) == 0)
+        {
+            return i + 1;
+        }
+    }
+
+    return end;
+}
+
+
+bool UndoHistory::isSameState(const StoredState& a, const StoredState& b)
+{
+    // Blobs are immutable, the same content is the same memory
+    const auto isSameBlob = [](const BlobData& blobA, const BlobData& blobB) {
+        return blobA.getData() == blobB.getData() && blobA.getSize() == blobB.getSize();
+    };
+
+    return a.chunkList == b.chunkList && std::equal(a.blobs.begin(), a.blobs.end(), b.blobs.begin(), b.blobs.end(), isSameBlob);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "ModuleRegistry.h"
+#include "../Utils/Standard.h"
+
+
+namespace GraphEx
+{
+
+// Undo and redo of the module states. A step is recorded once the states settled after a change, so that a continuous edit (e.g.
+// dragging a slider) makes a single step. The states are kept in the binary format, split into content-defined chunks that are stored
+// only once, however many steps they occur in. A step thus costs only the chunks around what changed since the previous one, e.g.
+// moving a scene object adds a chunk or two, and the rest of the scene is shared with the previous steps. Blobs are kept in memory,
+// shared with the modules, and never written to the sidecar of the project. Once the history outgrows its memory budget, the oldest
+// steps are dropped. The changed states are saved on the main thread, splitting them into chunks and storing those is done on a worker
+class GRAPHEX_EXPORTABLE UndoHistory final
+{
+public:
+    static constexpr auto SETTLE_TIME = std::chrono::milliseconds(500);
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+    static constexpr size_t MIN_CHUNK_SIZE = 512;
+    static constexpr size_t MAX_CHUNK_SIZE = 16 * 1024;
+    static constexpr uint32_t CHUNK_BOUNDARY_BITS = 12;  // Chunks of about 4 KiB on average
+
+    UndoHistory() = default;
+    ~UndoHistory();
+
+    MAKE_MOVE_ONLY(UndoHistory)
+
+    // Records a step if the states changed and have settled since. Call this at a frame boundary only!
+    void update();
+
+    // Forgets every step, the next update starts over from the states as they are then (e.g. after a project was loaded)
+    void reset();
+
+    // These do not wait for a step still being stored, e.g. to show the menu
+    bool canUndo() const;
+    bool canRedo() const;
+
+    // Sets the states of the previous or next step on the modules. Call these at a frame boundary only!
+    bool undo();
+    bool redo();
+
+    size_t getStepCount() const;
+    size_t getMemoryUsage() const;
+
+    size_t getMemoryBudget() const;
+    void setMemoryBudget(size_t memoryBudget);
+
+private:
+    using ChunkId = uint64_t;
+    using ChunkList = std::vector<ChunkId>;
+
+    struct Chunk
+    {
+        std::string bytes;
+        size_t referenceCount = 0;  // Number of chunk lists it occurs in, counting repeated occurrences
+    };
+
+    struct StoredState
+    {
+        ChunkList chunkList;
+        Internal::SerializationManager::SharedBlobs blobs;
+    };
+
+    // Unchanged states are shared with the previous step
+    using Step = std::unordered_map<ModuleId, std::shared_ptr<const StoredState>>;
+    using SavedStates = std::vector<std::pair<ModuleId, ModuleRegistry::SavedModuleState>>;
+
+    void record(const ModuleRegistry::ModuleStateRevisions& revisions);
+    void storeStep(SavedStates savedStates);
+    bool isRecordPending() const;
+    void finishPendingRecord() const;
+    bool moveTo(size_t stepIndex);
+
+    std::shared_ptr<const StoredState> storeState(ModuleRegistry::SavedModuleState savedState);
+    std::string assembleChunks(const ChunkList& chunkList) const;
+    ChunkId storeChunk(std::string_view bytes);
+    void releaseState(const std::shared_ptr<const StoredState>& pState);
+    void releaseStep(const Step& step);
+    void evictSteps();
+
+    static size_t findChunkEnd(std::string_view data);
+    static bool isSameState(const StoredState& a, const StoredState& b);
+
+    std::deque<Step> mSteps;
+    size_t mCurrentStep = 0;
+
+    std::unordered_map<ChunkId, Chunk> mChunks;
+    std::unordered_map<const uint8_t*, size_t> mBlobReferenceCounts;  // Shared blobs count toward the memory usage once
+    size_t mMemoryUsage = 0;
+    size_t mMemoryBudget = DEFAULT_MEMORY_BUDGET;
+
+    ModuleRegistry::ModuleStateRevisions mRecordedRevisions;  // Of the states as they are in the current step
+    ModuleRegistry::ModuleStateRevisions mObservedRevisions;
+    std::chrono::steady_clock::time_point mLastChangeTime;
+
+    // The step being stored owns everything above but the revisions until it is finished
+    mutable std::future<void> mPendingRecord;
+    bool mPendingRecordUndoable = false;
+};
+
+} // namespace GraphEx
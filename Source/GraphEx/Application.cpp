@@ -34,6 +34,11 @@
 #include "Core/SceneManager.h"
 #include "Core/RenderManager.h"
 
+#include "Utils/CompressedStream.h"
+#include "Utils/ProgramWrapper.h"
+#include "Utils/ProjectFileStream.h"
+#include "Utils/ShaderCache.h"
+
 
 using namespace GraphEx;
 
@@ -83,104 +88,395 @@ void Application::saveProjectAs(const std::filesystem::path& filePath)
         return;
     }
 
-    std::ostringstream oss;
+    if (mBackgroundSave)
+    {
+        msgBox("Error", "Another save is still in progress. Try again once it has finished.", Falcor::MsgBoxType::Ok,
+               Falcor::MsgBoxIcon::Error);
+        return;
+    }
+
+    // Large data is shared with the sidecar of the current project when saving in place. New data is only written into it by the save
+    // task, along with the project file referring to it
+    auto pBlobStore = filePath == mProjectFilePath && mpBlobStore
+        ? mpBlobStore
+        : std::make_shared<Internal::BlobStore>(Internal::BlobStore::getSidecarPath(filePath));
+
+    // Taken between two frames, so that it is consistent. Everything after it runs on a worker thread while rendering goes on. The
+    // snapshot shares the large data with the modules rather than copying it
+    ModuleRegistry::ModuleStateSnapshot snapshot;
 
-    if (auto ar = Internal::SerializationManager::get().beginSave(oss))
+    try
+    {
+        snapshot = ModuleRegistry::get().takeStateSnapshot();
+    }
+    catch (const std::exception& e)
     {
-        auto error = false;
+        Internal::SerializationManager::get().finish();
+        Falcor::logError("Failed to take a snapshot of the program state. See details below:\n{}", e.what());
+        msgBox("Error", "Failed to save project file: an error was encountered while copying the program's state. Check the logs for "
+               "more details.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+        return;
+    }
 
-        try
-        {
-            ModuleRegistry::get().saveModuleStates(*ar);
-        }
-        catch (const std::exception& e)
-        {
-            Falcor::logError("Failed to save program state. See details below:\n{}", e.what());
-            msgBox("Error", "Failed to save project file: an error was encountered while serializing the program's state. Check the logs "
-                   "for more details.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
-            error = true;
-        }
-        catch (...)
+    auto pSavedStateCount = std::make_shared<std::atomic<size_t>>(0);
+    const auto stateCount = snapshot.size();
+
+    auto result = std::async(std::launch::async,
+        [filePath, snapshot = std::move(snapshot), pBlobStore, compress = mCompressProjectFiles, pSavedStateCount]()
         {
-            msgBox("Error", "Failed to save project file: an error was encountered while serializing the program's state.",
-                   Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
-            error = true;
-        }
+            auto result = writeProjectFile(filePath, snapshot, pBlobStore, compress, *pSavedStateCount);
 
-        Internal::SerializationManager::get().finish();
+            if (!result.success)
+            {
+                pBlobStore->discardUnflushedFile();
+            }
+
+            return result;
+        });
+
+    mBackgroundSave = BackgroundSave{ filePath, std::move(result), std::move(pSavedStateCount), stateCount, std::move(pBlobStore) };
+}
+
+
+std::optional<float> Application::getSaveProgress() const
+{
+    if (!mBackgroundSave)
+    {
+        return std::nullopt;
+    }
+
+    return mBackgroundSave->stateCount > 0
+        ? static_cast<float>(mBackgroundSave->pSavedStateCount->load()) / static_cast<float>(mBackgroundSave->stateCount)
+        : 1.0f;
+}
+
+
+void Application::finishBackgroundSave(const bool wait)
+{
+    if (!mBackgroundSave)
+    {
+        return;
+    }
+
+    if (!wait && mBackgroundSave->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return;
+    }
+
+    const auto result = mBackgroundSave->result.get();
+    const auto filePath = mBackgroundSave->filePath;
+    auto pBlobStore = std::move(mBackgroundSave->pBlobStore);
+    mBackgroundSave.reset();
+
+    if (!result.success)
+    {
+        msgBox("Error", result.errorMessage, Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+        return;
+    }
+
+    mProjectFilePath = filePath;
+    mpBlobStore = std::move(pBlobStore);
+    Internal::SerializationManager::get().setBlobStore(mpBlobStore);
+}
 
-        if (error)
+
+auto Application::writeProjectFile(
+    const std::filesystem::path& filePath,
+    const ModuleRegistry::ModuleStateSnapshot& snapshot,
+    const std::shared_ptr<Internal::BlobStore>& pBlobStore,
+    const bool compress,
+    std::atomic<size_t>& savedStateCount
+) -> SaveResult
+{
+    Internal::SerializationManager::get().setBlobStore(pBlobStore);
+
+    // The archive streams straight into the file, which only replaces the previous project once it was written completely
+    ProjectFileWriter writer(filePath);
+
+    if (!writer.isOpen())
+    {
+        return { false, "Failed to save project file: could not write to given path. Perhaps you lack permissions to write for the "
+                        "given path." };
+    }
+
+    // Compressed one buffer at a time on its way into the file, so it is never held in memory as a whole either
+    std::optional<CompressedStreamWriter> compressor;
+
+    if (compress)
+    {
+        compressor.emplace(writer.getStream());
+
+        if (!compressor->isOpen())
         {
-            return;
+            return { false, "Failed to save project file: could not initialize compression." };
         }
     }
-    else
+
+    auto& os = compressor ? compressor->getStream() : static_cast<std::ostream&>(writer.getStream());
+
+    auto result = Internal::SerializationManager::getProjectFormat(filePath) == Internal::ProjectFormat::Binary
+        ? writeProjectArchive(Internal::SerializationManager::get().beginBinarySave(os), snapshot, savedStateCount)
+        : writeProjectArchive(Internal::SerializationManager::get().beginSave(os), snapshot, savedStateCount);
+
+    if (!result.success)
+    {
+        return result;
+    }
+
+    if (compressor && !compressor->finish())
+    {
+        return { false, "Failed to save project file: could not compress the project data." };
+    }
+
+    // The project must never refer to data that did not make it into the sidecar
+    if (!pBlobStore->flush())
+    {
+        return { false, "Failed to save project file: could not write the project data file next to it." };
+    }
+
+    if (!writer.commit())
+    {
+        return { false, "Failed to save project file: could not write to file." };
+    }
+
+    return { true, "" };
+}
+
+
+void Application::loadProject(const std::filesystem::path& filePath, const ModuleRegistry::ModuleStateFilter& moduleFilter)
+{
+    // A save still running would otherwise set its target as the project once it finished, over the one loaded here
+    finishBackgroundSave(true);
+
+    // The file is mapped instead of read, JSON projects are parsed right in the mapping and binary ones are read from it without copying
+    ProjectFileReader reader(filePath);
+
+    if (!reader.isOpen())
     {
-        msgBox("Error", "Failed to save project file: failed to open a JSON output stream. This should not happen and is likely a bug. "
-               "Check the logs for more details.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+        msgBox("Error", "Failed to open the provided project file.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
         return;
     }
 
-    std::ofstream os(filePath, std::ios::out | std::ios::trunc);
+    // Compressed projects are decompressed while they are read, whatever format they contain
+    std::optional<CompressedStreamReader> decompressor;
 
-    if (!os.is_open())
+    if (CompressedStreamReader::isCompressed(reader.getStream()))
     {
-        msgBox("Error", "Failed to save project file: could not write to given path. Perhaps you lack permissions to write for the "
-               "given path.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+        decompressor.emplace(reader.getStream());
+    }
+
+    auto& is = decompressor ? decompressor->getStream() : reader.getStream();
+
+    // The header decides, so that a renamed project file still loads
+    const auto format = Internal::SerializationManager::detectProjectFormat(is);
+
+    if (format == Internal::ProjectFormat::Segmented && !decompressor)
+    {
+        loadAutosave(filePath, moduleFilter);
         return;
     }
 
-    try
+    auto pBlobStore = std::make_shared<Internal::BlobStore>(Internal::BlobStore::getSidecarPath(filePath));
+    Internal::SerializationManager::get().setBlobStore(pBlobStore);
+
+    // Uncompressed JSON is parsed right in the mapping, decompressed JSON has to be buffered for that
+    const auto loaded = format == Internal::ProjectFormat::Binary
+        ? readProjectArchive(Internal::SerializationManager::get().beginBinaryLoad(is), moduleFilter)
+        : decompressor
+            ? readProjectArchive(Internal::SerializationManager::get().beginLoad(is), moduleFilter)
+            : readProjectArchive(Internal::SerializationManager::get().beginLoad(reader), moduleFilter);
+
+    // The loaded states are what undo starts from
+    if (loaded)
     {
-        os << oss.str();
-        os.close();
-        mProjectFilePath = filePath;
+        mUndoHistory.reset();
     }
-    catch (...)
+
+    if (loaded && moduleFilter)
     {
-        msgBox("Error", "Failed to save project file: could not write to file.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+        // Same as after recovering an autosave, the data loaded from the sidecar stays mapped
+        mProjectFilePath.clear();
+        mpBlobStore.reset();
+    }
+    else if (loaded)
+    {
+        mProjectFilePath = filePath;
+        mpBlobStore = std::move(pBlobStore);
+        mCompressProjectFiles = decompressor.has_value();
     }
+
+    Internal::SerializationManager::get().setBlobStore(mpBlobStore);
 }
 
 
-void Application::loadProject(const std::filesystem::path& filePath)
+void Application::loadAutosave(const std::filesystem::path& filePath, const ModuleRegistry::ModuleStateFilter& moduleFilter)
 {
-    std::ifstream is(filePath, std::ios::in);
+    finishBackgroundSave(true);
+
+    Internal::SegmentedProjectFile file;
 
-    if (!is.is_open())
+    if (!file.open(filePath))
     {
-        msgBox("Error", "Failed to open the provided project file.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+        msgBox("Error", "Could not load autosave file: the file is corrupt or has an invalid format.", Falcor::MsgBoxType::Ok,
+               Falcor::MsgBoxIcon::Error);
         return;
     }
 
-    if (auto ar = Internal::SerializationManager::get().beginLoad(is))
+    // The autosave shares the sidecar of the project it was written for
+    Internal::SerializationManager::get().setBlobStore(
+        std::make_shared<Internal::BlobStore>(Internal::BlobStore::getSidecarPath(filePath)));
+
+    if (!ModuleRegistry::get().loadModuleStates(file, moduleFilter))
     {
-        try
-        {
-            ModuleRegistry::get().loadModuleStates(*ar);
-            mProjectFilePath = filePath;
-        }
-        catch (const std::exception& e)
-        {
-            Falcor::logError("Failed to load program state. See details below:\n{}", e.what());
-            msgBox("Error", "Failed to load project file: the file has fatal semantic errors, may be corrupt or incompatible with the "
-                   "current version of the program. Check the logs for more details.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
-        }
-        catch (...)
+        msgBox("Warning", "Some module states could not be recovered from the autosave file. Check the logs for more details.",
+               Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Warning);
+    }
+
+    // A recovered project is unsaved, so that a save never overwrites the autosave file in another format. The data loaded from the
+    // sidecar stays mapped, and is copied into the sidecar of wherever the project is saved next
+    mProjectFilePath.clear();
+    mpBlobStore.reset();
+    Internal::SerializationManager::get().setBlobStore(nullptr);
+
+    mUndoHistory.reset();
+}
+
+
+void Application::autosaveProject()
+{
+    mLastAutosaveTime = std::chrono::steady_clock::now();
+
+    const auto filePath = getAutosaveFilePath();
+
+    if (!mpAutosaveFile || mpAutosaveFile->getFilePath() != filePath)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(filePath.parent_path(), ec);
+
+        // An autosave left behind by a previous session may be the only copy of unsaved work, so it is kept aside once
+        if (std::filesystem::exists(filePath, ec))
         {
-            msgBox("Error", "Failed to load project file: the file has fatal semantic errors, may be corrupt or incompatible with the "
-                   "current version of the program.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+            const auto previousFilePath = filePath.parent_path()
+                / (filePath.stem().string() + ".previous" + std::string(Internal::SegmentedProjectFile::EXTENSION));
+            std::filesystem::rename(filePath, previousFilePath, ec);
         }
 
-        Internal::SerializationManager::get().finish();
+        mpAutosaveFile = std::make_unique<Internal::SegmentedProjectFile>();
+    }
+
+    if (!mpAutosaveFile->isOpen() && !mpAutosaveFile->create(filePath))
+    {
+        Falcor::logWarning("Could not create autosave file '{}'.", filePath.string());
+        return;
     }
-    else
+
+    const auto writtenCount = ModuleRegistry::get().saveChangedModuleStates(*mpAutosaveFile);
+
+    if (writtenCount > 0)
+    {
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mLastAutosaveTime);
+        Falcor::logDebug("Autosaved {} module state(s) to '{}' in {:.2f} ms.", writtenCount, filePath.string(), elapsed.count());
+    }
+}
+
+
+bool Application::undo()
+{
+    return mUndoHistory.undo();
+}
+
+
+bool Application::redo()
+{
+    return mUndoHistory.redo();
+}
+
+
+std::filesystem::path Application::getAutosaveFilePath() const
+{
+    if (mProjectFilePath.empty())
+    {
+        return std::filesystem::temp_directory_path() / "GraphEx" / ("Untitled" + std::string(Internal::SegmentedProjectFile::EXTENSION));
+    }
+
+    auto result = mProjectFilePath;
+    result.replace_extension(Internal::SegmentedProjectFile::EXTENSION);
+    return result;
+}
+
+
+template<typename Archive>
+auto Application::writeProjectArchive(
+    std::optional<Archive>&& maybeArchive,
+    const ModuleRegistry::ModuleStateSnapshot& snapshot,
+    std::atomic<size_t>& savedStateCount
+) -> SaveResult
+{
+    if (!maybeArchive)
+    {
+        return { false, "Failed to save project file: failed to open an output archive. This should not happen and is likely a bug. "
+                        "Check the logs for more details." };
+    }
+
+    auto result = SaveResult{ true, "" };
+
+    try
+    {
+        ModuleRegistry::saveModuleStateSnapshot(*maybeArchive, snapshot, [&savedStateCount](const size_t savedCount) {
+            savedStateCount = savedCount;
+        });
+    }
+    catch (const std::exception& e)
+    {
+        Falcor::logError("Failed to save program state. See details below:\n{}", e.what());
+        result = { false, "Failed to save project file: an error was encountered while serializing the program's state. Check the "
+                          "logs for more details." };
+    }
+    catch (...)
+    {
+        result = { false, "Failed to save project file: an error was encountered while serializing the program's state." };
+    }
+
+    maybeArchive.reset();  // Text archives complete the document upon destruction
+    Internal::SerializationManager::get().finish();
+
+    return result;
+}
+
+
+template<typename Archive>
+bool Application::readProjectArchive(std::optional<Archive>&& maybeArchive, const ModuleRegistry::ModuleStateFilter& moduleFilter)
+{
+    if (!maybeArchive)
     {
         msgBox("Error", "Could not load project file: the file has JSON syntax errors or has an invalid format.",
                Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+        return false;
     }
 
-    is.close();
+    auto error = false;
+
+    try
+    {
+        ModuleRegistry::get().loadModuleStates(*maybeArchive, moduleFilter);
+    }
+    catch (const std::exception& e)
+    {
+        Falcor::logError("Failed to load program state. See details below:\n{}", e.what());
+        msgBox("Error", "Failed to load project file: the file has fatal semantic errors, may be corrupt or incompatible with the "
+               "current version of the program. Check the logs for more details.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+        error = true;
+    }
+    catch (...)
+    {
+        msgBox("Error", "Failed to load project file: the file has fatal semantic errors, may be corrupt or incompatible with the "
+               "current version of the program.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Error);
+        error = true;
+    }
+
+    Internal::SerializationManager::get().finish();
+
+    return !error;
 }
 
 
@@ -195,10 +491,18 @@ void Application::onLoad(Falcor::RenderContext* pRenderContext)
 
 void Application::onShutdown()
 {
+    finishBackgroundSave(true);
+
     for (const auto& pModule : getAllModules())
     {
         pModule->cleanup();
     }
+
+    // The cache is only trimmed here, so that no process pays for pruning while it compiles
+    if (const auto& shaderCachePath = getDevice()->getDesc().shaderCachePath; !shaderCachePath.empty())
+    {
+        ShaderCache(shaderCachePath).prune(ShaderCache::DEFAULT_MAX_SIZE);
+    }
 }
 
 
@@ -211,6 +515,12 @@ void Application::onResize(uint32_t width, uint32_t height)
 
 void Application::onFrameRender(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo)
 {
+    finishBackgroundSave(false);
+    ModuleRegistry::get().reloadChangedPluginModules(pRenderContext);
+    ProgramWrapper::finishCompilations();
+    BufferReadback::beginFrame();
+    GpuTimeRecorder::beginFrame();
+
     EventManager::get().handleEnqueuedEvents();
     EventManager::get().dispatchEvent<Core::EventFrameWillBegin>();
 
@@ -220,6 +530,15 @@ void Application::onFrameRender(Falcor::RenderContext* pRenderContext, const Fal
     }
 
     EventManager::get().dispatchEvent<Core::EventFrameEnded>();
+    UploadRing::endFrame(pRenderContext);
+
+    mUndoHistory.update();
+
+    // At the end of the frame, once the modules have reacted to the changes made during the previous one
+    if (std::chrono::steady_clock::now() - mLastAutosaveTime >= AUTOSAVE_INTERVAL)
+    {
+        autosaveProject();
+    }
 }
 
 
@@ -232,6 +551,19 @@ void Application::onGuiRender(Falcor::Gui* pGui)
 
 bool Application::onKeyEvent(const Falcor::KeyboardEvent& keyEvent)
 {
+    if (keyEvent.type == Falcor::KeyboardEvent::Type::KeyPressed && keyEvent.hasModifier(Falcor::Input::Modifier::Ctrl))
+    {
+        const auto isUndo = keyEvent.key == Falcor::Input::Key::Z && !keyEvent.hasModifier(Falcor::Input::Modifier::Shift);
+        const auto isRedo = keyEvent.key == Falcor::Input::Key::Y
+            || (keyEvent.key == Falcor::Input::Key::Z && keyEvent.hasModifier(Falcor::Input::Modifier::Shift));
+
+        if (isUndo || isRedo)
+        {
+            isUndo ? undo() : redo();
+            return true;
+        }
+    }
+
     EventManager::get().dispatchEvent<Core::KeyboardEvent>(keyEvent);
     return Core::KeyboardEvent::handled;
 }
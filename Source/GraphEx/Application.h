@@ -32,6 +32,8 @@
 
 // GraphEx includes
 #include "API/Module.h"
+#include "API/ModuleRegistry.h"
+#include "API/UndoHistory.h"
 #include "UI/UI.h"
 
 
@@ -58,16 +60,74 @@ struct GRAPHEX_EXPORTABLE Application : Falcor::SampleApp, ModuleContainer<Modul
     void registerCoreModules();
 
     void saveProject();
+    // Takes a snapshot of the module states and writes it on a worker thread, the application keeps running meanwhile
     void saveProjectAs(const std::filesystem::path& filePath);
-    void loadProject(const std::filesystem::path& filePath);
+    // With a filter, only the states of the selected modules are loaded (e.g. the cameras for a batch run). Such a partial load
+    // leaves the project untitled, so that saving it cannot overwrite the file with the states of the unselected modules missing
+    void loadProject(const std::filesystem::path& filePath, const ModuleRegistry::ModuleStateFilter& moduleFilter = nullptr);
+
+    // In the range [0, 1] while a save is running in the background
+    std::optional<float> getSaveProgress() const;
+
+    // Sets the module states of the previous or next step of the undo history
+    bool undo();
+    bool redo();
+
+    // Writes the module states that changed since the last autosave next to the project, or to a temporary file for unsaved projects
+    void autosaveProject();
+    std::filesystem::path getAutosaveFilePath() const;
 
 private:
+    static constexpr auto AUTOSAVE_INTERVAL = std::chrono::seconds(30);
+
+    struct SaveResult
+    {
+        bool success = false;
+        std::string errorMessage;
+    };
+
+    struct BackgroundSave
+    {
+        std::filesystem::path filePath;
+        std::future<SaveResult> result;
+        std::shared_ptr<std::atomic<size_t>> pSavedStateCount;
+        size_t stateCount = 0;
+        std::shared_ptr<Internal::BlobStore> pBlobStore;
+    };
+
+    static SaveResult writeProjectFile(const std::filesystem::path& filePath, const ModuleRegistry::ModuleStateSnapshot& snapshot,
+                                       const std::shared_ptr<Internal::BlobStore>& pBlobStore, bool compress,
+                                       std::atomic<size_t>& savedStateCount);
+
+    template<typename Archive>
+    static SaveResult writeProjectArchive(std::optional<Archive>&& maybeArchive, const ModuleRegistry::ModuleStateSnapshot& snapshot,
+                                          std::atomic<size_t>& savedStateCount);
+
+    // Applies the outcome of the background save once it completed, or right away after waiting for it
+    void finishBackgroundSave(bool wait);
+
+    template<typename Archive>
+    bool readProjectArchive(std::optional<Archive>&& maybeArchive, const ModuleRegistry::ModuleStateFilter& moduleFilter);
+
+    void loadAutosave(const std::filesystem::path& filePath, const ModuleRegistry::ModuleStateFilter& moduleFilter);
+
     std::filesystem::path mProjectFilePath{ "" };
+    std::shared_ptr<Internal::BlobStore> mpBlobStore;  // Sidecar of the project file, unsaved projects keep their large data inline
+    bool mCompressProjectFiles = false;                 // Follows the project file that was loaded last
     UI mUI;
 
+    std::optional<BackgroundSave> mBackgroundSave;
+
+    UndoHistory mUndoHistory;
+
+    std::unique_ptr<Internal::SegmentedProjectFile> mpAutosaveFile;
+    std::chrono::steady_clock::time_point mLastAutosaveTime = std::chrono::steady_clock::now();
+
 public:
     DEFAULT_CONST_GETREF_DEFINITION(ProjectFilePath, mProjectFilePath)
+    DEFAULT_CONST_GETTER_SETTER_DEFINITION(CompressProjectFiles, mCompressProjectFiles)
     DEFAULT_CONST_GETREF_DEFINITION(UI, mUI)
+    DEFAULT_CONST_GETREF_DEFINITION(UndoHistory, mUndoHistory)
 };
 
 } // namespace GraphEx
@@ -63,7 +63,19 @@ void CameraManager::init(Falcor::RenderContext* pRenderContext)
 void CameraManager::update(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo)
 {
     getActiveCameraController()->update();
-    getActiveCamera()->beginFrame();
+
+    const auto changes = getActiveCamera()->beginFrame();
+
+    if (changes != Falcor::Camera::Changes::None)
+    {
+        bumpProgramVarsVersion();
+    }
+
+    // Jitter changes every frame for some cameras, but it is not part of what we save
+    if ((changes & ~Falcor::Camera::Changes::Jitter) != Falcor::Camera::Changes::None)
+    {
+        markStateDirty();
+    }
 }
 
 
@@ -78,6 +90,9 @@ void CameraManager::renderUI(Falcor::Gui::Widgets& w)
     ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x - ImGui::CalcTextSize(CAMERA_CONTROLLER_DROPDOWN_LABEL).x - itemInnerSpacingH);
     w.dropdown(CAMERA_CONTROLLER_DROPDOWN_LABEL, bCameraControllerDropdownList, bActiveCameraControllerIndex);
 
+    // The camera controller is not part of the state, only what comes after it
+    const auto editTracker = UIHelpers::EditTracker{ };
+
     if (ImGui::TreeNodeEx("Cameras", ImGuiTreeNodeFlags_DefaultOpen))
     {
         auto       shouldRemoveCamera       = false;
@@ -155,6 +170,11 @@ void CameraManager::renderUI(Falcor::Gui::Widgets& w)
         getActiveCamera()->renderUI(w);
         ImGui::TreePop();
     }
+
+    if (editTracker.hasEdits())
+    {
+        markStateDirty();
+    }
 }
 
 
@@ -173,6 +193,13 @@ void CameraManager::setProgramVars(const Falcor::ShaderVar& var) const
 }
 
 
+uint64_t CameraManager::getProgramVarsHash() const
+{
+    const auto pCamera = getActiveCamera();
+    return pCamera ? hashProgramVarData(pCamera->getData()) : 0;
+}
+
+
 void CameraManager::setState(std::shared_ptr<CameraManagerState> pState)
 {
     HasSerializableState::setState(std::move(pState));
@@ -214,6 +241,7 @@ uint32_t CameraManager::addCamera(const Falcor::ref<Falcor::Camera>& pCamera)
 {
     mpState->cameras.push_back(pCamera);
     bCameraButtons.emplace_back();
+    markStateDirty();
 
     const auto result = mpState->cameras.size() - 1;
 
@@ -234,6 +262,8 @@ void CameraManager::switchCamera(const uint32_t index)
     }
 
     mpState->activeCamera = index;
+    markStateDirty();
+    bumpProgramVarsVersion();
 
     mCameraControllers.clear();
     mCameraControllers.emplace_back(std::make_shared<Falcor::FirstPersonCameraController>(mpState->cameras[mpState->activeCamera]));
@@ -250,6 +280,8 @@ void CameraManager::removeCamera(const uint32_t index)
 
     mpState->cameras.erase(mpState->cameras.begin() + index);
     bCameraButtons.pop_back();
+    markStateDirty();
+    bumpProgramVarsVersion();  // The cameras after it moved up, the active index may refer to another camera now
 
     if (mpState->activeCamera >= mpState->cameras.size())
     {
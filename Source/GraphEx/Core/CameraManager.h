@@ -27,7 +27,7 @@ void CameraManagerState::serialize(Archive& ar)
 }
 
 
-struct GRAPHEX_EXPORTABLE CameraManager final : Module, ProgramVarProvider, HasSerializableState<CameraManagerState>
+struct GRAPHEX_EXPORTABLE CameraManager final : Module, VersionedProgramVarProvider, HasSerializableState<CameraManagerState>
 {
     explicit CameraManager(ModuleContainerBase* pContainer);
 
@@ -37,7 +37,10 @@ struct GRAPHEX_EXPORTABLE CameraManager final : Module, ProgramVarProvider, HasS
 
     ModuleId getModuleId() const override;
 
+    // The version is bumped by the changes Falcor reports for the active camera at the beginning of each frame, so changes to it made
+    // later in a frame only take effect in the next one
     void setProgramVars(const Falcor::ShaderVar& var) const override;
+    uint64_t getProgramVarsHash() const override;
 
     void setState(std::shared_ptr<CameraManagerState> pState) override;
 
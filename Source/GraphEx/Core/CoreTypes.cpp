@@ -50,6 +50,9 @@ void Transform::updateWorldMatrices()
     mWorldMatrix = mul(mTranslationMatrix, mul(inverseAnchorTranslation, mul(mRotationMatrix, mul(mScaleMatrix, anchorTranslation))));
     mWorldMatrixInverse = Falcor::math::inverse(mWorldMatrix);
     mWorldMatrixInverseTranspose = Falcor::math::transpose(mWorldMatrixInverse);
+
+    // Every setter ends up here
+    bumpProgramVarsVersion();
 }
 
 
@@ -115,12 +118,19 @@ void Transform::setScale(const Falcor::float3& value)
 
 void Material::renderGui(Falcor::Gui::Widgets& w)
 {
+    auto changed = false;
+
     ImGui::PushItemWidth(200);
-    w.rgbColor("Ambient Color", mAmbientColor);
-    w.rgbColor("Diffuse Color", mDiffuseColor);
-    w.rgbColor("Specular Color", mSpecularColor);
+    changed |= w.rgbColor("Ambient Color", mAmbientColor);
+    changed |= w.rgbColor("Diffuse Color", mDiffuseColor);
+    changed |= w.rgbColor("Specular Color", mSpecularColor);
     ImGui::PopItemWidth();
-    w.var("Shininess", mShininess, 0.0f, 100.0f, 0.001f);
+    changed |= w.var("Shininess", mShininess, 0.0f, 100.0f, 0.001f);
+
+    if (changed)
+    {
+        bumpProgramVarsVersion();
+    }
 }
 
 
@@ -166,6 +176,13 @@ void Transform::setProgramVars(const Falcor::ShaderVar& var) const
 }
 
 
+uint64_t Transform::getProgramVarsHash() const
+{
+    return hashProgramVarData(mAnchorPoint, mTranslationMatrix, mRotationMatrix, mScaleMatrix, mWorldMatrix, mWorldMatrixInverse,
+                              mWorldMatrixInverseTranspose);
+}
+
+
 void Material::setProgramVars(const Falcor::ShaderVar& var) const
 {
     trySetProgramVar(var, "_ambientColor", mAmbientColor);
@@ -175,6 +192,12 @@ void Material::setProgramVars(const Falcor::ShaderVar& var) const
 }
 
 
+uint64_t Material::getProgramVarsHash() const
+{
+    return hashProgramVarData(mAmbientColor, mDiffuseColor, mSpecularColor, mShininess);
+}
+
+
 void Renderable::initRenderData(Falcor::RenderContext* pRenderContext) {}
 
 
@@ -219,6 +242,25 @@ void SceneObject::setProgramVars(const Falcor::ShaderVar& var) const
 }
 
 
+uint64_t SceneObject::getProgramVarsVersion() const
+{
+    return getTransformMaterialVersion();
+}
+
+
+uint64_t SceneObject::getProgramVarsHash() const
+{
+    return hashProgramVarData(mTransform.getProgramVarsHash(), mMaterial.getProgramVarsHash());
+}
+
+
+uint64_t SceneObject::getTransformMaterialVersion() const
+{
+    // The latest of the versions is unique to this object, and changes with either of them
+    return std::max(mTransform.getProgramVarsVersion(), mMaterial.getProgramVarsVersion());
+}
+
+
 void SceneObject::renderGui(Falcor::Gui::Widgets& w)
 {
     if (ImGui::TreeNodeEx("Transform", ImGuiTreeNodeFlags_DefaultOpen))
@@ -243,6 +285,90 @@ void SceneObject::invalidate()
 }
 
 
+bool SceneObject::hasPayload() const
+{
+    return false;
+}
+
+
+void SceneObject::savePayload(BinaryOutputArchive& ar) const {}
+
+
+void SceneObject::loadPayload(BinaryInputArchive& ar) {}
+
+
+bool SceneObject::ensurePayloadLoaded()
+{
+    if (!mPendingPayload)
+    {
+        return mValid;
+    }
+
+    const auto payload = std::move(*mPendingPayload);
+    const auto pBlobStore = std::move(mpPendingPayloadBlobStore);
+    auto pSharedBlobs = std::move(mpPendingPayloadSharedBlobs);
+    mPendingPayload.reset();
+    mpPendingPayloadBlobStore.reset();
+    mpPendingPayloadSharedBlobs.reset();
+
+    // This may run in the middle of saving the project (to another blob store), whose state is set aside rather than reset
+    auto& serializationManager = GraphEx::Internal::SerializationManager::get();
+    const auto pPreviousBlobStore = serializationManager.getBlobStore();
+    auto previousTrackedRefs = serializationManager.exchangeTrackedRefs({ });
+    serializationManager.setBlobStore(pBlobStore);
+    auto pPreviousSharedBlobs = serializationManager.exchangeSharedBlobs(std::move(pSharedBlobs));
+    serializationManager.pushInvalidityList();
+
+    std::istringstream iss(payload, std::ios::in | std::ios::binary);
+
+    try
+    {
+        BinaryInputArchive ar(iss);
+        loadPayload(ar);
+    }
+    catch (const std::exception& e)
+    {
+        Falcor::logError("Could not load the content of scene object '{}'. See details below:\n{}", mHumanReadableName, e.what());
+        invalidate();
+    }
+
+    for (const auto& message : *serializationManager.popInvalidityList())
+    {
+        Falcor::logWarning("Content of scene object '{}': {}", mHumanReadableName, message);
+    }
+
+    serializationManager.setBlobStore(pPreviousBlobStore);
+    serializationManager.exchangeSharedBlobs(std::move(pPreviousSharedBlobs));
+    serializationManager.exchangeTrackedRefs(std::move(previousTrackedRefs));
+
+    return mValid;
+}
+
+
+bool SceneObject::isPayloadLoaded() const
+{
+    return !mPendingPayload;
+}
+
+
+std::string SceneObject::savePayloadToString() const
+{
+    if (!hasPayload())
+    {
+        return { };
+    }
+
+    std::ostringstream oss(std::ios::out | std::ios::binary);
+
+    {
+        BinaryOutputArchive ar(oss);
+        savePayload(ar);
+    }
+
+    return oss.str();
+}
+
+
 bool SceneObject::isSelected() const
 {
     return mIsSelected;
@@ -269,28 +395,40 @@ void Light::setProgramVars(const Falcor::ShaderVar& var) const
 }
 
 
+uint64_t Light::getProgramVarsHash() const
+{
+    return hashProgramVarData(mType, mPosition, mDirection, mAmbientColor, mDiffuseColor, mSpecularColor, mConstantAttenuation,
+                              mLinearAttenuation, mQuadraticAttenuation);
+}
+
+
 void Light::renderGui(Falcor::Gui::Widgets& w)
 {
-    w.dropdown("Type", mType);
+    auto changed = w.dropdown("Type", mType);
 
     switch (mType)
     {
     case Type::Point:
-        w.var("Position", mPosition, -10000.0f, 10000.0f, 0.5f);
+        changed |= w.var("Position", mPosition, -10000.0f, 10000.0f, 0.5f);
         break;
     case Type::Directional:
-        w.var("Direction", mDirection, -1.0f, 1.0f, 0.05f);
+        changed |= w.var("Direction", mDirection, -1.0f, 1.0f, 0.05f);
         break;
     default:
         break;
     }
 
     ImGui::PushItemWidth(200);
-    w.rgbColor("Ambient Color", mAmbientColor);
-    w.rgbColor("Diffuse Color", mDiffuseColor);
-    w.rgbColor("Specular Color", mSpecularColor);
+    changed |= w.rgbColor("Ambient Color", mAmbientColor);
+    changed |= w.rgbColor("Diffuse Color", mDiffuseColor);
+    changed |= w.rgbColor("Specular Color", mSpecularColor);
     ImGui::PopItemWidth();
-    w.var("Constant Attenuation", mConstantAttenuation, 0.0f, 100.0f, 0.1f);
-    w.var("Linear Attenuation", mLinearAttenuation, 0.0f, 100.0f, 0.1f);
-    w.var("Quadratic Attenuation", mQuadraticAttenuation, 0.0f, 100.0f, 0.1f);
+    changed |= w.var("Constant Attenuation", mConstantAttenuation, 0.0f, 100.0f, 0.1f);
+    changed |= w.var("Linear Attenuation", mLinearAttenuation, 0.0f, 100.0f, 0.1f);
+    changed |= w.var("Quadratic Attenuation", mQuadraticAttenuation, 0.0f, 100.0f, 0.1f);
+
+    if (changed)
+    {
+        bumpProgramVarsVersion();
+    }
 }
\ No newline at end of file
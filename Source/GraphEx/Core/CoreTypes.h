@@ -17,9 +17,10 @@ struct GRAPHEX_EXPORTABLE Common
 };
 
 
-struct GRAPHEX_EXPORTABLE Transform : ProgramVarProvider
+struct GRAPHEX_EXPORTABLE Transform : VersionedProgramVarProvider
 {
     void setProgramVars(const Falcor::ShaderVar& var) const override;
+    uint64_t getProgramVarsHash() const override;
     void renderGui(Falcor::Gui::Widgets& w);
 
     template<typename Archive>
@@ -78,9 +79,10 @@ void Transform::serialize(Archive& ar)
 }
 
 
-struct GRAPHEX_EXPORTABLE Material : ProgramVarProvider
+struct GRAPHEX_EXPORTABLE Material : VersionedProgramVarProvider
 {
     void setProgramVars(const Falcor::ShaderVar& var) const override;
+    uint64_t getProgramVarsHash() const override;
     void renderGui(Falcor::Gui::Widgets& w);
 
     template<typename Archive>
@@ -93,10 +95,10 @@ private:
     float mShininess = 1.0f;
 
 public:
-    DEFAULT_CONST_GETREF_SETTER_DEFINITION(AmbientColor, mAmbientColor)
-    DEFAULT_CONST_GETREF_SETTER_DEFINITION(DiffuseColor, mDiffuseColor)
-    DEFAULT_CONST_GETREF_SETTER_DEFINITION(SpecularColor, mSpecularColor)
-    DEFAULT_CONST_GETTER_SETTER_DEFINITION(Shininess, mShininess)
+    DEFAULT_CONST_GETREF_VERSIONED_SETTER_DEFINITION(AmbientColor, mAmbientColor)
+    DEFAULT_CONST_GETREF_VERSIONED_SETTER_DEFINITION(DiffuseColor, mDiffuseColor)
+    DEFAULT_CONST_GETREF_VERSIONED_SETTER_DEFINITION(SpecularColor, mSpecularColor)
+    DEFAULT_CONST_GETTER_VERSIONED_SETTER_DEFINITION(Shininess, mShininess)
 };
 
 template<typename Archive>
@@ -106,6 +108,11 @@ void Material::serialize(Archive& ar)
     ar(SerializeNamed<Archive>("diffuseColor", mDiffuseColor));
     ar(SerializeNamed<Archive>("specularColor", mSpecularColor));
     ar(SerializeNamed<Archive>("shininess", mShininess));
+
+    if constexpr (IsInputArchive<Archive>())
+    {
+        bumpProgramVarsVersion();
+    }
 }
 
 
@@ -147,6 +154,10 @@ struct GRAPHEX_EXPORTABLE SceneObject : Renderable, ProgramVarProvider
     explicit SceneObject(std::string humanReadableName);
 
     void setProgramVars(const Falcor::ShaderVar& var) const override;
+    // Of the transform and the material. Derived types that set vars of their own must override it, returning UNVERSIONED or a version
+    // that also changes with those vars, e.g. std::max(getTransformMaterialVersion(), <version of the own vars>)
+    uint64_t getProgramVarsVersion() const override;
+    uint64_t getProgramVarsHash() const override;
     void renderGui(Falcor::Gui::Widgets& w);
 
     template<typename Archive>
@@ -154,13 +165,33 @@ struct GRAPHEX_EXPORTABLE SceneObject : Renderable, ProgramVarProvider
 
     void invalidate();
 
+    // Content of derived types that is expensive to load (e.g. geometry) belongs in the payload instead of serialize(). The payload is
+    // kept as an opaque blob when a project is loaded, and only deserialized once the object is first rendered or its settings are shown
+    virtual bool hasPayload() const;
+    virtual void savePayload(BinaryOutputArchive& ar) const;
+    virtual void loadPayload(BinaryInputArchive& ar);
+
+    // Deserializes the payload if it is still pending. Invalidates the object and returns false if that fails
+    bool ensurePayloadLoaded();
+    bool isPayloadLoaded() const;
+
+protected:
+    // Unique to this object, and changes with either the transform or the material
+    uint64_t getTransformMaterialVersion() const;
+
 private:
+    std::string savePayloadToString() const;
+
     std::string mHumanReadableName;
     Transform mTransform;
     Material mMaterial;
     bool mIsSelected = false;
     bool mValid = true;
 
+    std::optional<std::string> mPendingPayload;
+    std::shared_ptr<Internal::BlobStore> mpPendingPayloadBlobStore;  // The blobs referenced by the pending payload are stored here
+    std::shared_ptr<Internal::SerializationManager::SharedBlobs> mpPendingPayloadSharedBlobs;  // Or here, in a copy of a state
+
 public:
     DEFAULT_CONST_GETREF_SETTER_DEFINITION(HumanReadableName, mHumanReadableName)
     DEFAULT_CONST_NONCONST_GETREF_SETTER_DEFINITIONS(Transform, mTransform)
@@ -177,10 +208,72 @@ void SceneObject::serialize(Archive& ar)
     ar(SerializeNamed<Archive>("humanReadableName", mHumanReadableName));
     ar(SerializeNamed<Archive>("transform", mTransform));
     ar(SerializeNamed<Archive>("material", mMaterial));
+
+    if constexpr (IsOutputArchive<Archive>())
+    {
+        // Blobs the pending payload refers to would be missing from another project data file, so those have to be copied over. Shared
+        // blobs of a copy are in no file at all
+        if (mPendingPayload
+            && (mpPendingPayloadSharedBlobs || mpPendingPayloadBlobStore != Internal::SerializationManager::get().getBlobStore()))
+        {
+            ensurePayloadLoaded();
+        }
+
+        // A payload that was never needed since loading is written back as it was read
+        const auto payload = mPendingPayload ? *mPendingPayload : savePayloadToString();
+
+        if constexpr (IsTextArchive<Archive>())
+        {
+            ar(SerializeNamed<Archive>("payload", cereal::base64::encode(reinterpret_cast<const unsigned char*>(payload.data()),
+                                                                          payload.size())));
+        }
+        else
+        {
+            ar(SerializeNamed<Archive>("payload", payload));
+        }
+
+        // Copied within the process, a payload written just now refers to shared blobs, a pending one to the blob store
+        if (Internal::SerializationManager::get().getSharedBlobs())
+        {
+            ar(SerializeNamed<Archive>("payloadSharesBlobs", !mPendingPayload));
+        }
+    }
+    else
+    {
+        // Older project files have no payload
+        if constexpr (IsTextArchive<Archive>())
+        {
+            if (const auto pNodeName = ar.getNodeName(); !pNodeName || std::string_view(pNodeName) != "payload")
+            {
+                return;
+            }
+        }
+
+        std::string payload;
+        ar(SerializeNamed<Archive>("payload", payload));
+
+        if constexpr (IsTextArchive<Archive>())
+        {
+            payload = cereal::base64::decode(payload);
+        }
+
+        auto payloadSharesBlobs = false;
+
+        if (Internal::SerializationManager::get().getSharedBlobs())
+        {
+            ar(SerializeNamed<Archive>("payloadSharesBlobs", payloadSharesBlobs));
+        }
+
+        mPendingPayload = payload.empty() ? std::nullopt : std::make_optional(std::move(payload));
+        mpPendingPayloadBlobStore = mPendingPayload ? Internal::SerializationManager::get().getBlobStore() : nullptr;
+        mpPendingPayloadSharedBlobs = mPendingPayload && payloadSharesBlobs
+            ? Internal::SerializationManager::get().getSharedBlobs()
+            : nullptr;
+    }
 }
 
 
-struct GRAPHEX_EXPORTABLE Light : Falcor::Object, ProgramVarProvider
+struct GRAPHEX_EXPORTABLE Light : Falcor::Object, VersionedProgramVarProvider
 {
     enum class Type : Falcor::uint
     {
@@ -196,6 +289,7 @@ struct GRAPHEX_EXPORTABLE Light : Falcor::Object, ProgramVarProvider
     explicit Light(Type type) : mType(type) {}
 
     void setProgramVars(const Falcor::ShaderVar& var) const override;
+    uint64_t getProgramVarsHash() const override;
     void renderGui(Falcor::Gui::Widgets& w);
 
     template<typename Archive>
@@ -213,14 +307,14 @@ private:
     float mQuadraticAttenuation = 0.0f;
 
 public:
-    DEFAULT_CONST_GETREF_SETTER_DEFINITION(Position, mPosition)
-    DEFAULT_CONST_GETREF_SETTER_DEFINITION(Direction, mDirection)
-    DEFAULT_CONST_GETREF_SETTER_DEFINITION(AmbientColor, mAmbientColor)
-    DEFAULT_CONST_GETREF_SETTER_DEFINITION(DiffuseColor, mDiffuseColor)
-    DEFAULT_CONST_GETREF_SETTER_DEFINITION(SpecularColor, mSpecularColor)
-    DEFAULT_CONST_GETTER_SETTER_DEFINITION(ConstantAttenuation, mConstantAttenuation)
-    DEFAULT_CONST_GETTER_SETTER_DEFINITION(LinearAttenuation, mLinearAttenuation)
-    DEFAULT_CONST_GETTER_SETTER_DEFINITION(QuadraticAttenuation, mQuadraticAttenuation)
+    DEFAULT_CONST_GETREF_VERSIONED_SETTER_DEFINITION(Position, mPosition)
+    DEFAULT_CONST_GETREF_VERSIONED_SETTER_DEFINITION(Direction, mDirection)
+    DEFAULT_CONST_GETREF_VERSIONED_SETTER_DEFINITION(AmbientColor, mAmbientColor)
+    DEFAULT_CONST_GETREF_VERSIONED_SETTER_DEFINITION(DiffuseColor, mDiffuseColor)
+    DEFAULT_CONST_GETREF_VERSIONED_SETTER_DEFINITION(SpecularColor, mSpecularColor)
+    DEFAULT_CONST_GETTER_VERSIONED_SETTER_DEFINITION(ConstantAttenuation, mConstantAttenuation)
+    DEFAULT_CONST_GETTER_VERSIONED_SETTER_DEFINITION(LinearAttenuation, mLinearAttenuation)
+    DEFAULT_CONST_GETTER_VERSIONED_SETTER_DEFINITION(QuadraticAttenuation, mQuadraticAttenuation)
 };
 
 
@@ -253,6 +347,11 @@ void Light::serialize(Archive& ar)
     ar(SerializeNamed<Archive>("constantAttenuation", mConstantAttenuation));
     ar(SerializeNamed<Archive>("linearAttenuation", mLinearAttenuation));
     ar(SerializeNamed<Archive>("quadraticAttenuation", mQuadraticAttenuation));
+
+    if constexpr (IsInputArchive<Archive>())
+    {
+        bumpProgramVarsVersion();
+    }
 }
 
 
@@ -301,7 +400,9 @@ void SerializedSceneObjectState::serialize(Archive& ar)
                 }
             }
 
-            msgBox("Warning", os.str(), Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Warning);
+            // May be loaded on a worker thread, the message box is shown by the main thread once the states were applied
+            Falcor::logWarning(os.str());
+            Internal::SerializationManager::deferWarning(os.str());
         }
     }
 
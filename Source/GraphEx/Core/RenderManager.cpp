@@ -56,25 +56,40 @@ void RenderManager::update(Falcor::RenderContext* pRenderContext, const Falcor::
 {
     pRenderContext->clearFbo(pTargetFbo.get(), mpState->backgroundColor, 1.0f, 0, Falcor::FboAttachmentType::All);
 
+    // Payloads left pending by project loading are deserialized right before their object is rendered for the first time
+    for (const auto& pSceneObject : getOrderedObjects())
+    {
+        pSceneObject->ensurePayloadLoaded();
+    }
+
     EventManager::get().dispatchEvent<EventRenderWillBegin>();
 
-    for (const auto& pSceneObject : mOrderedObjects)
+    for (const auto& pSceneObject : getOrderedObjects())
     {
-        pSceneObject->preRender(*this, pRenderContext, pTargetFbo);
+        if (pSceneObject->isValid())
+        {
+            pSceneObject->preRender(*this, pRenderContext, pTargetFbo);
+        }
     }
 
     EventManager::get().dispatchEvent<EventRenderBegan>();
 
-    for (const auto& pSceneObject : mOrderedObjects)
+    for (const auto& pSceneObject : getOrderedObjects())
     {
-        pSceneObject->render(*this, pRenderContext, pTargetFbo);
+        if (pSceneObject->isValid())
+        {
+            pSceneObject->render(*this, pRenderContext, pTargetFbo);
+        }
     }
 
     EventManager::get().dispatchEvent<EventRenderWillEnd>();
 
-    for (const auto& pSceneObject : mOrderedObjects)
+    for (const auto& pSceneObject : getOrderedObjects())
     {
-        pSceneObject->postRender(*this, pRenderContext, pTargetFbo);
+        if (pSceneObject->isValid())
+        {
+            pSceneObject->postRender(*this, pRenderContext, pTargetFbo);
+        }
     }
 
     EventManager::get().dispatchEvent<EventRenderEnded>();
@@ -99,36 +114,77 @@ ModuleId RenderManager::getModuleId() const
 void RenderManager::setState(std::shared_ptr<RenderManagerState> pState)
 {
     HasSerializableState::setState(std::move(pState));
+    mObjectOrderResolved = false;
+}
 
-    // Clear the current scene objects
-    mOrderedObjects.clear();
 
-    for (const auto& pSceneObjectState : mpState->orderedObjectStates)
+const std::shared_ptr<RenderManagerState>& RenderManager::getState() const
+{
+    const auto& result = HasSerializableState::getState();
+    const auto& sceneObjects = getRequired<SceneManager>().getSceneObjects();
+
+    std::unordered_map<const SceneObject*, uint32_t> indexForSceneObject;
+    indexForSceneObject.reserve(sceneObjects.size());
+
+    for (uint32_t i = 0; i < sceneObjects.size(); ++i)
     {
-        if (pSceneObjectState.success() && pSceneObjectState.get()->isValid())
+        indexForSceneObject.emplace(sceneObjects[i].get(), i);
+    }
+
+    result->objectOrder.clear();
+    result->objectOrder.reserve(getOrderedObjects().size());
+
+    for (const auto& pSceneObject : getOrderedObjects())
+    {
+        if (const auto it = indexForSceneObject.find(pSceneObject.get()); it != indexForSceneObject.end())
         {
-            mOrderedObjects.push_back(pSceneObjectState.get());
+            result->objectOrder.push_back(it->second);
         }
     }
+
+    return result;
 }
 
 
-const std::shared_ptr<RenderManagerState>& RenderManager::getState() const
+const std::vector<std::shared_ptr<SceneObject>>& RenderManager::getOrderedObjects() const
 {
-    const auto& result = HasSerializableState::getState();
-    result->orderedObjectStates.clear();
-    result->orderedObjectStates.reserve(mOrderedObjects.size());
+    if (mObjectOrderResolved)
+    {
+        return mOrderedObjects;
+    }
+
+    mObjectOrderResolved = true;
+    mOrderedObjects.clear();
+
+    if (!mpState->legacyOrderedObjectStates.empty())
+    {
+        for (const auto& pSceneObjectState : mpState->legacyOrderedObjectStates)
+        {
+            if (pSceneObjectState.success() && pSceneObjectState.get()->isValid())
+            {
+                mOrderedObjects.push_back(pSceneObjectState.get());
+            }
+        }
+
+        mpState->legacyOrderedObjectStates.clear();
+        return mOrderedObjects;
+    }
+
+    const auto& sceneObjects = getRequired<SceneManager>().getSceneObjects();
 
-    for (const auto& pSceneObject : mOrderedObjects)
+    for (const auto index : mpState->objectOrder)
     {
-        result->orderedObjectStates.emplace_back(pSceneObject);
+        if (index < sceneObjects.size()
+            && std::find(mOrderedObjects.cbegin(), mOrderedObjects.cend(), sceneObjects[index]) == mOrderedObjects.cend())
+        {
+            mOrderedObjects.push_back(sceneObjects[index]);
+        }
     }
 
-    return result;
+    return mOrderedObjects;
 }
 
 
-
 void RenderManager::onSceneObjectAdded(const std::shared_ptr<SceneObject>& pSceneObject)
 {
     if (isObjectRendered(pSceneObject))
@@ -137,6 +193,7 @@ void RenderManager::onSceneObjectAdded(const std::shared_ptr<SceneObject>& pScen
     }
 
     mOrderedObjects.push_back(pSceneObject);
+    markStateDirty();
 }
 
 
@@ -149,6 +206,7 @@ void RenderManager::onSceneObjectRemoved(const std::shared_ptr<SceneObject>& pSc
 
     mOrderedObjects.erase(std::remove(mOrderedObjects.begin(), mOrderedObjects.end(), pSceneObject),
         mOrderedObjects.end());
+    markStateDirty();
 }
 
 
@@ -160,13 +218,13 @@ Falcor::ref<const Falcor::Camera> RenderManager::getActiveCamera() const
 
 void RenderManager::setBuiltinRenderVars(const Falcor::ShaderVar& rootVar, const SceneObject* pSceneObject) const
 {
-    if (!rootVar.hasMember("graphEx"))
+    const auto graphEx = rootVar.findMember("graphEx");
+
+    if (!graphEx.isValid())
     {
         FALCOR_THROW("Attempted to set builtin render vars on a ShaderVar that does not have the appropriate 'graphEx' member.");
     }
 
-    const auto graphEx = rootVar["graphEx"];
-
     ProgramVarProvider::trySetProgramVarsFor(graphEx, "_activeCamera", getRequired<CameraManager>());
     ProgramVarProvider::trySetProgramVarsFor(graphEx, "_scene", getRequired<SceneManager>());
 
@@ -177,6 +235,23 @@ void RenderManager::setBuiltinRenderVars(const Falcor::ShaderVar& rootVar, const
 }
 
 
+void RenderManager::setBuiltinRenderVars(ProgramWrapper& program, BuiltinRenderVars& builtinVars, const SceneObject* pSceneObject) const
+{
+    if (!builtinVars.graphEx.resolve(program.getVars()).isValid())
+    {
+        FALCOR_THROW("Attempted to set builtin render vars on a program that does not have the appropriate 'graphEx' member.");
+    }
+
+    program.setProgramVarsFor(builtinVars.activeCamera, getRequired<CameraManager>());
+    program.setProgramVarsFor(builtinVars.scene, getRequired<SceneManager>());
+
+    if (pSceneObject)
+    {
+        program.setProgramVarsFor(builtinVars.model, *pSceneObject);
+    }
+}
+
+
 void RenderManager::renderBoundingBoxAndAnchorPoint(
     Falcor::RenderContext* pRenderContext,
     const Falcor::ref<Falcor::Fbo>& pTargetFbo,
@@ -189,30 +264,32 @@ void RenderManager::renderBoundingBoxAndAnchorPoint(
     {
         auto& anchorPointRenderProgram = *mpAnchorPointRenderProgram;
 
-        setBuiltinRenderVars(anchorPointRenderProgram.getRootVar(), pSceneObject);
-        anchorPointRenderProgram["VScb"]["anchorPoint"] = pSceneObject->getTransform().getAnchorPoint();
-        anchorPointRenderProgram["VScb"]["screenScaling"] = Falcor::getDisplayScaleFactor();
-        anchorPointRenderProgram["VScb"]["screenSize"] = Falcor::uint2{ pTargetFbo->getWidth(), pTargetFbo->getHeight() };
-        anchorPointRenderProgram["VScb"]["pointSize"] = 10.0f;
-        anchorPointRenderProgram["PScb"]["color"] = Falcor::float3{ 1.0f, 0.0f, 0.0f };
+        setBuiltinRenderVars(anchorPointRenderProgram, mAnchorPointVars.builtin, pSceneObject);
+        anchorPointRenderProgram[mAnchorPointVars.anchorPoint] = pSceneObject->getTransform().getAnchorPoint();
+        anchorPointRenderProgram[mAnchorPointVars.screenScaling] = Falcor::getDisplayScaleFactor();
+        anchorPointRenderProgram[mAnchorPointVars.screenSize] = Falcor::uint2{ pTargetFbo->getWidth(), pTargetFbo->getHeight() };
+        anchorPointRenderProgram[mAnchorPointVars.pointSize] = 10.0f;
+        anchorPointRenderProgram[mAnchorPointVars.color] = Falcor::float3{ 1.0f, 0.0f, 0.0f };
         anchorPointRenderProgram.draw(pRenderContext, pTargetFbo, 6);
     }
 
     auto& boundingBoxRenderProgram = *mpBoundingBoxRenderProgram;
 
-    setBuiltinRenderVars(boundingBoxRenderProgram.getRootVar(), pSceneObject);
-    boundingBoxRenderProgram["VScb"]["modelTrans"] = boundingBox.minPoint;
-    boundingBoxRenderProgram["VScb"]["modelScale"] = boundingBox.extent();
-    boundingBoxRenderProgram["VScb"]["worldMatrix"] =
+    setBuiltinRenderVars(boundingBoxRenderProgram, mBoundingBoxVars.builtin, pSceneObject);
+    boundingBoxRenderProgram[mBoundingBoxVars.modelTrans] = boundingBox.minPoint;
+    boundingBoxRenderProgram[mBoundingBoxVars.modelScale] = boundingBox.extent();
+    boundingBoxRenderProgram[mBoundingBoxVars.worldMatrix] =
         pSceneObject ? pSceneObject->getTransform().getWorldMatrix() : Falcor::float4x4::identity();
 
-    boundingBoxRenderProgram["PScb"]["color"] = Falcor::float3{0.5f, 0.0f, 1.0f};
+    boundingBoxRenderProgram[mBoundingBoxVars.color] = Falcor::float3{0.5f, 0.0f, 1.0f};
     boundingBoxRenderProgram.draw(pRenderContext, pTargetFbo, 24);
 }
 
 
 void RenderManager::renderUI(Falcor::Gui::Widgets& w)
 {
+    const auto editTracker = UIHelpers::EditTracker{ };
+
     // Render global settings GUI
     {
         if (w.checkbox("VSync", mpState->vSync))
@@ -246,6 +323,8 @@ void RenderManager::renderUI(Falcor::Gui::Widgets& w)
     {
         unsigned int selectedObjectIndex = -1;
 
+        getOrderedObjects();
+
         if (!mOrderedObjects.empty())
         {
             constexpr auto MOVE_UP_BUTTON_LABEL = "Move Up##";
@@ -321,6 +400,7 @@ void RenderManager::renderUI(Falcor::Gui::Widgets& w)
             if (shouldSwap)
             {
                 std::iter_swap(mOrderedObjects.begin() + swapIndex, mOrderedObjects.begin() + swapIndex + swapDir);
+                markStateDirty();
             }
 
             ImGui::PopStyleVar();
@@ -338,9 +418,16 @@ void RenderManager::renderUI(Falcor::Gui::Widgets& w)
             if (selectedObjectIndex < mOrderedObjects.size())
             {
                 if (const auto& selectedObject = mOrderedObjects[selectedObjectIndex];
-                    selectedObject->hasSettings())
+                    selectedObject->ensurePayloadLoaded() && selectedObject->hasSettings())
                 {
+                    // The settings belong to the object, which is saved with the state of SceneManager
+                    const auto objectEditTracker = UIHelpers::EditTracker{ };
                     selectedObject->renderSettingsUI(w);
+
+                    if (objectEditTracker.hasEdits())
+                    {
+                        getRequired<SceneManager>().markStateDirty();
+                    }
                 }
                 else
                 {
@@ -355,6 +442,11 @@ void RenderManager::renderUI(Falcor::Gui::Widgets& w)
             ImGui::TreePop();
         }
     }
+
+    if (editTracker.hasEdits())
+    {
+        markStateDirty();
+    }
 }
 
 
@@ -384,5 +476,6 @@ void RenderManager::onModuleRegistered(const std::shared_ptr<RenderModuleBase>&
 
 bool RenderManager::isObjectRendered(const std::shared_ptr<SceneObject>& pSceneObject) const
 {
-    return std::find(mOrderedObjects.cbegin(), mOrderedObjects.cend(), pSceneObject) != mOrderedObjects.cend();
+    const auto& orderedObjects = getOrderedObjects();
+    return std::find(orderedObjects.cbegin(), orderedObjects.cend(), pSceneObject) != orderedObjects.cend();
 }
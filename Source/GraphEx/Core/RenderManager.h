@@ -15,7 +15,8 @@ struct GRAPHEX_EXPORTABLE RenderManagerState final : ModuleState
 {
     bool vSync = false;
     Falcor::float4 backgroundColor{0.15f, 0.15f, 0.15f, 1.0f};
-    std::vector<SerializedSceneObjectState> orderedObjectStates;
+    std::vector<uint32_t> objectOrder;  // Indices of the scene objects of SceneManager, in render order
+    std::vector<SerializedSceneObjectState> legacyOrderedObjectStates;  // Render order as written by older project files
 
     uint32_t selectedRendererIndex = 0;
 
@@ -30,7 +31,18 @@ void RenderManagerState::serialize(Archive& ar)
     ar(GRAPHEX_SERIALIZE_WITH_NAME(vSync));
     ar(GRAPHEX_SERIALIZE_WITH_NAME(backgroundColor));
     ar(SerializeNamed<Archive>("selectedRenderer", selectedRendererIndex));
-    ar(SerializeNamed<Archive>("objects", orderedObjectStates));
+
+    // Older projects stored the objects themselves, which tied this state to the one of SceneManager within a single archive
+    if constexpr (IsInputArchive<Archive>() && IsTextArchive<Archive>())
+    {
+        if (const auto pNodeName = ar.getNodeName(); pNodeName && std::string_view(pNodeName) == "objects")
+        {
+            ar(SerializeNamed<Archive>("objects", legacyOrderedObjectStates));
+            return;
+        }
+    }
+
+    ar(SerializeNamed<Archive>("objectOrder", objectOrder));
 }
 
 
@@ -54,7 +66,18 @@ struct GRAPHEX_EXPORTABLE RenderManager final : ContainerModule<RenderModuleBase
 
     Falcor::ref<const Falcor::Camera> getActiveCamera() const;
 
+    // Members the builtin render vars are set on, resolved once per program variant. The vars of the camera, the scene and the object are
+    // only set again if they changed since, so each program should have its own
+    struct BuiltinRenderVars
+    {
+        ProgramVarHandle graphEx{ "graphEx" };
+        ProgramVarHandle activeCamera{ "graphEx._activeCamera" };
+        ProgramVarHandle scene{ "graphEx._scene" };
+        ProgramVarHandle model{ "graphEx._model" };
+    };
+
     void setBuiltinRenderVars(const Falcor::ShaderVar& rootVar, const SceneObject* pSceneObject = nullptr) const;
+    void setBuiltinRenderVars(ProgramWrapper& program, BuiltinRenderVars& builtinVars, const SceneObject* pSceneObject = nullptr) const;
 
     template<typename RendererT, typename RenderableT>
     void preRenderObject(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo, RenderableT& renderable) const;
@@ -79,13 +102,40 @@ private:
     void onModuleRegistered(const std::shared_ptr<RenderModuleBase>& pModule) override;
     bool isObjectRendered(const std::shared_ptr<SceneObject>& pSceneObject) const;
 
-    std::vector<std::shared_ptr<SceneObject>> mOrderedObjects;
+    // The order is resolved lazily after a state was set, as the scene objects it refers to may only be loaded after it
+    const std::vector<std::shared_ptr<SceneObject>>& getOrderedObjects() const;
+
+    mutable std::vector<std::shared_ptr<SceneObject>> mOrderedObjects;
+    mutable bool mObjectOrderResolved = true;
 
     Falcor::Gui::DropdownList bRenderers;
     std::unordered_map<Falcor::uint, ModuleId> bRendererForIndex;
     std::unordered_map<ModuleId, Falcor::uint> bIndexForRenderer;
 
     Falcor::ref<GraphicsProgramWrapper> mpBoundingBoxRenderProgram, mpAnchorPointRenderProgram;
+
+    // Set for every object in every frame, resolved once per program variant
+    struct AnchorPointVars
+    {
+        BuiltinRenderVars builtin;
+        ProgramVarHandle anchorPoint{ "VScb.anchorPoint" };
+        ProgramVarHandle screenScaling{ "VScb.screenScaling" };
+        ProgramVarHandle screenSize{ "VScb.screenSize" };
+        ProgramVarHandle pointSize{ "VScb.pointSize" };
+        ProgramVarHandle color{ "PScb.color" };
+    };
+
+    struct BoundingBoxVars
+    {
+        BuiltinRenderVars builtin;
+        ProgramVarHandle modelTrans{ "VScb.modelTrans" };
+        ProgramVarHandle modelScale{ "VScb.modelScale" };
+        ProgramVarHandle worldMatrix{ "VScb.worldMatrix" };
+        ProgramVarHandle color{ "PScb.color" };
+    };
+
+    mutable AnchorPointVars mAnchorPointVars;
+    mutable BoundingBoxVars mBoundingBoxVars;
 };
 
 
@@ -21,6 +21,7 @@ void SceneManager::renderUI(Falcor::Gui::Widgets& w)
 {
     const auto style = ImGui::GetStyle();
     const auto itemSpacingH = style.ItemSpacing.x;
+    const auto editTracker = UIHelpers::EditTracker{ };
 
     // Render global light properties
     if (ImGui::TreeNodeEx("Global Light Properties"))
@@ -109,6 +110,11 @@ void SceneManager::renderUI(Falcor::Gui::Widgets& w)
 
         ImGui::TreePop();
     }
+
+    if (editTracker.hasEdits())
+    {
+        markStateDirty();
+    }
 }
 
 
@@ -124,6 +130,7 @@ void SceneManager::addSceneObject(const std::shared_ptr<SceneObject>& pSceneObje
     bSceneObjectButtons.emplace_back();
 
     selectSceneObject(mSceneObjects.size() - 1);
+    markStateDirty();
 
     EventManager::get().enqueueEvent<EventSceneObjectAdded>(pSceneObject);
 }
@@ -147,6 +154,8 @@ void SceneManager::removeSceneObject(const std::shared_ptr<SceneObject>& pSceneO
     }
 
     bSceneObjectButtons.pop_back();
+    markStateDirty();
+
     EventManager::get().enqueueEvent<EventSceneObjectRemoved>(pSceneObject);
 }
 
@@ -157,6 +166,18 @@ void SceneManager::setProgramVars(const Falcor::ShaderVar& var) const
 }
 
 
+uint64_t SceneManager::getProgramVarsVersion() const
+{
+    return mpState->pGlobalLight->getProgramVarsVersion();
+}
+
+
+uint64_t SceneManager::getProgramVarsHash() const
+{
+    return mpState->pGlobalLight->getProgramVarsHash();
+}
+
+
 void SceneManager::setState(std::shared_ptr<SceneManagerState> pState)
 {
     bool foundIncompatibleSceneObject = false, foundInvalidSceneObject = false;
@@ -182,17 +203,18 @@ void SceneManager::setState(std::shared_ptr<SceneManagerState> pState)
         mSceneObjects.push_back(pSceneObjectState.get());
     }
 
+    // The warnings are shown by the module registry once all loaded states were set, as the states may be loaded on other threads
     if (foundIncompatibleSceneObject)
     {
-        msgBox("Warning", "Some scene objects from the project file were not loaded because they were incompatible with the current "
-               "version of the program. Check the log for details.", Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Warning);
+        Internal::SerializationManager::deferWarning("Some scene objects from the project file were not loaded because they were "
+                                                     "incompatible with the current version of the program. Check the log for details.");
     }
 
     if (!foundIncompatibleSceneObject && foundInvalidSceneObject)
     {
         // We skip logging this message if incompatible objects were found, that message already suggests that the project file was bad
-        msgBox("Warning", "Some scene objects from the project file were not loaded because they were not valid.",
-               Falcor::MsgBoxType::Ok, Falcor::MsgBoxIcon::Warning);
+        Internal::SerializationManager::deferWarning("Some scene objects from the project file were not loaded because they were not "
+                                                     "valid.");
     }
 
     selectSceneObject(mpState->selectedSceneObjectIndex);
@@ -229,6 +251,7 @@ void SceneManager::selectSceneObject(const uint32_t index) const
 
     mSceneObjects.at(index)->setSelected(true);
     mpState->selectedSceneObjectIndex = index;
+    markStateDirty();
 }
 
 
@@ -38,6 +38,8 @@ struct GRAPHEX_EXPORTABLE SceneManager : Module, ProgramVarProvider, HasSerializ
     void removeSceneObject(const std::shared_ptr<SceneObject>& pSceneObject);
 
     void setProgramVars(const Falcor::ShaderVar& var) const override;
+    uint64_t getProgramVarsVersion() const override;
+    uint64_t getProgramVarsHash() const override;
 
     void setState(std::shared_ptr<SceneManagerState> pState) override;
     const std::shared_ptr<SceneManagerState>& getState() const override;
@@ -54,6 +56,9 @@ private:
 
     std::vector<std::shared_ptr<SceneObject>> mSceneObjects;
     std::vector<UIHelpers::DynamicButton>  bSceneObjectButtons;
+
+public:
+    DEFAULT_CONST_GETREF_DEFINITION(SceneObjects, mSceneObjects)
 };
 
 } // namespace GraphEx::Core
@@ -6,6 +6,7 @@
 #include "API/EventManager.h"
 #include "API/Module.h"
 #include "API/ModuleRegistry.h"
+#include "API/UndoHistory.h"
 
 #include "Core/CameraManager.h"
 #include "Core/CoreEvents.h"
@@ -20,11 +21,19 @@
 #include "UI/UI.h"
 #include "UI/UIHelpers.h"
 
+#include "Utils/BufferReadback.h"
+#include "Utils/CompressedStream.h"
+#include "Utils/ComputePassGraph.h"
 #include "Utils/DispatchManager.h"
 #include "Utils/GlobalLocalProperty.h"
+#include "Utils/GpuTimeRecorder.h"
+#include "Utils/ProgramCheckpoint.h"
 #include "Utils/ProgramContext.h"
 #include "Utils/ProgramWrapper.h"
+#include "Utils/ProjectFileStream.h"
+#include "Utils/ShaderCache.h"
 #include "Utils/Standard.h"
+#include "Utils/UploadRing.h"
 
 
 namespace GraphEx
@@ -0,0 +1,312 @@
+#include "BlobStore.h"
+
+
+using namespace GraphEx;
+using namespace GraphEx::Internal;
+
+
+BlobData::BlobData(std::vector<uint8_t> bytes)
+{
+    setStorage(std::move(bytes));
+}
+
+
+BlobData::BlobData(std::shared_ptr<const void> pStorage, const uint8_t* pData, const size_t size)
+    : mpStorage(std::move(pStorage))
+    , mpData(pData)
+    , mSize(size)
+{ }
+
+
+const uint8_t* BlobData::getData() const
+{
+    return mpData;
+}
+
+
+size_t BlobData::getSize() const
+{
+    return mSize;
+}
+
+
+bool BlobData::empty() const
+{
+    return mSize == 0;
+}
+
+
+void BlobData::setStorage(std::vector<uint8_t> bytes)
+{
+    auto pBytes = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+
+    mpData = pBytes->data();
+    mSize = pBytes->size();
+    mpStorage = std::move(pBytes);
+    mpReferencedStore.reset();
+}
+
+
+BlobStore::BlobStore(std::filesystem::path filePath)
+    : mFilePath(std::move(filePath))
+{ }
+
+
+std::filesystem::path BlobStore::getSidecarPath(const std::filesystem::path& projectFilePath)
+{
+    auto result = projectFilePath;
+    result.replace_extension(EXTENSION);
+    return result;
+}
+
+
+std::optional<BlobReference> BlobStore::write(const uint8_t* pData, const size_t size)
+{
+    std::lock_guard lock(mMutex);
+
+    if (!mFile.is_open() && !openForAppending())
+    {
+        return std::nullopt;
+    }
+
+    const auto hash = computeHash(pData, size);
+    const auto [ first, last ] = mBlobsByHash.equal_range(hash);
+
+    for (auto it = first; it != last; ++it)
+    {
+        if (it->second.size == size && isStored(it->second, pData))
+        {
+            return it->second;
+        }
+    }
+
+    const BlobReference reference{ hash, mEndOffset + RECORD_HEADER_SIZE, size };
+
+    mFile.clear();
+    mFile.seekp(static_cast<std::streamoff>(mEndOffset));
+    writeUInt64(mFile, hash);
+    writeUInt64(mFile, size);
+
+    if (!mFile.write(reinterpret_cast<const char*>(pData), static_cast<std::streamsize>(size)))
+    {
+        Falcor::logError("Failed to write project data file '{}'.", mFilePath.string());
+        mFile.clear();
+        return std::nullopt;
+    }
+
+    mEndOffset = reference.offset + size;
+    mBlobsByHash.emplace(hash, reference);
+
+    return reference;
+}
+
+
+bool BlobStore::flush()
+{
+    std::lock_guard lock(mMutex);
+
+    if (!mFile.is_open())
+    {
+        return true;
+    }
+
+    if (!mFile.flush())
+    {
+        return false;
+    }
+
+    // Same as the project file, whose commit follows, the content must not be lost on a power loss
+    if (!syncFileToDisk(mFilePath))
+    {
+        Falcor::logError("Could not sync project data file '{}' to disk.", mFilePath.string());
+        return false;
+    }
+
+    mCreatedUnflushed = false;
+    return true;
+}
+
+
+void BlobStore::discardUnflushedFile()
+{
+    std::lock_guard lock(mMutex);
+
+    if (!mCreatedUnflushed)
+    {
+        return;
+    }
+
+    mFile.close();
+    mpReader.reset();
+    mEndOffset = 0;
+    mBlobsByHash.clear();
+    mCreatedUnflushed = false;
+
+    std::error_code ec;
+    std::filesystem::remove(mFilePath, ec);
+}
+
+
+std::optional<BlobData> BlobStore::read(const BlobReference& reference)
+{
+    std::lock_guard lock(mMutex);
+
+    // Blobs appended since the file was mapped are only visible through a new mapping
+    const auto end = reference.offset + reference.size;
+
+    if ((!mpReader || end > mpReader->getSize()) && !remap())
+    {
+        return std::nullopt;
+    }
+
+    if (reference.offset < MAGIC.size() + RECORD_HEADER_SIZE || end < reference.offset || end > mpReader->getSize())
+    {
+        return std::nullopt;
+    }
+
+    const auto* pRecord = reinterpret_cast<const uint8_t*>(mpReader->getData()) + reference.offset - RECORD_HEADER_SIZE;
+    uint64_t hash = 0;
+    uint64_t size = 0;
+
+    for (size_t i = 0; i < sizeof(uint64_t); ++i)
+    {
+        hash |= static_cast<uint64_t>(pRecord[i]) << (8 * i);
+        size |= static_cast<uint64_t>(pRecord[sizeof(uint64_t) + i]) << (8 * i);
+    }
+
+    if (hash != reference.hash || size != reference.size)
+    {
+        return std::nullopt;
+    }
+
+    return BlobData(mpReader, pRecord + RECORD_HEADER_SIZE, static_cast<size_t>(size));
+}
+
+
+uint64_t BlobStore::computeHash(const uint8_t* pData, const size_t size)
+{
+    // 64-bit FNV-1a, collisions are resolved by comparing the content
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= pData[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+
+bool BlobStore::openForAppending()
+{
+    mFile = std::fstream(mFilePath, std::ios::in | std::ios::out | std::ios::binary);
+
+    if (!mFile.is_open())
+    {
+        mFile = std::fstream(mFilePath, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+        mFile.write(MAGIC.data(), static_cast<std::streamsize>(MAGIC.size()));
+
+        if (!mFile.flush())
+        {
+            Falcor::logError("Failed to create project data file '{}'.", mFilePath.string());
+            mFile.close();
+            return false;
+        }
+
+        mEndOffset = MAGIC.size();
+        mBlobsByHash.clear();
+        mCreatedUnflushed = true;
+        return true;
+    }
+
+    std::array<char, MAGIC.size()> header{ };
+    mFile.read(header.data(), static_cast<std::streamsize>(header.size()));
+
+    if (mFile.gcount() != static_cast<std::streamsize>(header.size()) || std::string_view(header.data(), header.size()) != MAGIC)
+    {
+        Falcor::logError("'{}' is not a project data file.", mFilePath.string());
+        mFile.close();
+        return false;
+    }
+
+    mFile.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<uint64_t>(mFile.tellg());
+
+    // Only the record headers are read, the index of the content is rebuilt from the hashes stored in them
+    mEndOffset = MAGIC.size();
+    mBlobsByHash.clear();
+    mFile.seekg(static_cast<std::streamoff>(mEndOffset));
+
+    while (mEndOffset + RECORD_HEADER_SIZE <= fileSize)
+    {
+        const auto hash = readUInt64(mFile);
+        const auto size = readUInt64(mFile);
+
+        if (!hash || !size || mEndOffset + RECORD_HEADER_SIZE + *size > fileSize)
+        {
+            break;
+        }
+
+        mBlobsByHash.emplace(*hash, BlobReference{ *hash, mEndOffset + RECORD_HEADER_SIZE, *size });
+        mEndOffset += RECORD_HEADER_SIZE + *size;
+        mFile.seekg(static_cast<std::streamoff>(mEndOffset));
+    }
+
+    // A record cut off by an interrupted save is overwritten by the next one
+    if (mEndOffset != fileSize)
+    {
+        Falcor::logWarning("Project data file '{}' ends with an incomplete blob, it is discarded.", mFilePath.string());
+    }
+
+    mFile.clear();
+    return true;
+}
+
+
+bool BlobStore::isStored(const BlobReference& reference, const uint8_t* pData)
+{
+    std::array<char, 64 * 1024> buffer{ };
+    uint64_t compared = 0;
+
+    mFile.clear();
+    mFile.seekg(static_cast<std::streamoff>(reference.offset));
+
+    while (compared < reference.size)
+    {
+        const auto chunkSize = static_cast<size_t>(std::min<uint64_t>(reference.size - compared, buffer.size()));
+
+        if (!mFile.read(buffer.data(), static_cast<std::streamsize>(chunkSize))
+            || std::memcmp(buffer.data(), pData + compared, chunkSize) != 0)
+        {
+            mFile.clear();
+            return false;
+        }
+
+        compared += chunkSize;
+    }
+
+    return true;
+}
+
+
+bool BlobStore::remap()
+{
+    if (mFile.is_open() && !mFile.flush())
+    {
+        mFile.clear();
+        return false;
+    }
+
+    auto pReader = std::make_shared<ProjectFileReader>(mFilePath);
+
+    if (!pReader->isOpen())
+    {
+        Falcor::logError("Failed to open project data file '{}'.", mFilePath.string());
+        return false;
+    }
+
+    // Blobs handed out earlier keep the previous mapping alive
+    mpReader = std::move(pReader);
+    return true;
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "SerializationMacros.h"
+#include "SerializationManager.h"
+#include "SerializationTemplates.h"
+
+
+namespace GraphEx
+{
+
+namespace Internal
+{
+
+struct BlobStore;
+
+struct BlobReference
+{
+    uint64_t hash = 0;
+    uint64_t offset = 0;  // Of the data, right after the record header
+    uint64_t size = 0;
+
+    template<typename Archive>
+    void serialize(Archive& ar);
+};
+
+} // namespace Internal
+
+
+// Large binary content of an object, like mesh vertices or initial buffer contents. When a project is saved, the content goes to the
+// .gxdata sidecar of the project file, and only a reference to it is written into the project. Loaded content points right into the
+// memory mapping of the sidecar, so it can be uploaded to the GPU without copying it first (see ProgramWrapper::allocateStructuredBuffer).
+// The content is immutable and shared between copies
+class GRAPHEX_EXPORTABLE BlobData
+{
+public:
+    BlobData() = default;
+    explicit BlobData(std::vector<uint8_t> bytes);
+
+    template<typename T>
+    static BlobData fromVector(const std::vector<T>& values);
+
+    const uint8_t* getData() const;
+    size_t getSize() const;
+    bool empty() const;
+
+    template<typename T>
+    const T* getDataAs() const { return reinterpret_cast<const T*>(mpData); }
+
+    template<typename T>
+    size_t getElementCount() const { return mSize / sizeof(T); }
+
+    template<typename Archive>
+    void save(Archive& ar) const;
+
+    template<typename Archive>
+    void load(Archive& ar);
+
+private:
+    friend struct Internal::BlobStore;
+
+    BlobData(std::shared_ptr<const void> pStorage, const uint8_t* pData, size_t size);
+
+    void setStorage(std::vector<uint8_t> bytes);
+
+    std::shared_ptr<const void> mpStorage;  // Owns the bytes, or keeps the mapping they live in alive
+    const uint8_t* mpData = nullptr;
+    size_t mSize = 0;
+
+    // Where the content was last written to or read from, so saving it into the same store again needs no hashing
+    mutable std::weak_ptr<Internal::BlobStore> mpReferencedStore;
+    mutable Internal::BlobReference mReference;
+};
+
+
+namespace Internal
+{
+
+// Append-only store of blobs in the sidecar of a project file. Blobs are deduplicated by their content, so saving unchanged data again
+// costs nothing, and the project file itself stays small. Nothing is ever removed, blobs no longer referenced by any save remain until
+// the sidecar is deleted. A project and its autosave share the same sidecar.
+//
+// Layout: [ MAGIC ] [ hash (u64) | size (u64) | data ]*
+struct GRAPHEX_EXPORTABLE BlobStore
+{
+    static constexpr std::string_view MAGIC{ "GXBLOBS", 8 };  // Including the terminating zero
+    static constexpr std::string_view EXTENSION = ".gxdata";
+    static constexpr uint64_t RECORD_HEADER_SIZE = 2 * sizeof(uint64_t);
+
+    // The file is not touched before the first blob is written or read
+    explicit BlobStore(std::filesystem::path filePath);
+
+    MAKE_MOVE_ONLY(BlobStore)
+
+    static std::filesystem::path getSidecarPath(const std::filesystem::path& projectFilePath);
+
+    // Appends the content, unless the same content is stored already
+    std::optional<BlobReference> write(const uint8_t* pData, size_t size);
+
+    // Makes everything written so far durable, a project referring to the blobs must only be committed afterward
+    bool flush();
+
+    // Deletes the file again if this store created it and it was never flushed, so a failed save leaves no file behind that nothing
+    // refers to
+    void discardUnflushedFile();
+
+    // A view into the memory mapping of the sidecar, nothing if the reference does not point at a blob of the store
+    std::optional<BlobData> read(const BlobReference& reference);
+
+    static uint64_t computeHash(const uint8_t* pData, size_t size);
+
+private:
+    bool openForAppending();
+    bool isStored(const BlobReference& reference, const uint8_t* pData);
+    bool remap();
+
+    std::filesystem::path mFilePath;
+    std::mutex mMutex;
+
+    std::fstream mFile;
+    uint64_t mEndOffset = 0;
+    bool mCreatedUnflushed = false;
+    std::unordered_multimap<uint64_t, BlobReference> mBlobsByHash;
+
+    std::shared_ptr<ProjectFileReader> mpReader;  // Shared with the BlobData views into it
+
+public:
+    DEFAULT_CONST_GETREF_DEFINITION(FilePath, mFilePath)
+};
+
+
+template<typename Archive>
+void BlobReference::serialize(Archive& ar)
+{
+    ar(GRAPHEX_SERIALIZE_WITH_NAME(hash));
+    ar(GRAPHEX_SERIALIZE_WITH_NAME(offset));
+    ar(GRAPHEX_SERIALIZE_WITH_NAME(size));
+}
+
+} // namespace Internal
+
+
+template<typename T>
+BlobData BlobData::fromVector(const std::vector<T>& values)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be stored as a blob");
+
+    const auto* pBytes = reinterpret_cast<const uint8_t*>(values.data());
+    return BlobData(std::vector<uint8_t>(pBytes, pBytes + values.size() * sizeof(T)));
+}
+
+
+template<typename Archive>
+void BlobData::save(Archive& ar) const
+{
+    // Copied within the process, the content is immutable and can be shared as it is
+    if (const auto& pSharedBlobs = Internal::SerializationManager::get().getSharedBlobs())
+    {
+        ar(SerializeNamed<Archive>("sharedIndex", static_cast<uint64_t>(pSharedBlobs->size())));
+        pSharedBlobs->push_back(*this);
+        return;
+    }
+
+    const auto& pBlobStore = Internal::SerializationManager::get().getBlobStore();
+    std::optional<Internal::BlobReference> reference;
+
+    if (pBlobStore && !empty())
+    {
+        reference = mpReferencedStore.lock() == pBlobStore ? std::make_optional(mReference) : pBlobStore->write(mpData, mSize);
+
+        if (reference)
+        {
+            mpReferencedStore = pBlobStore;
+            mReference = *reference;
+        }
+        else
+        {
+            Falcor::logWarning("Could not write to '{}', the data is saved into the project file instead.", pBlobStore->getFilePath().string());
+        }
+    }
+
+    ar(SerializeNamed<Archive>("inSidecar", reference.has_value()));
+
+    if (reference)
+    {
+        ar(SerializeNamed<Archive>("reference", *reference));
+    }
+    else if constexpr (IsTextArchive<Archive>())
+    {
+        ar(SerializeNamed<Archive>("data", cereal::base64::encode(mpData, mSize)));
+    }
+    else
+    {
+        ar(SerializeNamed<Archive>("data", std::string(reinterpret_cast<const char*>(mpData), mSize)));
+    }
+}
+
+
+template<typename Archive>
+void BlobData::load(Archive& ar)
+{
+    if (const auto& pSharedBlobs = Internal::SerializationManager::get().getSharedBlobs())
+    {
+        uint64_t sharedIndex;
+        ar(SerializeNamed<Archive>("sharedIndex", sharedIndex));
+
+        if (sharedIndex >= pSharedBlobs->size())
+        {
+            throw cereal::Exception(fmt::format("Shared blob {} does not exist", sharedIndex));
+        }
+
+        *this = (*pSharedBlobs)[static_cast<size_t>(sharedIndex)];
+        return;
+    }
+
+    bool inSidecar;
+    ar(SerializeNamed<Archive>("inSidecar", inSidecar));
+
+    if (inSidecar)
+    {
+        Internal::BlobReference reference;
+        ar(SerializeNamed<Archive>("reference", reference));
+
+        const auto& pBlobStore = Internal::SerializationManager::get().getBlobStore();
+        auto blob = pBlobStore ? pBlobStore->read(reference) : std::nullopt;
+
+        if (!blob)
+        {
+            throw cereal::Exception(fmt::format("Blob at offset {} is missing from the project data file", reference.offset));
+        }
+
+        *this = std::move(*blob);
+        mpReferencedStore = pBlobStore;
+        mReference = reference;
+        return;
+    }
+
+    std::string data;
+    ar(SerializeNamed<Archive>("data", data));
+
+    if constexpr (IsTextArchive<Archive>())
+    {
+        data = cereal::base64::decode(data);
+    }
+
+    setStorage(std::vector<uint8_t>(data.begin(), data.end()));
+}
+
+} // namespace GraphEx
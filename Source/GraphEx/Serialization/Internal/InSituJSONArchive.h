@@ -0,0 +1,821 @@
+#pragma once
+
+#include <cereal/cereal.hpp>
+#include <cereal/archives/json.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace GraphEx::Internal
+{
+
+// Drop-in replacement for cereal::JSONInputArchive that reads a null-terminated buffer in place (e.g. a memory-mapped project file)
+// instead of building a DOM of the whole document. The document is validated up front without keeping anything, then only the nodes
+// on the path to the value being read are scanned for the locations of their direct children, and values are parsed once they are
+// read. Peak memory is bound by the widest object or array being read rather than by the size of the file, and strings are copied only
+// once, into the loaded object. The buffer has to outlive the archive.
+// Apart from where the document comes from, behaviour is kept identical to cereal::JSONInputArchive so project files stay compatible
+class InSituJSONInputArchive : public cereal::InputArchive<InSituJSONInputArchive>, public cereal::traits::TextArchive
+{
+    using Reader = CEREAL_RAPIDJSON_NAMESPACE::Reader;
+    using SizeType = CEREAL_RAPIDJSON_NAMESPACE::SizeType;
+
+public:
+    // Reads the given buffer in place, it is left untouched
+    InSituJSONInputArchive(const char* pBuffer);
+
+    // Takes the whole remaining content of the stream into a buffer owned by the archive, and reads that in place. Compressed JSON
+    // projects are loaded this way, so their decompressed content is held in memory as a whole while they are read
+    InSituJSONInputArchive(std::istream& is);
+
+    ~InSituJSONInputArchive() noexcept = default;
+
+    // One archive for each element of the named array that comes next, so that the elements can be read independently, even
+    // concurrently. They read the buffer of this archive, which must outlive them. Nothing is returned if an element refers to a
+    // shared pointer written in another element, as such elements cannot be read on their own. In that case, the array is left to be
+    // read as usual, otherwise it is skipped
+    std::optional<std::vector<std::unique_ptr<InSituJSONInputArchive>>> splitArray(const char* name);
+
+    void loadBinaryValue(void* data, size_t size, const char* name = nullptr);
+
+    void startNode();
+    void finishNode();
+    const char* getNodeName() const;
+    void setNextName(const char* name);
+
+    template<typename T, cereal::traits::EnableIf<std::is_signed_v<T>, sizeof(T) < sizeof(int64_t)> = cereal::traits::sfinae>
+    void loadValue(T& value)
+    {
+        value = static_cast<T>(readScalar().getInteger<int>());
+    }
+
+    template<typename T,
+             cereal::traits::EnableIf<std::is_unsigned_v<T>, sizeof(T) < sizeof(uint64_t), !std::is_same_v<bool, T>> = cereal::traits::sfinae>
+    void loadValue(T& value)
+    {
+        value = static_cast<T>(readScalar().getInteger<unsigned>());
+    }
+
+    void loadValue(bool& value);
+    void loadValue(int64_t& value);
+    void loadValue(uint64_t& value);
+    void loadValue(float& value);
+    void loadValue(double& value);
+    void loadValue(std::string& value);
+    void loadValue(std::nullptr_t&);
+
+    // 64 bit flavours of long on platforms where the fixed width integer types are defined as long long
+    template<typename T, cereal::traits::EnableIf<std::is_same_v<T, long> || std::is_same_v<T, unsigned long>,
+                                                  !std::is_same_v<T, int64_t>, !std::is_same_v<T, uint64_t>,
+                                                  sizeof(T) == sizeof(int64_t)> = cereal::traits::sfinae>
+    void loadValue(T& value)
+    {
+        std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t> fixedValue;
+        loadValue(fixedValue);
+        value = static_cast<T>(fixedValue);
+    }
+
+    // Types that JSON has no native representation for (e.g. long double) are stored as strings
+    template<typename T, cereal::traits::EnableIf<std::is_arithmetic_v<T>,
+                                                  !std::is_same_v<T, long>, !std::is_same_v<T, unsigned long>,
+                                                  !std::is_same_v<T, int64_t>, !std::is_same_v<T, uint64_t>,
+                                                  (sizeof(T) >= sizeof(long double) || sizeof(T) >= sizeof(long long))> = cereal::traits::sfinae>
+    void loadValue(T& value)
+    {
+        std::string encoded;
+        loadValue(encoded);
+
+        std::istringstream is(encoded);
+        is >> value;
+    }
+
+    void loadSize(cereal::size_type& size);
+
+private:
+    // Location of a value in the buffer, not parsed yet
+    struct Range
+    {
+        const char* pBegin = nullptr;
+        const char* pEnd = nullptr;
+    };
+
+    // An object or array being read, with the names (objects only) and locations of its direct children
+    struct Node
+    {
+        std::vector<std::string> names;
+        std::vector<Range> values;
+        size_t index = 0;
+
+        const Range& value() const;
+        const char* name() const;
+
+        void search(const char* searchName);
+    };
+
+    // Receives a single scalar value from the reader
+    struct Scalar : CEREAL_RAPIDJSON_NAMESPACE::BaseReaderHandler<CEREAL_RAPIDJSON_NAMESPACE::UTF8<>, Scalar>
+    {
+        enum class Type { Null, Bool, Signed, Unsigned, Double, String };
+
+        Type type = Type::Null;
+        bool boolValue = false;
+        int64_t signedValue = 0;
+        uint64_t unsignedValue = 0;
+        double doubleValue = 0.0;
+        std::string stringValue;
+
+        bool Default() { return false; }  // Objects and arrays
+        bool Null() { type = Type::Null; return true; }
+        bool Bool(const bool value) { type = Type::Bool; boolValue = value; return true; }
+        bool Int(const int value) { return Int64(value); }
+        bool Uint(const unsigned value) { return Uint64(value); }
+        bool Int64(const int64_t value) { type = Type::Signed; signedValue = value; return true; }
+        bool Uint64(const uint64_t value) { type = Type::Unsigned; unsignedValue = value; return true; }
+        bool Double(const double value) { type = Type::Double; doubleValue = value; return true; }
+        bool String(const char* pValue, const SizeType length, bool) { type = Type::String; stringValue.assign(pValue, length); return true; }
+
+        // Same conversions as the getters of rapidjson values: integers must fit, any number reads as a floating point value
+        template<typename T>
+        T getInteger() const;
+        double getDouble() const;
+        void expect(Type expectedType) const;
+    };
+
+    struct References
+    {
+        std::unordered_set<uint32_t> definedPointerIds;
+        std::unordered_set<uint32_t> referencedPointerIds;
+        std::unordered_map<uint32_t, std::string> polymorphicNames;
+    };
+
+    // Picks the ids cereal writes for shared pointers and polymorphic types out of a value, while it streams by
+    struct ReferenceCollector : CEREAL_RAPIDJSON_NAMESPACE::BaseReaderHandler<CEREAL_RAPIDJSON_NAMESPACE::UTF8<>, ReferenceCollector>
+    {
+        struct Frame
+        {
+            std::string name;
+            std::optional<uint32_t> polymorphicId;
+            std::optional<std::string> polymorphicName;
+        };
+
+        explicit ReferenceCollector(References& references) : references(references) { }
+
+        bool Default() { key.clear(); return true; }
+        bool Key(const char* pName, const SizeType length, bool) { key.assign(pName, length); return true; }
+        bool Uint(unsigned value);
+        bool String(const char* pValue, SizeType length, bool);
+        bool StartObject() { frames.push_back({ std::move(key) }); key.clear(); return true; }
+        bool EndObject(SizeType);
+        bool StartArray() { return StartObject(); }
+        bool EndArray(SizeType) { frames.pop_back(); key.clear(); return true; }
+
+        References& references;
+        std::vector<Frame> frames;
+        std::string key;
+    };
+
+    // Reads a single element of an array, in the buffer of another archive
+    explicit InSituJSONInputArchive(Range element);
+
+    void validate(const char* pBuffer);
+    static Node scan(const Range& range);
+
+    void search();
+    const Range& next();
+    const Scalar& readScalar();
+
+    template<typename Handler>
+    static void parseValue(const Range& range, Handler& handler);
+
+    static const char* skipWhitespace(const char* p);
+    static const char* skipString(const char* p);
+    static const char* skipValue(const char* p);
+
+    const char* mpNextName = nullptr;
+    std::vector<char> mOwnedBuffer;
+    std::vector<Node> mNodeStack;
+    Range mRoot;
+    bool mIsElement = false;
+    Scalar mScalar;
+};
+
+
+inline InSituJSONInputArchive::InSituJSONInputArchive(const char* pBuffer)
+    : cereal::InputArchive<InSituJSONInputArchive>(this)
+{
+    validate(pBuffer);
+}
+
+
+inline InSituJSONInputArchive::InSituJSONInputArchive(std::istream& is)
+    : cereal::InputArchive<InSituJSONInputArchive>(this)
+{
+    mOwnedBuffer.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    mOwnedBuffer.push_back('\0');
+    validate(mOwnedBuffer.data());
+}
+
+
+inline InSituJSONInputArchive::InSituJSONInputArchive(const Range element)
+    : cereal::InputArchive<InSituJSONInputArchive>(this)
+    , mRoot(element)
+    , mIsElement(true)
+{
+    // Seen as the only element of an array, so that it is read just like the elements of the original array
+    mNodeStack.push_back(Node{ { }, { element } });
+}
+
+
+inline auto InSituJSONInputArchive::splitArray(const char* name) -> std::optional<std::vector<std::unique_ptr<InSituJSONInputArchive>>>
+{
+    setNextName(name);
+    const auto& range = next();
+
+    if (*skipWhitespace(range.pBegin) != '[')
+    {
+        throw cereal::Exception("JSON Parsing failed - provided NVP (" + std::string(name) + ") is not an array");
+    }
+
+    const auto array = scan(range);
+    std::unordered_map<uint32_t, std::string> polymorphicNames;
+
+    for (const auto& element : array.values)
+    {
+        References references;
+        ReferenceCollector collector(references);
+        parseValue(element, collector);
+
+        polymorphicNames.insert(references.polymorphicNames.begin(), references.polymorphicNames.end());
+
+        for (const auto id : references.referencedPointerIds)
+        {
+            if (references.definedPointerIds.count(id) == 0)
+            {
+                return std::nullopt;
+            }
+        }
+    }
+
+    ++mNodeStack.back().index;
+
+    std::vector<std::unique_ptr<InSituJSONInputArchive>> result;
+    result.reserve(array.values.size());
+
+    for (const auto& element : array.values)
+    {
+        result.emplace_back(new InSituJSONInputArchive(element));
+
+        // A polymorphic type is named only where it is written first, which may well be in another element
+        for (const auto& [ id, polymorphicName ] : polymorphicNames)
+        {
+            result.back()->registerPolymorphicName(id, polymorphicName);
+        }
+    }
+
+    return result;
+}
+
+
+inline void InSituJSONInputArchive::validate(const char* pBuffer)
+{
+    // A single pass that keeps nothing, so that syntax errors are still reported before anything is loaded
+    CEREAL_RAPIDJSON_NAMESPACE::BaseReaderHandler<> handler;
+    CEREAL_RAPIDJSON_NAMESPACE::StringStream stream(pBuffer);
+    Reader reader;
+
+    if (reader.Parse(stream, handler).IsError())
+    {
+        throw cereal::Exception("JSON parsing failed at offset " + std::to_string(reader.GetErrorOffset()));
+    }
+
+    const auto pRoot = skipWhitespace(pBuffer);
+
+    if (*pRoot != '{' && *pRoot != '[')
+    {
+        throw cereal::Exception("JSON parsing failed: the document root is neither an object nor an array");
+    }
+
+    mRoot = Range{ pRoot, skipValue(pRoot) };
+    mNodeStack.push_back(scan(mRoot));
+}
+
+
+inline auto InSituJSONInputArchive::scan(const Range& range) -> Node
+{
+    // Only called on validated content, the structure can be trusted
+    auto p = skipWhitespace(range.pBegin);
+
+    if (*p != '{' && *p != '[')
+    {
+        throw cereal::Exception("JSON Parsing failed - expected an object or an array");
+    }
+
+    const auto isObject = *p == '{';
+    const auto closing = isObject ? '}' : ']';
+
+    Node node;
+    p = skipWhitespace(p + 1);
+
+    while (*p != closing)
+    {
+        if (isObject)
+        {
+            const auto pNameEnd = skipString(p);
+
+            // Names written by cereal never need unescaping, but hand-edited files may
+            if (std::find(p, pNameEnd, '\\') == pNameEnd)
+            {
+                node.names.emplace_back(p + 1, pNameEnd - 1);
+            }
+            else
+            {
+                Scalar name;
+                parseValue(Range{ p, pNameEnd }, name);
+                node.names.push_back(std::move(name.stringValue));
+            }
+
+            p = skipWhitespace(skipWhitespace(pNameEnd) + 1);  // Past the colon
+        }
+
+        const auto pValueEnd = skipValue(p);
+        node.values.push_back(Range{ p, pValueEnd });
+
+        p = skipWhitespace(pValueEnd);
+
+        if (*p == ',')
+        {
+            p = skipWhitespace(p + 1);
+        }
+    }
+
+    return node;
+}
+
+
+inline void InSituJSONInputArchive::loadBinaryValue(void* data, const size_t size, const char* name)
+{
+    mpNextName = name;
+
+    std::string encoded;
+    loadValue(encoded);
+
+    const auto decoded = cereal::base64::decode(encoded);
+
+    if (size != decoded.size())
+    {
+        throw cereal::Exception("Decoded binary data size does not match specified size");
+    }
+
+    std::memcpy(data, decoded.data(), decoded.size());
+    mpNextName = nullptr;
+}
+
+
+inline void InSituJSONInputArchive::startNode()
+{
+    search();
+    mNodeStack.push_back(scan(mNodeStack.back().value()));
+}
+
+
+inline void InSituJSONInputArchive::finishNode()
+{
+    mNodeStack.pop_back();
+    ++mNodeStack.back().index;
+}
+
+
+inline const char* InSituJSONInputArchive::getNodeName() const
+{
+    return mNodeStack.back().name();
+}
+
+
+inline void InSituJSONInputArchive::setNextName(const char* name)
+{
+    mpNextName = name;
+}
+
+
+inline auto InSituJSONInputArchive::next() -> const Range&
+{
+    search();
+    return mNodeStack.back().value();
+}
+
+
+inline auto InSituJSONInputArchive::readScalar() -> const Scalar&
+{
+    parseValue(next(), mScalar);
+    ++mNodeStack.back().index;
+    return mScalar;
+}
+
+
+template<typename Handler>
+void InSituJSONInputArchive::parseValue(const Range& range, Handler& handler)
+{
+    CEREAL_RAPIDJSON_NAMESPACE::StringStream stream(range.pBegin);
+    Reader reader;
+
+    if (reader.Parse<CEREAL_RAPIDJSON_NAMESPACE::kParseStopWhenDoneFlag>(stream, handler).IsError())
+    {
+        throw cereal::Exception("JSON Parsing failed - value is not of the expected type");
+    }
+}
+
+
+inline void InSituJSONInputArchive::loadValue(bool& value)
+{
+    const auto& scalar = readScalar();
+    scalar.expect(Scalar::Type::Bool);
+    value = scalar.boolValue;
+}
+
+
+inline void InSituJSONInputArchive::loadValue(int64_t& value)
+{
+    value = readScalar().getInteger<int64_t>();
+}
+
+
+inline void InSituJSONInputArchive::loadValue(uint64_t& value)
+{
+    value = readScalar().getInteger<uint64_t>();
+}
+
+
+inline void InSituJSONInputArchive::loadValue(float& value)
+{
+    value = static_cast<float>(readScalar().getDouble());
+}
+
+
+inline void InSituJSONInputArchive::loadValue(double& value)
+{
+    value = readScalar().getDouble();
+}
+
+
+inline void InSituJSONInputArchive::loadValue(std::string& value)
+{
+    const auto& range = next();
+    const auto pContentBegin = skipWhitespace(range.pBegin) + 1;
+    const auto pContentEnd = range.pEnd - 1;
+
+    // The only copy of the string, straight from the buffer, unless it has to be unescaped
+    if (*(pContentBegin - 1) == '"' && std::find(pContentBegin, pContentEnd, '\\') == pContentEnd)
+    {
+        value.assign(pContentBegin, pContentEnd);
+        ++mNodeStack.back().index;
+        return;
+    }
+
+    const auto& scalar = readScalar();
+    scalar.expect(Scalar::Type::String);
+    value = scalar.stringValue;
+}
+
+
+inline void InSituJSONInputArchive::loadValue(std::nullptr_t&)
+{
+    readScalar().expect(Scalar::Type::Null);
+}
+
+
+inline void InSituJSONInputArchive::loadSize(cereal::size_type& size)
+{
+    // The synthetic node of an element archive holds the element itself, not its children
+    if (mNodeStack.size() == 1 && mIsElement)
+    {
+        size = scan(mRoot).values.size();
+    }
+    else
+    {
+        size = mNodeStack.back().values.size();
+    }
+}
+
+
+inline void InSituJSONInputArchive::search()
+{
+    // Reset before searching, in case the search throws
+    const auto pLocalNextName = mpNextName;
+    mpNextName = nullptr;
+
+    if (pLocalNextName)
+    {
+        // Only search if the name does not match the upcoming node, the common case for archives written by cereal
+        const auto pActualName = mNodeStack.back().name();
+
+        if (!pActualName || std::strcmp(pLocalNextName, pActualName) != 0)
+        {
+            mNodeStack.back().search(pLocalNextName);
+        }
+    }
+}
+
+
+inline const char* InSituJSONInputArchive::skipWhitespace(const char* p)
+{
+    while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
+    {
+        ++p;
+    }
+
+    return p;
+}
+
+
+inline const char* InSituJSONInputArchive::skipString(const char* p)
+{
+    for (++p; *p != '"'; ++p)
+    {
+        if (*p == '\\')
+        {
+            ++p;
+        }
+    }
+
+    return p + 1;
+}
+
+
+inline const char* InSituJSONInputArchive::skipValue(const char* p)
+{
+    if (*p == '"')
+    {
+        return skipString(p);
+    }
+
+    if (*p != '{' && *p != '[')
+    {
+        while (*p && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')
+        {
+            ++p;
+        }
+
+        return p;
+    }
+
+    size_t depth = 0;
+
+    do
+    {
+        if (*p == '"')
+        {
+            p = skipString(p);
+            continue;
+        }
+
+        if (*p == '{' || *p == '[')
+        {
+            ++depth;
+        }
+        else if (*p == '}' || *p == ']')
+        {
+            --depth;
+        }
+
+        ++p;
+    }
+    while (depth > 0);
+
+    return p;
+}
+
+
+inline auto InSituJSONInputArchive::Node::value() const -> const Range&
+{
+    if (index >= values.size())
+    {
+        throw cereal::Exception("No more objects in input");
+    }
+
+    return values[index];
+}
+
+
+inline const char* InSituJSONInputArchive::Node::name() const
+{
+    return index < names.size() ? names[index].c_str() : nullptr;
+}
+
+
+inline void InSituJSONInputArchive::Node::search(const char* searchName)
+{
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        if (names[i] == searchName)
+        {
+            index = i;
+            return;
+        }
+    }
+
+    throw cereal::Exception("JSON Parsing failed - provided NVP (" + std::string(searchName) + ") not found");
+}
+
+
+template<typename T>
+T InSituJSONInputArchive::Scalar::getInteger() const
+{
+    if (type == Type::Signed && signedValue >= static_cast<int64_t>(std::numeric_limits<T>::min())
+        && (std::is_unsigned_v<T> || signedValue <= static_cast<int64_t>(std::numeric_limits<T>::max())))
+    {
+        return static_cast<T>(signedValue);
+    }
+
+    if (type == Type::Unsigned && unsignedValue <= static_cast<uint64_t>(std::numeric_limits<T>::max()))
+    {
+        return static_cast<T>(unsignedValue);
+    }
+
+    throw cereal::Exception("JSON Parsing failed - value is not an integer of the expected range");
+}
+
+
+inline double InSituJSONInputArchive::Scalar::getDouble() const
+{
+    switch (type)
+    {
+        case Type::Signed: return static_cast<double>(signedValue);
+        case Type::Unsigned: return static_cast<double>(unsignedValue);
+        case Type::Double: return doubleValue;
+        default: throw cereal::Exception("JSON Parsing failed - value is not a number");
+    }
+}
+
+
+inline void InSituJSONInputArchive::Scalar::expect(const Type expectedType) const
+{
+    if (type != expectedType)
+    {
+        throw cereal::Exception("JSON Parsing failed - value is not of the expected type");
+    }
+}
+
+
+inline bool InSituJSONInputArchive::ReferenceCollector::Uint(const unsigned value)
+{
+    if (!frames.empty())
+    {
+        // Unique pointers have no id, and the id of a null pointer is zero
+        if (key == "id" && frames.back().name == "ptr_wrapper")
+        {
+            if (value & cereal::detail::msb_32bit)
+            {
+                references.definedPointerIds.insert(value & ~cereal::detail::msb_32bit);
+            }
+            else if (value != 0)
+            {
+                references.referencedPointerIds.insert(value);
+            }
+        }
+        else if (key == "polymorphic_id")
+        {
+            frames.back().polymorphicId = value;
+        }
+    }
+
+    key.clear();
+    return true;
+}
+
+
+inline bool InSituJSONInputArchive::ReferenceCollector::String(const char* pValue, const SizeType length, bool)
+{
+    if (!frames.empty() && key == "polymorphic_name")
+    {
+        frames.back().polymorphicName.emplace(pValue, length);
+    }
+
+    key.clear();
+    return true;
+}
+
+
+inline bool InSituJSONInputArchive::ReferenceCollector::EndObject(SizeType)
+{
+    const auto& frame = frames.back();
+
+    if (frame.polymorphicId && (*frame.polymorphicId & cereal::detail::msb_32bit) && frame.polymorphicName)
+    {
+        references.polymorphicNames.emplace(*frame.polymorphicId & ~cereal::detail::msb_32bit, *frame.polymorphicName);
+    }
+
+    frames.pop_back();
+    key.clear();
+    return true;
+}
+
+
+// Counterparts of the free functions cereal declares for JSONInputArchive, found through the archive by argument-dependent lookup
+
+template<typename T>
+void prologue(InSituJSONInputArchive&, const cereal::NameValuePair<T>&) { }
+
+template<typename T>
+void epilogue(InSituJSONInputArchive&, const cereal::NameValuePair<T>&) { }
+
+template<typename T>
+void prologue(InSituJSONInputArchive&, const cereal::DeferredData<T>&) { }
+
+template<typename T>
+void epilogue(InSituJSONInputArchive&, const cereal::DeferredData<T>&) { }
+
+template<typename T>
+void prologue(InSituJSONInputArchive&, const cereal::SizeTag<T>&) { }
+
+template<typename T>
+void epilogue(InSituJSONInputArchive&, const cereal::SizeTag<T>&) { }
+
+
+// Every other type, except minimal and arithmetic ones, lives in its own node
+template<typename T,
+         cereal::traits::EnableIf<!std::is_arithmetic_v<T>,
+                                  !cereal::traits::has_minimal_base_class_serialization<T, cereal::traits::has_minimal_input_serialization,
+                                                                                          InSituJSONInputArchive>::value,
+                                  !cereal::traits::has_minimal_input_serialization<T, InSituJSONInputArchive>::value> = cereal::traits::sfinae>
+void prologue(InSituJSONInputArchive& ar, const T&)
+{
+    ar.startNode();
+}
+
+template<typename T,
+         cereal::traits::EnableIf<!std::is_arithmetic_v<T>,
+                                  !cereal::traits::has_minimal_base_class_serialization<T, cereal::traits::has_minimal_input_serialization,
+                                                                                          InSituJSONInputArchive>::value,
+                                  !cereal::traits::has_minimal_input_serialization<T, InSituJSONInputArchive>::value> = cereal::traits::sfinae>
+void epilogue(InSituJSONInputArchive& ar, const T&)
+{
+    ar.finishNode();
+}
+
+inline void prologue(InSituJSONInputArchive&, const std::nullptr_t&) { }
+
+inline void epilogue(InSituJSONInputArchive&, const std::nullptr_t&) { }
+
+template<typename T, cereal::traits::EnableIf<std::is_arithmetic_v<T>> = cereal::traits::sfinae>
+void prologue(InSituJSONInputArchive&, const T&) { }
+
+template<typename T, cereal::traits::EnableIf<std::is_arithmetic_v<T>> = cereal::traits::sfinae>
+void epilogue(InSituJSONInputArchive&, const T&) { }
+
+template<typename CharT, typename Traits, typename Alloc>
+void prologue(InSituJSONInputArchive&, const std::basic_string<CharT, Traits, Alloc>&) { }
+
+template<typename CharT, typename Traits, typename Alloc>
+void epilogue(InSituJSONInputArchive&, const std::basic_string<CharT, Traits, Alloc>&) { }
+
+
+template<typename T>
+void CEREAL_LOAD_FUNCTION_NAME(InSituJSONInputArchive& ar, cereal::NameValuePair<T>& t)
+{
+    ar.setNextName(t.name);
+    ar(t.value);
+}
+
+template<typename T, cereal::traits::EnableIf<std::is_arithmetic_v<T>> = cereal::traits::sfinae>
+void CEREAL_LOAD_FUNCTION_NAME(InSituJSONInputArchive& ar, T& t)
+{
+    ar.loadValue(t);
+}
+
+template<typename CharT, typename Traits, typename Alloc>
+void CEREAL_LOAD_FUNCTION_NAME(InSituJSONInputArchive& ar, std::basic_string<CharT, Traits, Alloc>& str)
+{
+    ar.loadValue(str);
+}
+
+template<typename T>
+void CEREAL_LOAD_FUNCTION_NAME(InSituJSONInputArchive& ar, cereal::SizeTag<T>& st)
+{
+    ar.loadSize(st.size);
+}
+
+} // namespace GraphEx::Internal
+
+
+// The archive writing the same format, used by cereal to resolve minimal serialization functions
+namespace cereal::traits::detail
+{
+
+template<>
+struct get_output_from_input<GraphEx::Internal::InSituJSONInputArchive>
+{
+    using type = JSONOutputArchive;
+};
+
+} // namespace cereal::traits::detail
+
+
+CEREAL_REGISTER_ARCHIVE(GraphEx::Internal::InSituJSONInputArchive)
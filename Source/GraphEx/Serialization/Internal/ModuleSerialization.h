@@ -1,6 +1,8 @@
 #pragma once
 
 #include "SerializationMacros.h"
+#include "SerializationManager.h"
+#include "SerializationTemplates.h"
 
 
 namespace GraphEx
@@ -31,6 +33,20 @@ struct GRAPHEX_EXPORTABLE ModuleStateSerializerBase
 
     virtual void setStateBase(const std::shared_ptr<ModuleState>& pState) const = 0;
     virtual std::shared_ptr<ModuleState> getStateBase() const = 0;
+    virtual uint64_t getStateRevision() const = 0;
+
+    // A deep copy of the current state that shares nothing with the module, so that it can be serialized on another thread
+    virtual std::shared_ptr<ModuleState> snapshotState() const = 0;
+
+    // Non-polymorphic (de)serialization of the concrete state, so that the code doing it lives next to the module itself
+    // This is what allows the state of a plugin module to be carried over when its library is reloaded
+    virtual void saveState(OutputArchive& ar) const = 0;
+    virtual void loadState(InputArchive& ar) const = 0;
+    virtual void saveState(BinaryOutputArchive& ar) const = 0;
+    virtual void loadState(BinaryInputArchive& ar) const = 0;
+
+    // Only deserializes the state without handing it to the module, so it is safe to call on a worker thread
+    virtual std::shared_ptr<ModuleState> readState(BinaryInputArchive& ar) const = 0;
 };
 
 
@@ -52,6 +68,23 @@ struct ModuleStateSerializer final : ModuleStateSerializerBase
 private:
     void setStateBase(const std::shared_ptr<ModuleState>& pState) const override;
     std::shared_ptr<ModuleState> getStateBase() const override;
+    uint64_t getStateRevision() const override;
+    std::shared_ptr<ModuleState> snapshotState() const override;
+
+    void saveState(OutputArchive& ar) const override;
+    void loadState(InputArchive& ar) const override;
+    void saveState(BinaryOutputArchive& ar) const override;
+    void loadState(BinaryInputArchive& ar) const override;
+    std::shared_ptr<ModuleState> readState(BinaryInputArchive& ar) const override;
+
+    template<typename Archive>
+    void saveStateImpl(Archive& ar) const;
+
+    template<typename Archive>
+    void loadStateImpl(Archive& ar) const;
+
+    template<typename Archive>
+    std::shared_ptr<State> readStateImpl(Archive& ar) const;
 
     std::shared_ptr<Module> mpModule;
 };
@@ -81,6 +114,113 @@ std::shared_ptr<ModuleState> ModuleStateSerializer<ModuleT, StateT>::getStateBas
     return mpModule->getState();
 }
 
+
+template<typename ModuleT, typename StateT>
+uint64_t ModuleStateSerializer<ModuleT, StateT>::getStateRevision() const
+{
+    return mpModule->getStateRevision();
+}
+
+
+template<typename ModuleT, typename StateT>
+std::shared_ptr<ModuleState> ModuleStateSerializer<ModuleT, StateT>::snapshotState() const
+{
+    // States share mutable objects (scene objects, cameras) with their module, so a shallow copy would race with it. An in-memory
+    // binary round trip copies the whole object graph, shared pointers included, and is cheap compared to formatting and writing.
+    // Large binary data is immutable, the copy shares it instead, so that nothing is copied or written to a blob store here
+    std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+    auto pSnapshot = std::make_shared<State>();
+    auto& serializationManager = SerializationManager::get();
+    auto pPreviousSharedBlobs = serializationManager.exchangeSharedBlobs(std::make_shared<SerializationManager::SharedBlobs>());
+
+    try
+    {
+        {
+            BinaryOutputArchive ar(ss);
+            ar(*mpModule->getState());
+        }
+
+        serializationManager.finish();
+
+        {
+            BinaryInputArchive ar(ss);
+            ar(*pSnapshot);
+        }
+    }
+    catch (...)
+    {
+        serializationManager.exchangeSharedBlobs(std::move(pPreviousSharedBlobs));
+        serializationManager.finish();
+        throw;
+    }
+
+    serializationManager.exchangeSharedBlobs(std::move(pPreviousSharedBlobs));
+    serializationManager.finish();
+
+    return pSnapshot;
+}
+
+
+template<typename ModuleT, typename StateT>
+void ModuleStateSerializer<ModuleT, StateT>::saveState(OutputArchive& ar) const
+{
+    saveStateImpl(ar);
+}
+
+
+template<typename ModuleT, typename StateT>
+void ModuleStateSerializer<ModuleT, StateT>::loadState(InputArchive& ar) const
+{
+    loadStateImpl(ar);
+}
+
+
+template<typename ModuleT, typename StateT>
+void ModuleStateSerializer<ModuleT, StateT>::saveState(BinaryOutputArchive& ar) const
+{
+    saveStateImpl(ar);
+}
+
+
+template<typename ModuleT, typename StateT>
+void ModuleStateSerializer<ModuleT, StateT>::loadState(BinaryInputArchive& ar) const
+{
+    loadStateImpl(ar);
+}
+
+
+template<typename ModuleT, typename StateT>
+std::shared_ptr<ModuleState> ModuleStateSerializer<ModuleT, StateT>::readState(BinaryInputArchive& ar) const
+{
+    return readStateImpl(ar);
+}
+
+
+template<typename ModuleT, typename StateT>
+template<typename Archive>
+void ModuleStateSerializer<ModuleT, StateT>::saveStateImpl(Archive& ar) const
+{
+    ar(SerializeNamed<Archive>("state", *mpModule->getState()));
+}
+
+
+template<typename ModuleT, typename StateT>
+template<typename Archive>
+void ModuleStateSerializer<ModuleT, StateT>::loadStateImpl(Archive& ar) const
+{
+    mpModule->setState(readStateImpl(ar));
+}
+
+
+template<typename ModuleT, typename StateT>
+template<typename Archive>
+auto ModuleStateSerializer<ModuleT, StateT>::readStateImpl(Archive& ar) const -> std::shared_ptr<State>
+{
+    auto pState = std::make_shared<State>();
+    ar(SerializeNamed<Archive>("state", *pState));
+    return pState;
+}
+
 } // namespace GraphEx::Internal
 } // namespace GraphEx
 
@@ -0,0 +1,383 @@
+#include "SegmentedProjectFile.h"
+
+#include "../../Utils/ProjectFileStream.h"
+
+
+using namespace GraphEx::Internal;
+
+
+namespace
+{
+
+bool copyBytes(std::istream& is, std::ostream& os, uint64_t size)
+{
+    std::array<char, 64 * 1024> buffer{ };
+
+    while (size > 0)
+    {
+        const auto chunkSize = static_cast<std::streamsize>(std::min<uint64_t>(size, buffer.size()));
+
+        if (!is.read(buffer.data(), chunkSize) || !os.write(buffer.data(), chunkSize))
+        {
+            return false;
+        }
+
+        size -= static_cast<uint64_t>(chunkSize);
+    }
+
+    return true;
+}
+
+} // namespace
+
+
+bool SegmentedProjectFile::open(const std::filesystem::path& filePath)
+{
+    mFile = std::fstream(filePath, std::ios::in | std::ios::out | std::ios::binary);
+    mFilePath = filePath;
+    mSegments.clear();
+    mPendingSegments.clear();
+    mWrittenRevisions.clear();
+
+    if (!mFile.is_open() || !hasMagic(mFile))
+    {
+        mFile.close();
+        return false;
+    }
+
+    mFile.seekg(0, std::ios::end);
+    mEndOffset = static_cast<uint64_t>(mFile.tellg());
+
+    if (!readIndex())
+    {
+        mFile.close();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool SegmentedProjectFile::create(const std::filesystem::path& filePath)
+{
+    mFile = std::fstream(filePath, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+    mFilePath = filePath;
+    mSegments.clear();
+    mPendingSegments.clear();
+    mWrittenRevisions.clear();
+
+    if (!mFile.is_open())
+    {
+        return false;
+    }
+
+    mFile.write(MAGIC.data(), static_cast<std::streamsize>(MAGIC.size()));
+    mIndexSize = 0;
+
+    if (!writeHeader(0, 0))
+    {
+        mFile.close();
+        return false;
+    }
+
+    mEndOffset = HEADER_SIZE;
+    return commit();
+}
+
+
+bool SegmentedProjectFile::isOpen() const
+{
+    return mFile.is_open();
+}
+
+
+std::vector<std::string> SegmentedProjectFile::getSegmentKeys() const
+{
+    std::vector<std::string> result;
+    result.reserve(mSegments.size());
+
+    for (const auto& [ key, segment ] : mSegments)
+    {
+        result.push_back(key);
+    }
+
+    return result;
+}
+
+
+bool SegmentedProjectFile::hasSegment(const std::string& key) const
+{
+    return mSegments.find(key) != mSegments.end();
+}
+
+
+std::optional<std::string> SegmentedProjectFile::readSegment(const std::string& key)
+{
+    const auto it = mSegments.find(key);
+
+    if (!isOpen() || it == mSegments.end())
+    {
+        return std::nullopt;
+    }
+
+    std::string result(it->second.size, '\0');
+
+    mFile.clear();
+    mFile.seekg(static_cast<std::streamoff>(it->second.offset));
+
+    if (!mFile.read(result.data(), static_cast<std::streamsize>(result.size())))
+    {
+        mFile.clear();
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+
+bool SegmentedProjectFile::writeSegment(const std::string& key, const std::string_view data)
+{
+    if (!isOpen())
+    {
+        return false;
+    }
+
+    mFile.clear();
+    mFile.seekp(static_cast<std::streamoff>(mEndOffset));
+
+    if (!mFile.write(data.data(), static_cast<std::streamsize>(data.size())))
+    {
+        mFile.clear();
+        return false;
+    }
+
+    mPendingSegments[key] = Segment{ mEndOffset, data.size() };
+    mEndOffset += data.size();
+
+    return true;
+}
+
+
+bool SegmentedProjectFile::commit()
+{
+    if (!isOpen())
+    {
+        return false;
+    }
+
+    auto segments = mSegments;
+
+    for (const auto& [ key, segment ] : mPendingSegments)
+    {
+        segments[key] = segment;
+    }
+
+    std::ostringstream oss(std::ios::out | std::ios::binary);
+
+    {
+        BinaryOutputArchive ar(oss);
+        ar(segments);
+    }
+
+    const auto index = oss.str();
+    const auto indexOffset = mEndOffset;
+
+    mFile.clear();
+    mFile.seekp(static_cast<std::streamoff>(indexOffset));
+    mFile.write(index.data(), static_cast<std::streamsize>(index.size()));
+
+    // Everything the new index refers to must be written before the header points at it
+    if (!mFile.flush() || !writeHeader(indexOffset, index.size()))
+    {
+        Falcor::logError("Failed to write segmented project file '{}'.", mFilePath.string());
+        mFile.clear();
+        return false;
+    }
+
+    mSegments = std::move(segments);
+    mPendingSegments.clear();
+    mEndOffset = indexOffset + index.size();
+    mIndexSize = index.size();
+
+    if (getStaleSize() >= COMPACTION_MIN_STALE_SIZE && getStaleSize() > getLiveSize() && !compact())
+    {
+        Falcor::logWarning("Could not compact segmented project file '{}', it keeps growing until the next attempt.", mFilePath.string());
+    }
+
+    return true;
+}
+
+
+std::optional<uint64_t> SegmentedProjectFile::getWrittenRevision(const std::string& key) const
+{
+    const auto it = mWrittenRevisions.find(key);
+    return it != mWrittenRevisions.end() ? std::optional{ it->second } : std::nullopt;
+}
+
+
+void SegmentedProjectFile::setWrittenRevision(const std::string& key, const uint64_t revision)
+{
+    mWrittenRevisions[key] = revision;
+}
+
+
+uint64_t SegmentedProjectFile::getLiveSize() const
+{
+    uint64_t result = 0;
+
+    for (const auto& [ key, segment ] : mSegments)
+    {
+        result += segment.size;
+    }
+
+    return result;
+}
+
+
+uint64_t SegmentedProjectFile::getStaleSize() const
+{
+    return mEndOffset - HEADER_SIZE - getLiveSize() - mIndexSize;
+}
+
+
+bool SegmentedProjectFile::hasMagic(std::istream& is)
+{
+    std::array<char, MAGIC.size()> header{ };
+
+    const auto start = is.tellg();
+    is.read(header.data(), static_cast<std::streamsize>(header.size()));
+    const auto matches = is.gcount() == static_cast<std::streamsize>(header.size())
+                         && std::string_view(header.data(), header.size()) == MAGIC;
+
+    is.clear();
+    is.seekg(start);
+
+    return matches;
+}
+
+
+bool SegmentedProjectFile::readIndex()
+{
+    mFile.clear();
+    mFile.seekg(static_cast<std::streamoff>(MAGIC.size()));
+
+    const auto indexOffset = readUInt64(mFile);
+    const auto indexSize = readUInt64(mFile);
+
+    if (!indexOffset || !indexSize || *indexOffset < HEADER_SIZE || *indexOffset + *indexSize > mEndOffset)
+    {
+        return false;
+    }
+
+    std::string index(*indexSize, '\0');
+    mFile.seekg(static_cast<std::streamoff>(*indexOffset));
+
+    if (!mFile.read(index.data(), static_cast<std::streamsize>(index.size())))
+    {
+        return false;
+    }
+
+    SegmentDictionary segments;
+
+    try
+    {
+        std::istringstream iss(index, std::ios::in | std::ios::binary);
+        BinaryInputArchive ar(iss);
+        ar(segments);
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    for (const auto& [ key, segment ] : segments)
+    {
+        if (segment.offset < HEADER_SIZE || segment.offset + segment.size > *indexOffset)
+        {
+            return false;
+        }
+    }
+
+    mSegments = std::move(segments);
+    mIndexSize = *indexSize;
+
+    return true;
+}
+
+
+bool SegmentedProjectFile::writeHeader(const uint64_t indexOffset, const uint64_t indexSize)
+{
+    mFile.clear();
+    mFile.seekp(static_cast<std::streamoff>(MAGIC.size()));
+    writeUInt64(mFile, indexOffset);
+    writeUInt64(mFile, indexSize);
+
+    return static_cast<bool>(mFile.flush());
+}
+
+
+bool SegmentedProjectFile::compact()
+{
+    SegmentDictionary segments;
+
+    {
+        ProjectFileWriter writer(mFilePath);
+
+        if (!writer.isOpen())
+        {
+            return false;
+        }
+
+        auto& os = writer.getStream();
+        os.write(MAGIC.data(), static_cast<std::streamsize>(MAGIC.size()));
+        writeUInt64(os, 0);
+        writeUInt64(os, 0);
+
+        auto offset = HEADER_SIZE;
+
+        for (const auto& [ key, segment ] : mSegments)
+        {
+            mFile.clear();
+            mFile.seekg(static_cast<std::streamoff>(segment.offset));
+
+            if (!copyBytes(mFile, os, segment.size))
+            {
+                mFile.clear();
+                return false;
+            }
+
+            segments[key] = Segment{ offset, segment.size };
+            offset += segment.size;
+        }
+
+        std::ostringstream oss(std::ios::out | std::ios::binary);
+
+        {
+            BinaryOutputArchive ar(oss);
+            ar(segments);
+        }
+
+        const auto index = oss.str();
+        os.write(index.data(), static_cast<std::streamsize>(index.size()));
+        os.seekp(static_cast<std::streamoff>(MAGIC.size()));
+        writeUInt64(os, offset);
+        writeUInt64(os, index.size());
+
+        // The file cannot be replaced while we hold it open on every platform
+        mFile.close();
+
+        if (!writer.commit())
+        {
+            auto writtenRevisions = std::move(mWrittenRevisions);
+            open(mFilePath);
+            mWrittenRevisions = std::move(writtenRevisions);
+            return false;
+        }
+    }
+
+    auto writtenRevisions = std::move(mWrittenRevisions);
+    const auto reopened = open(mFilePath);
+    mWrittenRevisions = std::move(writtenRevisions);
+
+    return reopened;
+}
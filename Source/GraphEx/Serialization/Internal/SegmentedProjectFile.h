@@ -0,0 +1,89 @@
+#pragma once
+
+#include "SerializationMacros.h"
+#include "SerializationTemplates.h"
+
+
+namespace GraphEx::Internal
+{
+
+// A project file made of independently replaceable segments, one per key (module). Rewriting a segment appends its new content
+// and a new index to the end of the file, then points the fixed-size header at that index, so the cost of a save is proportional to
+// what changed instead of to the whole project. The previous index stays intact until the header is updated, so an interrupted save
+// leaves the last committed version readable. Stale bytes are dropped by rewriting the file once they outweigh the live content.
+//
+// Layout: [ MAGIC | index offset (u64) | index size (u64) ] [ segment ]* [ index ] ... [ segment ]* [ index ]
+struct GRAPHEX_EXPORTABLE SegmentedProjectFile
+{
+    static constexpr std::string_view MAGIC{ "GXPROJS", 8 };  // Including the terminating zero
+    static constexpr std::string_view EXTENSION = ".gxautosave";
+    static constexpr uint64_t HEADER_SIZE = MAGIC.size() + 2 * sizeof(uint64_t);
+    static constexpr uint64_t COMPACTION_MIN_STALE_SIZE = 4 * 1024 * 1024;
+
+    SegmentedProjectFile() = default;
+
+    MAKE_MOVE_ONLY(SegmentedProjectFile)
+
+    // Opens an existing segmented file for reading and further appending
+    bool open(const std::filesystem::path& filePath);
+    // Creates an empty segmented file, replacing whatever was at the given path
+    bool create(const std::filesystem::path& filePath);
+
+    bool isOpen() const;
+
+    std::vector<std::string> getSegmentKeys() const;
+    bool hasSegment(const std::string& key) const;
+    std::optional<std::string> readSegment(const std::string& key);
+
+    // Appends the new content of the segment, it only replaces the previous one once committed
+    bool writeSegment(const std::string& key, std::string_view data);
+    bool commit();
+
+    // Revision of the content last written for the key during the lifetime of this object
+    std::optional<uint64_t> getWrittenRevision(const std::string& key) const;
+    void setWrittenRevision(const std::string& key, uint64_t revision);
+
+    uint64_t getLiveSize() const;
+    uint64_t getStaleSize() const;
+
+    static bool hasMagic(std::istream& is);
+
+private:
+    struct Segment
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+
+        template<typename Archive>
+        void serialize(Archive& ar);
+    };
+
+    using SegmentDictionary = std::map<std::string, Segment>;
+
+    bool readIndex();
+    bool writeHeader(uint64_t indexOffset, uint64_t indexSize);
+    bool compact();
+
+    std::filesystem::path mFilePath;
+    std::fstream mFile;
+
+    SegmentDictionary mSegments;           // Committed segments, as referenced by the index in the header
+    SegmentDictionary mPendingSegments;    // Appended segments, waiting for the next commit
+    std::unordered_map<std::string, uint64_t> mWrittenRevisions;
+
+    uint64_t mEndOffset = 0;
+    uint64_t mIndexSize = 0;
+
+public:
+    DEFAULT_CONST_GETREF_DEFINITION(FilePath, mFilePath)
+};
+
+
+template<typename Archive>
+void SegmentedProjectFile::Segment::serialize(Archive& ar)
+{
+    ar(GRAPHEX_SERIALIZE_WITH_NAME(offset));
+    ar(GRAPHEX_SERIALIZE_WITH_NAME(size));
+}
+
+} // namespace GraphEx::Internal
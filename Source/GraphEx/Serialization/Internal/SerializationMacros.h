@@ -2,6 +2,9 @@
 
 #include <cereal/cereal.hpp>
 #include <cereal/archives/json.hpp>
+#include <cereal/archives/portable_binary.hpp>
+
+#include "InSituJSONArchive.h"
 
 #include <cereal/types/array.hpp>
 #include <cereal/types/atomic.hpp>
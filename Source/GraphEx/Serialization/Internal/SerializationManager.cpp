@@ -4,6 +4,10 @@
 using namespace GraphEx::Internal;
 
 
+std::mutex SerializationManager::sDeferredWarningsMutex;
+std::vector<std::string> SerializationManager::sDeferredWarnings;
+
+
 std::optional<GraphEx::InputArchive> SerializationManager::beginLoad(std::istream& is)
 {
     try
@@ -18,6 +22,25 @@ std::optional<GraphEx::InputArchive> SerializationManager::beginLoad(std::istrea
 }
 
 
+std::optional<GraphEx::InputArchive> SerializationManager::beginLoad(ProjectFileReader& reader)
+{
+    if (!reader.isOpen())
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        return { reader.getData() };
+    }
+    catch (...)
+    {
+        // Most possibly encountered JSON syntax error
+        return std::nullopt;
+    }
+}
+
+
 std::optional<GraphEx::OutputArchive> SerializationManager::beginSave(std::ostream& os)
 {
     try
@@ -32,6 +55,74 @@ std::optional<GraphEx::OutputArchive> SerializationManager::beginSave(std::ostre
 }
 
 
+std::optional<GraphEx::BinaryInputArchive> SerializationManager::beginBinaryLoad(std::istream& is)
+{
+    if (detectProjectFormat(is) != ProjectFormat::Binary)
+    {
+        return std::nullopt;
+    }
+
+    is.ignore(static_cast<std::streamsize>(BINARY_PROJECT_MAGIC.size()));
+
+    try
+    {
+        return { is };
+    }
+    catch (...)
+    {
+        // Stream ended before the endianness tag of the archive
+        return std::nullopt;
+    }
+}
+
+
+std::optional<GraphEx::BinaryOutputArchive> SerializationManager::beginBinarySave(std::ostream& os)
+{
+    os.write(BINARY_PROJECT_MAGIC.data(), static_cast<std::streamsize>(BINARY_PROJECT_MAGIC.size()));
+
+    if (!os)
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        return { os };
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+}
+
+
+ProjectFormat SerializationManager::getProjectFormat(const std::filesystem::path& filePath)
+{
+    return filePath.extension() == BINARY_PROJECT_EXTENSION ? ProjectFormat::Binary : ProjectFormat::Json;
+}
+
+
+ProjectFormat SerializationManager::detectProjectFormat(std::istream& is)
+{
+    std::array<char, BINARY_PROJECT_MAGIC.size()> header{ };
+
+    const auto start = is.tellg();
+    is.read(header.data(), static_cast<std::streamsize>(header.size()));
+    const auto matches = is.gcount() == static_cast<std::streamsize>(header.size())
+                         && std::string_view(header.data(), header.size()) == BINARY_PROJECT_MAGIC;
+
+    is.clear();
+    is.seekg(start);
+
+    if (matches)
+    {
+        return ProjectFormat::Binary;
+    }
+
+    return SegmentedProjectFile::hasMagic(is) ? ProjectFormat::Segmented : ProjectFormat::Json;
+}
+
+
 void SerializationManager::finish()
 {
     while (!mInvalidityListStack.empty())
@@ -72,6 +163,36 @@ void SerializationManager::releaseTrackedRefs()
 }
 
 
+auto SerializationManager::exchangeTrackedRefs(TrackedRefs trackedRefs) -> TrackedRefs
+{
+    return std::exchange(mTrackedRefs, std::move(trackedRefs));
+}
+
+
+void SerializationManager::setBlobStore(std::shared_ptr<BlobStore> pBlobStore)
+{
+    mpBlobStore = std::move(pBlobStore);
+}
+
+
+const std::shared_ptr<BlobStore>& SerializationManager::getBlobStore() const
+{
+    return mpBlobStore;
+}
+
+
+auto SerializationManager::exchangeSharedBlobs(std::shared_ptr<SharedBlobs> pSharedBlobs) -> std::shared_ptr<SharedBlobs>
+{
+    return std::exchange(mpSharedBlobs, std::move(pSharedBlobs));
+}
+
+
+auto SerializationManager::getSharedBlobs() const -> const std::shared_ptr<SharedBlobs>&
+{
+    return mpSharedBlobs;
+}
+
+
 void SerializationManager::pushInvalidityList()
 {
     mInvalidityListStack.emplace(std::make_shared<InvalidityList>());
@@ -98,8 +219,23 @@ void SerializationManager::logInvalidity(const InvalidityMessage& message)
 }
 
 
+void SerializationManager::deferWarning(std::string message)
+{
+    std::lock_guard lock(sDeferredWarningsMutex);
+    sDeferredWarnings.push_back(std::move(message));
+}
+
+
+std::vector<std::string> SerializationManager::takeDeferredWarnings()
+{
+    std::lock_guard lock(sDeferredWarningsMutex);
+    return std::exchange(sDeferredWarnings, { });
+}
+
+
 SerializationManager& SerializationManager::get()
 {
-    static SerializationManager instance;
+    // Every thread gets its own, so that the invalidity lists and tracked references of concurrent (de)serializations never mix
+    static thread_local SerializationManager instance;
     return instance;
 }
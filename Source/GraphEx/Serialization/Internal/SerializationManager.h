@@ -3,18 +3,58 @@
 #include "SerializationMacros.h"
 #include "SerializationTemplates.h"
 
+#include "SegmentedProjectFile.h"
+
+#include "../../Utils/ProjectFileStream.h"
+
+
+namespace GraphEx
+{
+
+class BlobData;
+
+}  // namespace GraphEx
+
 
 namespace GraphEx::Internal
 {
 
+struct BlobStore;
+
+
+enum class ProjectFormat
+{
+    Json,
+    Binary,
+    Segmented
+};
+
+
 struct GRAPHEX_EXPORTABLE SerializationManager
 {
     using InvalidityMessage = std::string;
     using InvalidityList = std::vector<InvalidityMessage>;
+    using TrackedRefs = std::unordered_map<uintptr_t, Falcor::ref<Falcor::Object>>;
+    using SharedBlobs = std::vector<BlobData>;
+
+    static constexpr std::string_view BINARY_PROJECT_MAGIC{ "GXPROJB", 8 };  // Including the terminating zero
+    static constexpr std::string_view BINARY_PROJECT_EXTENSION = ".gxprojb";
 
     std::optional<InputArchive> beginLoad(std::istream& is);
     std::optional<OutputArchive> beginSave(std::ostream& os);
 
+    // Parses the mapped file in place, the reader must outlive the archive
+    std::optional<InputArchive> beginLoad(ProjectFileReader& reader);
+
+    // Binary streams are prefixed with BINARY_PROJECT_MAGIC, so make sure to open them in binary mode
+    std::optional<BinaryInputArchive> beginBinaryLoad(std::istream& is);
+    std::optional<BinaryOutputArchive> beginBinarySave(std::ostream& os);
+
+    // For saving, the format is chosen by the extension of the file
+    static ProjectFormat getProjectFormat(const std::filesystem::path& filePath);
+    // For loading, the format is recognized by the header of the stream regardless of the extension. Does not consume the stream
+    static ProjectFormat detectProjectFormat(std::istream& is);
+
     void finish();
 
     void addTrackedFalcorRef(uintptr_t address, Falcor::ref<Falcor::Object> ref);
@@ -22,16 +62,37 @@ struct GRAPHEX_EXPORTABLE SerializationManager
     Falcor::ref<Falcor::Object> getTrackedFalcorRef(uintptr_t address) const;
 
     void releaseTrackedRefs();
+    // Sets the tracked references aside for a nested (de)serialization, returns the previous ones
+    TrackedRefs exchangeTrackedRefs(TrackedRefs trackedRefs);
+
+    // Large binary data (BlobData) of the project is written to and read from this store, inline when there is none. Kept across finish()
+    void setBlobStore(std::shared_ptr<BlobStore> pBlobStore);
+    const std::shared_ptr<BlobStore>& getBlobStore() const;
+
+    // While set, blobs are neither written to the blob store nor copied, but shared by index with the archive reading them back. For
+    // copies of states within the process only. Kept across finish(), returns the previous ones
+    std::shared_ptr<SharedBlobs> exchangeSharedBlobs(std::shared_ptr<SharedBlobs> pSharedBlobs);
+    const std::shared_ptr<SharedBlobs>& getSharedBlobs() const;
 
     void pushInvalidityList();
     std::shared_ptr<InvalidityList> popInvalidityList();
     void logInvalidity(const InvalidityMessage& message);
 
+    // Warnings for the user found while loading, possibly on a worker thread. Shared by all threads, the main thread shows them once the
+    // loaded states were applied
+    static void deferWarning(std::string message);
+    static std::vector<std::string> takeDeferredWarnings();
+
     static SerializationManager& get();
 
 private:
     std::stack<std::shared_ptr<InvalidityList>> mInvalidityListStack;
-    std::unordered_map<uintptr_t, Falcor::ref<Falcor::Object>> mTrackedRefs;
+    TrackedRefs mTrackedRefs;
+    std::shared_ptr<BlobStore> mpBlobStore;
+    std::shared_ptr<SharedBlobs> mpSharedBlobs;
+
+    static std::mutex sDeferredWarningsMutex;
+    static std::vector<std::string> sDeferredWarnings;
 };
 
 }  // namespace GraphEx::Internal
@@ -14,9 +14,13 @@ using SerializeBase = cereal::base_class<T>;
 template<typename T>
 using SerializeVirtualBase = cereal::virtual_base_class<T>;
 
-using InputArchive = cereal::JSONInputArchive;
+using InputArchive = Internal::InSituJSONInputArchive;  // Reads the format of cereal::JSONOutputArchive without building a DOM
 using OutputArchive = cereal::JSONOutputArchive;
 
+// Compact archive family for large projects, written with a fixed endianness so that files are portable between machines
+using BinaryInputArchive = cereal::PortableBinaryInputArchive;
+using BinaryOutputArchive = cereal::PortableBinaryOutputArchive;
+
 
 template<typename Archive, typename T>
 auto SerializeNamed(const char* name, T&& value) -> decltype(auto)
@@ -42,17 +46,82 @@ auto LoadNamed(const char* name, T&& value) -> decltype(auto)
 template<typename Archive>
 constexpr bool IsOutputArchive()
 {
-    return std::is_same_v<OutputArchive, Archive>;
+    return std::is_base_of_v<cereal::detail::OutputArchiveBase, Archive>;
 }
 
 
 template<typename Archive>
 constexpr bool IsInputArchive()
 {
-    return std::is_same_v<InputArchive, Archive>;
+    return std::is_base_of_v<cereal::detail::InputArchiveBase, Archive>;
+}
+
+
+template<typename Archive>
+constexpr bool IsTextArchive()
+{
+    return cereal::traits::is_text_archive<Archive>::value;
+}
+
+
+namespace Internal
+{
+
+template<typename Archive, typename T>
+bool HasPolymorphicBinding(const T&)
+{
+    return true;
+}
+
+
+// Tells in advance whether cereal would throw UNREGISTERED_POLYMORPHIC_TYPE when saving the pointer
+template<typename Archive, typename T>
+bool HasPolymorphicBinding(const std::shared_ptr<T>& ptr)
+{
+    if constexpr (std::is_polymorphic_v<T>)
+    {
+        if (!ptr || typeid(*ptr) == typeid(T))
+        {
+            return true;
+        }
+
+        const auto& bindingMap = cereal::detail::StaticObject<cereal::detail::OutputBindingMap<Archive>>::getInstance().map;
+        return bindingMap.find(std::type_index(typeid(*ptr))) != bindingMap.end();
+    }
+    else
+    {
+        return true;
+    }
 }
 
 
+// Saved exactly like the sequence itself, but reports the number of elements written after each one
+template<typename SequenceT>
+struct ProgressReportingSequence
+{
+    const SequenceT& sequence;
+    const std::function<void(size_t)>& onElementSaved;
+
+    template<typename Archive>
+    void save(Archive& ar) const
+    {
+        ar(cereal::make_size_tag(static_cast<cereal::size_type>(sequence.size())));
+
+        for (size_t i = 0; i < sequence.size(); ++i)
+        {
+            ar(sequence[i]);
+
+            if (onElementSaved)
+            {
+                onElementSaved(i + 1);
+            }
+        }
+    }
+};
+
+} // namespace Internal
+
+
 template<typename UnsafeWrappedT>
 struct PolymorphicSafeAnchor
 {
@@ -85,19 +154,46 @@ template<typename UnsafeWrappedT>
 template<typename Archive>
 void PolymorphicSafeAnchor<UnsafeWrappedT>::serialize(Archive& ar)
 {
-    try
+    if constexpr (!IsTextArchive<Archive>())
     {
-        ar(SerializeNamed<Archive>("polymorphic_safe_anchor", mAnchor));
-        mSuccess = true;
+        // Binary archives have no nodes to close, so an interrupted value cannot be skipped. Instead, we record whether the value is
+        // written at all. A value that turns out to be unreadable on load (e.g. its type is not registered in this build) is fatal
+        auto valid = true;
+
+        if constexpr (IsOutputArchive<Archive>())
+        {
+            valid = Internal::HasPolymorphicBinding<Archive>(mAnchor);
+
+            if (!valid)
+            {
+                Falcor::logWarning("Could not safely serialize an object: its polymorphic type was not registered.");
+            }
+        }
+
+        ar(valid);
+
+        if (valid)
+        {
+            ar(mAnchor);
+            mSuccess = true;
+        }
     }
-    catch (cereal::Exception& e)
+    else
     {
-        Falcor::logWarning("Could not safely serialize an object: " + std::string(e.what()));
-
-        // At least one node was interrupted, so calling this manually won't mess too much with the internal structure of the archive
-        // If something went wrong inside the safe anchor, aka. the reason why we caught is not an UNREGISTERED_POLYMORPHIC_TYPE, we
-        // are dealing with a corrupt archive
-        ar.finishNode();
+        try
+        {
+            ar(SerializeNamed<Archive>("polymorphic_safe_anchor", mAnchor));
+            mSuccess = true;
+        }
+        catch (cereal::Exception& e)
+        {
+            Falcor::logWarning("Could not safely serialize an object: " + std::string(e.what()));
+
+            // At least one node was interrupted, so calling this manually won't mess too much with the internal structure of the archive
+            // If something went wrong inside the safe anchor, aka. the reason why we caught is not an UNREGISTERED_POLYMORPHIC_TYPE, we
+            // are dealing with a corrupt archive
+            ar.finishNode();
+        }
     }
 }
 
@@ -115,6 +211,11 @@ struct TaggedPolymorphicSafeAnchor : PolymorphicSafeAnchor<UnsafeWrappedT>
     template<typename Archive>
     void serialize(Archive& ar);
 
+    // Reads the tag, then the value only if the predicate accepts the tag, the rest of the node is left unread otherwise. Must be called
+    // within the node of the anchor, returns whether the value was read
+    template<typename Archive, typename Predicate>
+    bool loadIf(Archive& ar, const Predicate& predicate);
+
 private:
     TagT mTag;
 
@@ -131,4 +232,20 @@ void TaggedPolymorphicSafeAnchor<TagT, UnsafeWrappedT>::serialize(Archive& ar)
     PolymorphicSafeAnchor<UnsafeWrappedT>::serialize(ar);
 }
 
+
+template<typename TagT, typename UnsafeWrappedT>
+template<typename Archive, typename Predicate>
+bool TaggedPolymorphicSafeAnchor<TagT, UnsafeWrappedT>::loadIf(Archive& ar, const Predicate& predicate)
+{
+    ar(SerializeNamed<Archive>("polymorphic_safe_anchor_tag", mTag));
+
+    if (!predicate(mTag))
+    {
+        return false;
+    }
+
+    PolymorphicSafeAnchor<UnsafeWrappedT>::serialize(ar);
+    return true;
+}
+
 } // namespace GraphEx
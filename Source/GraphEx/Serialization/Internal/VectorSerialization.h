@@ -1,6 +1,129 @@
 #pragma once
 
 #include "SerializationMacros.h"
+#include "SerializationTemplates.h"
+
+
+namespace GraphEx::Internal
+{
+
+template<typename T>
+constexpr bool IsBulkSerializableScalar = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+
+// Sequences of these are stored as a single block of memory instead of one node per component
+template<typename T>
+struct BulkSerializableElement
+{
+    using Scalar = T;
+    static constexpr bool value = IsBulkSerializableScalar<T>;
+};
+
+
+template<typename T, int N>
+struct BulkSerializableElement<Falcor::math::vector<T, N>>
+{
+    using Scalar = T;
+    static constexpr bool value = IsBulkSerializableScalar<T> && std::is_trivially_copyable_v<Falcor::math::vector<T, N>>
+                                  && sizeof(Falcor::math::vector<T, N>) == N * sizeof(T);
+};
+
+
+template<typename T, int R, int C>
+struct BulkSerializableElement<Falcor::math::matrix<T, R, C>>
+{
+    using Scalar = T;
+    static constexpr bool value = IsBulkSerializableScalar<T> && std::is_trivially_copyable_v<Falcor::math::matrix<T, R, C>>
+                                  && sizeof(Falcor::math::matrix<T, R, C>) == R * C * sizeof(T);
+};
+
+
+template<typename T>
+constexpr bool IsBulkSerializableElement = BulkSerializableElement<T>::value;
+
+
+// Text archives get a base64 blob tagged with the byte order of the machine that wrote it, binary archives get a raw block. The
+// portable binary archive takes care of the byte order itself
+template<typename Archive, typename T, typename A>
+void saveBulkVector(Archive& ar, const std::vector<T, A>& vector)
+{
+    using Scalar = typename BulkSerializableElement<T>::Scalar;
+    const auto byteCount = vector.size() * sizeof(T);
+
+    if constexpr (IsTextArchive<Archive>())
+    {
+        ar(cereal::make_nvp("littleEndian", cereal::portable_binary_detail::is_little_endian()));
+        ar(cereal::make_nvp("size", static_cast<cereal::size_type>(vector.size())));
+        ar(cereal::make_nvp("data", cereal::base64::encode(reinterpret_cast<const unsigned char*>(vector.data()), byteCount)));
+    }
+    else
+    {
+        ar(cereal::make_size_tag(static_cast<cereal::size_type>(vector.size())));
+        ar(cereal::binary_data(reinterpret_cast<const Scalar*>(vector.data()), byteCount));
+    }
+}
+
+
+template<typename Archive, typename T, typename A>
+void loadBulkVector(Archive& ar, std::vector<T, A>& vector)
+{
+    using Scalar = typename BulkSerializableElement<T>::Scalar;
+
+    if constexpr (IsTextArchive<Archive>())
+    {
+        // Older project files have a node for every element
+        if (!ar.getNodeName())
+        {
+            cereal::size_type size;
+            ar(cereal::make_size_tag(size));
+            vector.resize(static_cast<size_t>(size));
+
+            for (auto& element : vector)
+            {
+                ar(element);
+            }
+
+            return;
+        }
+
+        bool littleEndian;
+        cereal::size_type size;
+        std::string encoded;
+
+        ar(cereal::make_nvp("littleEndian", littleEndian));
+        ar(cereal::make_nvp("size", size));
+        ar(cereal::make_nvp("data", encoded));
+
+        const auto decoded = cereal::base64::decode(encoded);
+
+        if (decoded.size() != static_cast<size_t>(size) * sizeof(T))
+        {
+            throw cereal::Exception("Decoded bulk array size does not match specified size");
+        }
+
+        vector.resize(static_cast<size_t>(size));
+        std::memcpy(vector.data(), decoded.data(), decoded.size());
+
+        if (littleEndian != cereal::portable_binary_detail::is_little_endian())
+        {
+            auto* pBytes = reinterpret_cast<std::uint8_t*>(vector.data());
+
+            for (size_t i = 0; i < decoded.size(); i += sizeof(Scalar))
+            {
+                cereal::portable_binary_detail::swap_bytes<sizeof(Scalar)>(pBytes + i);
+            }
+        }
+    }
+    else
+    {
+        cereal::size_type size;
+        ar(cereal::make_size_tag(size));
+        vector.resize(static_cast<size_t>(size));
+        ar(cereal::binary_data(reinterpret_cast<Scalar*>(vector.data()), static_cast<size_t>(size) * sizeof(T)));
+    }
+}
+
+} // namespace GraphEx::Internal
 
 
 GRAPHEX_SERIALIZATION_SPECIFY_BEGIN
@@ -14,4 +137,63 @@ void GRAPHEX_SERIALIZATION_FUNCTION_NAME(Archive& ar, Falcor::math::vector<T, N>
     }
 }
 
+
+template<typename Archive, typename T, int R, int C>
+void GRAPHEX_SERIALIZATION_FUNCTION_NAME(Archive& ar, Falcor::math::matrix<T, R, C>& matrix)
+{
+    for (int r = 0; r < R; ++r)
+    {
+        ar(matrix[r]);
+    }
+}
+
+
+template<typename Archive, typename T, int N, typename A>
+auto GRAPHEX_SERIALIZATION_SAVE_FUNCTION_NAME(Archive& ar, const std::vector<Falcor::math::vector<T, N>, A>& vector)
+    -> std::enable_if_t<GraphEx::Internal::IsBulkSerializableElement<Falcor::math::vector<T, N>>>
+{
+    GraphEx::Internal::saveBulkVector(ar, vector);
+}
+
+
+template<typename Archive, typename T, int N, typename A>
+auto GRAPHEX_SERIALIZATION_LOAD_FUNCTION_NAME(Archive& ar, std::vector<Falcor::math::vector<T, N>, A>& vector)
+    -> std::enable_if_t<GraphEx::Internal::IsBulkSerializableElement<Falcor::math::vector<T, N>>>
+{
+    GraphEx::Internal::loadBulkVector(ar, vector);
+}
+
+
+template<typename Archive, typename T, int R, int C, typename A>
+auto GRAPHEX_SERIALIZATION_SAVE_FUNCTION_NAME(Archive& ar, const std::vector<Falcor::math::matrix<T, R, C>, A>& vector)
+    -> std::enable_if_t<GraphEx::Internal::IsBulkSerializableElement<Falcor::math::matrix<T, R, C>>>
+{
+    GraphEx::Internal::saveBulkVector(ar, vector);
+}
+
+
+template<typename Archive, typename T, int R, int C, typename A>
+auto GRAPHEX_SERIALIZATION_LOAD_FUNCTION_NAME(Archive& ar, std::vector<Falcor::math::matrix<T, R, C>, A>& vector)
+    -> std::enable_if_t<GraphEx::Internal::IsBulkSerializableElement<Falcor::math::matrix<T, R, C>>>
+{
+    GraphEx::Internal::loadBulkVector(ar, vector);
+}
+
+
+// Binary archives already store vectors of scalars as a raw block, only the text archives need these
+template<typename T, typename A>
+auto GRAPHEX_SERIALIZATION_SAVE_FUNCTION_NAME(GraphEx::OutputArchive& ar, const std::vector<T, A>& vector)
+    -> std::enable_if_t<GraphEx::Internal::IsBulkSerializableScalar<T>>
+{
+    GraphEx::Internal::saveBulkVector(ar, vector);
+}
+
+
+template<typename T, typename A>
+auto GRAPHEX_SERIALIZATION_LOAD_FUNCTION_NAME(GraphEx::InputArchive& ar, std::vector<T, A>& vector)
+    -> std::enable_if_t<GraphEx::Internal::IsBulkSerializableScalar<T>>
+{
+    GraphEx::Internal::loadBulkVector(ar, vector);
+}
+
 GRAPHEX_SERIALIZATION_SPECIFY_END
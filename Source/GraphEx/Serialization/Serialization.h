@@ -9,7 +9,9 @@
 
 #include "Internal/SerializationMacros.h"
 #include "Internal/SerializationManager.h"
+#include "Internal/SegmentedProjectFile.h"
 #include "Internal/SerializationTemplates.h"
+#include "Internal/BlobStore.h"
 
 #include "Internal/ModuleSerialization.h"
 #include "Internal/ReferenceSerialization.h"
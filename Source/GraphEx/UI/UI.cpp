@@ -3,6 +3,7 @@
 #include "../Core/SceneManager.h"
 #include "../Core/CameraManager.h"
 #include "../Core/RenderManager.h"
+#include "../Utils/ProgramWrapper.h"
 
 #include "UIHelpers.h"
 
@@ -32,6 +33,11 @@ void UI::render(Falcor::Gui* pGui)
 
     renderSceneCameraManagerWindow(pGui, sceneManager, cameraManager);
     renderRenderManagerWindow(pGui, renderManager);
+
+    if (mShowGpuTimes)
+    {
+        renderGpuTimesWindow(pGui);
+    }
 }
 
 
@@ -56,7 +62,7 @@ void UI::renderMainMenuBar(Falcor::Gui* pGui)
             if (fileMenu.item("Save Project As..."))
             {
                 if (std::filesystem::path path;
-                    Falcor::saveFileDialog({ { "gxproj", "GraphEx Project" } }, path))
+                    Falcor::saveFileDialog({ { "gxproj", "GraphEx Project" }, { "gxprojb", "GraphEx Binary Project" } }, path))
                 {
                     mpApp->saveProjectAs(path);
                 }
@@ -65,12 +71,19 @@ void UI::renderMainMenuBar(Falcor::Gui* pGui)
             if (fileMenu.item("Open Project..."))
             {
                 if (std::filesystem::path path;
-                    Falcor::openFileDialog({ { "gxproj", "GraphEx Project" } }, path))
+                    Falcor::openFileDialog({ { "gxproj", "GraphEx Project" }, { "gxprojb", "GraphEx Binary Project" },
+                                             { "gxautosave", "GraphEx Autosave" } }, path))
                 {
                     mpApp->loadProject(path);
                 }
             }
 
+            // Applies to subsequent saves, loading recognizes compressed files by themselves
+            if (auto compress = mpApp->getCompressProjectFiles(); fileMenu.item("Compress Project Files", compress))
+            {
+                mpApp->setCompressProjectFiles(compress);
+            }
+
             fileMenu.separator();
 
             if (fileMenu.item("Exit"))
@@ -79,10 +92,36 @@ void UI::renderMainMenuBar(Falcor::Gui* pGui)
             }
         }
 
+        // Draw "Edit" menu
+        {
+            auto editMenu = mainMenu.dropdown("Edit");
+
+            if (mpApp->getUndoHistory().canUndo() && editMenu.item("Undo", "Ctrl+Z"))
+            {
+                mpApp->undo();
+            }
+
+            if (mpApp->getUndoHistory().canRedo() && editMenu.item("Redo", "Ctrl+Y"))
+            {
+                mpApp->redo();
+            }
+        }
+
         // Draw View Menu
         {
             auto viewMenu = mainMenu.dropdown("View");
             viewMenu.item("Lock Windows", mWindowsLocked);
+            viewMenu.item("GPU Times", mShowGpuTimes);
+        }
+
+        if (const auto saveProgress = mpApp->getSaveProgress())
+        {
+            ImGui::ProgressBar(*saveProgress, ImVec2(150, 0), "Saving...");
+        }
+
+        if (const auto compilationCount = ProgramWrapper::getCompilationCount(); compilationCount > 0)
+        {
+            ImGui::TextDisabled("Compiling %zu shader variant(s)...", compilationCount);
         }
     }
 }
@@ -163,6 +202,64 @@ void UI::renderRenderManagerWindow(Falcor::Gui* pGui, Core::RenderManager& rende
 }
 
 
+void UI::renderGpuTimesWindow(Falcor::Gui* pGui)
+{
+    // Only lists the programs whose wrappers have GPU timing enabled
+    auto w = Falcor::Gui::Window { pGui, "GPU Times", mShowGpuTimes, { 600, 300 }, { 100, 100 } };
+
+    if (w.button("Reset"))
+    {
+        GpuTimeRecorder::clearStats();
+    }
+
+    if (w.button("Export...", true))
+    {
+        if (std::filesystem::path path; Falcor::saveFileDialog({ { "csv", "CSV File" } }, path))
+        {
+            GpuTimeRecorder::writeStats(path);
+        }
+    }
+
+    const auto& stats = GpuTimeRecorder::getStats();
+
+    if (stats.empty())
+    {
+        w.text("No GPU timings yet");
+        return;
+    }
+
+    if (ImGui::BeginTable("##GpuTimes", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+    {
+        ImGui::TableSetupColumn("Program");
+        ImGui::TableSetupColumn("Mean (ms)");
+        ImGui::TableSetupColumn("Last (ms)");
+        ImGui::TableSetupColumn("Min (ms)");
+        ImGui::TableSetupColumn("Max (ms)");
+        ImGui::TableSetupColumn("Samples");
+        ImGui::TableHeadersRow();
+
+        for (const auto& [ label, programStats ] : stats)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(label.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", programStats.getMeanMs());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", programStats.lastMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", programStats.minMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", programStats.maxMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(programStats.sampleCount));
+        }
+
+        ImGui::EndTable();
+    }
+}
+
+
 std::pair<uint32_t, uint32_t> UI::getSceneCameraManagerWindowPos() const
 {
     return UIHelpers::getLeftWindowStart();
@@ -28,6 +28,7 @@ private:
     void renderMainMenuBar(Falcor::Gui* pGui);
     void renderSceneCameraManagerWindow(Falcor::Gui* pGui, Core::SceneManager& sceneManager, Core::CameraManager& cameraManager) const;
     void renderRenderManagerWindow(Falcor::Gui* pGui, Core::RenderManager& renderManager) const;
+    void renderGpuTimesWindow(Falcor::Gui* pGui);
 
     std::pair<uint32_t, uint32_t> getSceneCameraManagerWindowPos() const;
     std::pair<uint32_t, uint32_t> getSceneCameraManagerWindowSize() const;
@@ -37,6 +38,7 @@ private:
     Application* mpApp;
     Falcor::uint2 mWindowSize;
     bool mWindowsLocked = true;
+    bool mShowGpuTimes = false;
 
 public:
     DEFAULT_CONST_GETREF_SETTER_DEFINITION(WindowSize, mWindowSize)
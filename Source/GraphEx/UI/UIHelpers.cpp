@@ -79,6 +79,17 @@ constexpr Falcor::uint UIHelpers::getRightWindowCount()
 }
 
 
+UIHelpers::EditTracker::EditTracker()
+    : mEditedBefore(ImGui::GetCurrentContext()->ActiveIdHasBeenEditedThisFrame) {}
+
+
+bool UIHelpers::EditTracker::hasEdits() const
+{
+    // There is a single active item at a time, so the flag can only have been raised by an item rendered since construction
+    return !mEditedBefore && ImGui::GetCurrentContext()->ActiveIdHasBeenEditedThisFrame;
+}
+
+
 void UIHelpers::DynamicButton::render(
     const std::string& label,
     const ImVec2& size,
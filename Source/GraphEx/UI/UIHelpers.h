@@ -41,6 +41,18 @@ struct GRAPHEX_EXPORTABLE UIHelpers final
         bool mJustStartedEditing = false;
     };
 
+    // Detects whether the user edited a value through the items rendered during its lifetime, for modules to mark their state dirty
+    class EditTracker
+    {
+    public:
+        EditTracker();
+
+        bool hasEdits() const;
+
+    private:
+        bool mEditedBefore;
+    };
+
     template<typename HumanReadableT>
     static Falcor::Gui::DropdownList getDropdownListForHumanReadables(const std::vector<HumanReadableT>& list);
 };
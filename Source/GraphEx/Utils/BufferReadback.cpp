@@ -0,0 +1,116 @@
+#include "BufferReadback.h"
+
+
+using namespace GraphEx;
+
+
+std::unordered_set<BufferReadback*> BufferReadback::sReadbacks;
+
+
+BufferReadback::BufferReadback(Falcor::ref<Falcor::Device> pDevice, const uint32_t maxInFlight)
+    : mpDevice(std::move(pDevice))
+    , mpFence(mpDevice->createFence())
+    , mMaxInFlight(maxInFlight) {}
+
+
+BufferReadback::~BufferReadback()
+{
+    // Their futures report a broken promise
+    sReadbacks.erase(this);
+}
+
+
+void BufferReadback::read(const Falcor::ref<Falcor::Buffer>& pBuffer, DeliverFunction deliver)
+{
+    while (!mReadbacks.empty() && mReadbacks.size() >= std::max(mMaxInFlight, 1u))
+    {
+        this->deliver(true);
+    }
+
+    // The smallest staging buffer that fits, if there is one
+    auto itStagingBuffer = mStagingBuffers.end();
+
+    for (auto it = mStagingBuffers.begin(); it != mStagingBuffers.end(); ++it)
+    {
+        const auto isSmaller = itStagingBuffer == mStagingBuffers.end() || (*it)->getSize() < (*itStagingBuffer)->getSize();
+
+        if ((*it)->getSize() >= pBuffer->getSize() && isSmaller)
+        {
+            itStagingBuffer = it;
+        }
+    }
+
+    auto& readback = mReadbacks.emplace_back();
+    readback.size = pBuffer->getSize();
+    readback.deliver = std::move(deliver);
+
+    if (itStagingBuffer != mStagingBuffers.end())
+    {
+        readback.pStagingBuffer = std::move(*itStagingBuffer);
+        mStagingBuffers.erase(itStagingBuffer);
+    }
+    else
+    {
+        readback.pStagingBuffer = mpDevice->createBuffer(readback.size, Falcor::ResourceBindFlags::None, Falcor::MemoryType::ReadBack);
+    }
+
+    const auto pRenderContext = mpDevice->getRenderContext();
+    pRenderContext->copyBufferRegion(readback.pStagingBuffer.get(), 0, pBuffer.get(), 0, readback.size);
+
+    // Ordered after the commands that wrote the buffer so far, which are left running
+    pRenderContext->submit(false);
+    readback.fenceValue = pRenderContext->signal(mpFence.get());
+
+    sReadbacks.insert(this);
+}
+
+
+void BufferReadback::beginFrame()
+{
+    // Delivering may begin other readbacks, which are only delivered in a later frame
+    const auto readbacks = std::vector(sReadbacks.begin(), sReadbacks.end());
+
+    for (const auto pReadback : readbacks)
+    {
+        pReadback->deliver(false);
+    }
+}
+
+
+void BufferReadback::deliver(const bool waitForOldest)
+{
+    if (waitForOldest && !mReadbacks.empty())
+    {
+        mpFence->wait(mReadbacks.front().fenceValue);
+    }
+
+    const auto completedValue = mpFence->getCurrentValue();
+
+    while (!mReadbacks.empty() && mReadbacks.front().fenceValue <= completedValue)
+    {
+        auto readback = std::move(mReadbacks.front());
+        mReadbacks.pop_front();
+
+        try
+        {
+            readback.deliver(readback.pStagingBuffer->map(), readback.size);
+        }
+        catch (const std::exception& e)
+        {
+            Falcor::logError("BufferReadback: Failed to deliver a readback:\n{}", e.what());
+        }
+
+        readback.pStagingBuffer->unmap();
+
+        // As many as may be in flight are kept for reuse
+        if (mStagingBuffers.size() < mMaxInFlight)
+        {
+            mStagingBuffers.push_back(std::move(readback.pStagingBuffer));
+        }
+    }
+
+    if (mReadbacks.empty())
+    {
+        sReadbacks.erase(this);
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Standard.h"
+
+
+namespace GraphEx
+{
+
+// Reads device buffers without waiting for the GPU. A buffer is copied into a pooled staging buffer on the GPU timeline, and its contents are
+// delivered at the beginning of the first frame after the copy completed. With the maximum number in flight, the oldest one is waited for
+class GRAPHEX_EXPORTABLE BufferReadback final
+{
+public:
+    static constexpr uint32_t DEFAULT_MAX_IN_FLIGHT = 3;
+
+    using DeliverFunction = std::function<void(const void* pData, size_t size)>;
+
+    explicit BufferReadback(Falcor::ref<Falcor::Device> pDevice, uint32_t maxInFlight = DEFAULT_MAX_IN_FLIGHT);
+    // Readbacks in flight are dropped
+    ~BufferReadback();
+
+    BufferReadback(const BufferReadback&) = delete;
+    BufferReadback& operator=(const BufferReadback&) = delete;
+
+    void read(const Falcor::ref<Falcor::Buffer>& pBuffer, DeliverFunction deliver);
+
+    // The future becomes ready after the callback was called, holding the exception if it threw
+    template<typename T>
+    std::future<std::vector<T>> readElements(
+        const Falcor::ref<Falcor::Buffer>& pBuffer,
+        std::function<void(const std::vector<T>&)> callback = nullptr
+    );
+
+    // Delivers the readbacks of every instance that completed. Called by the application at the beginning of each frame
+    static void beginFrame();
+
+private:
+    struct PendingReadback
+    {
+        Falcor::ref<Falcor::Buffer> pStagingBuffer;
+        uint64_t size = 0;
+        uint64_t fenceValue = 0;
+        DeliverFunction deliver;
+    };
+
+    void deliver(bool waitForOldest);
+
+    Falcor::ref<Falcor::Device> mpDevice;
+    Falcor::ref<Falcor::Fence> mpFence;
+    std::deque<PendingReadback> mReadbacks;  // Oldest first
+    std::vector<Falcor::ref<Falcor::Buffer>> mStagingBuffers;  // Of delivered readbacks, to be reused
+    uint32_t mMaxInFlight = DEFAULT_MAX_IN_FLIGHT;
+
+    static std::unordered_set<BufferReadback*> sReadbacks;  // With readbacks in flight
+
+public:
+    DEFAULT_CONST_GETTER_SETTER_DEFINITION(MaxInFlight, mMaxInFlight)
+};
+
+
+template<typename T>
+std::future<std::vector<T>> BufferReadback::readElements(
+    const Falcor::ref<Falcor::Buffer>& pBuffer,
+    std::function<void(const std::vector<T>&)> callback
+) {
+    auto pPromise = std::make_shared<std::promise<std::vector<T>>>();
+    auto future = pPromise->get_future();
+
+    read(pBuffer, [pPromise, callback = std::move(callback)](const void* pData, const size_t size) {
+        std::vector<T> elements(size / sizeof(T));
+        std::memcpy(elements.data(), pData, elements.size() * sizeof(T));
+
+        // The error is logged when delivering
+        try
+        {
+            if (callback)
+            {
+                callback(elements);
+            }
+        }
+        catch (...)
+        {
+            pPromise->set_exception(std::current_exception());
+            throw;
+        }
+
+        pPromise->set_value(std::move(elements));
+    });
+
+    return future;
+}
+
+} // namespace GraphEx
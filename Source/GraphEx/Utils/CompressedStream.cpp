@@ -0,0 +1,281 @@
+#include "CompressedStream.h"
+
+#include <lz4frame.h>
+
+
+using namespace GraphEx;
+
+
+CompressedStreamWriter::CompressedStreamWriter(std::ostream& os)
+    : mOutputStream(os)
+    , mBuffer(BUFFER_SIZE)
+{
+    // Fastest level, as saving should not take longer than the I/O it saves. The checksum catches files damaged in transfer
+    LZ4F_preferences_t preferences = LZ4F_INIT_PREFERENCES;
+    preferences.frameInfo.blockSizeID = LZ4F_max256KB;
+    preferences.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+    // Large enough for any single update, including the end of the frame
+    mCompressedBuffer.resize(std::max<size_t>(LZ4F_compressBound(BUFFER_SIZE, &preferences), LZ4F_HEADER_SIZE_MAX));
+
+    if (LZ4F_isError(LZ4F_createCompressionContext(&mpContext, LZ4F_VERSION)))
+    {
+        mpContext = nullptr;
+        return;
+    }
+
+    const auto headerSize = LZ4F_compressBegin(mpContext, mCompressedBuffer.data(), mCompressedBuffer.size(), &preferences);
+    mFailed = LZ4F_isError(headerSize) || !writeCompressed(headerSize);
+}
+
+
+CompressedStreamWriter::~CompressedStreamWriter()
+{
+    LZ4F_freeCompressionContext(mpContext);
+}
+
+
+bool CompressedStreamWriter::isOpen() const
+{
+    return mpContext && !mFailed && !mFinished;
+}
+
+
+bool CompressedStreamWriter::finish()
+{
+    if (!isOpen() || !mStreamBuffer.compressBuffered())
+    {
+        return false;
+    }
+
+    mFinished = true;
+
+    const auto size = LZ4F_compressEnd(mpContext, mCompressedBuffer.data(), mCompressedBuffer.size(), nullptr);
+    return !LZ4F_isError(size) && writeCompressed(size);
+}
+
+
+bool CompressedStreamWriter::compress(const char* pData, const size_t size)
+{
+    const auto compressedSize = LZ4F_compressUpdate(mpContext, mCompressedBuffer.data(), mCompressedBuffer.size(), pData, size, nullptr);
+
+    if (LZ4F_isError(compressedSize))
+    {
+        Falcor::logError("Failed to compress project data: {}", LZ4F_getErrorName(compressedSize));
+        mFailed = true;
+        return false;
+    }
+
+    return writeCompressed(compressedSize);
+}
+
+
+bool CompressedStreamWriter::writeCompressed(const size_t size)
+{
+    if (!mOutputStream.write(mCompressedBuffer.data(), static_cast<std::streamsize>(size)))
+    {
+        mFailed = true;
+        return false;
+    }
+
+    return true;
+}
+
+
+CompressedStreamWriter::CompressingStreamBuffer::CompressingStreamBuffer(CompressedStreamWriter& writer)
+    : mWriter(writer)
+{
+    setp(mWriter.mBuffer.data(), mWriter.mBuffer.data() + mWriter.mBuffer.size());
+}
+
+
+bool CompressedStreamWriter::CompressingStreamBuffer::compressBuffered()
+{
+    const auto size = static_cast<size_t>(pptr() - pbase());
+
+    if (!mWriter.isOpen() || (size > 0 && !mWriter.compress(pbase(), size)))
+    {
+        return false;
+    }
+
+    setp(pbase(), epptr());
+    return true;
+}
+
+
+auto CompressedStreamWriter::CompressingStreamBuffer::overflow(const int_type ch) -> int_type
+{
+    if (!compressBuffered())
+    {
+        return traits_type::eof();
+    }
+
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+
+    return traits_type::not_eof(ch);
+}
+
+
+int CompressedStreamWriter::CompressingStreamBuffer::sync()
+{
+    return compressBuffered() && mWriter.mOutputStream.flush() ? 0 : -1;
+}
+
+
+CompressedStreamReader::CompressedStreamReader(std::istream& is)
+    : mInputStream(is)
+    , mCompressedBuffer(BUFFER_SIZE)
+    , mBuffer(BUFFER_SIZE)
+{
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&mpContext, LZ4F_VERSION)))
+    {
+        mpContext = nullptr;
+        mFailed = true;
+    }
+}
+
+
+CompressedStreamReader::~CompressedStreamReader()
+{
+    LZ4F_freeDecompressionContext(mpContext);
+}
+
+
+bool CompressedStreamReader::isOpen() const
+{
+    return mpContext != nullptr;
+}
+
+
+bool CompressedStreamReader::hasFailed() const
+{
+    return mFailed;
+}
+
+
+bool CompressedStreamReader::isCompressed(std::istream& is)
+{
+    std::array<unsigned char, sizeof(FRAME_MAGIC)> header{ };
+
+    const auto start = is.tellg();
+    is.read(reinterpret_cast<char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    const auto readCount = is.gcount();
+
+    is.clear();
+    is.seekg(start);
+
+    if (readCount != static_cast<std::streamsize>(header.size()))
+    {
+        return false;
+    }
+
+    uint32_t magic = 0;
+
+    for (size_t i = 0; i < header.size(); ++i)
+    {
+        magic |= static_cast<uint32_t>(header[i]) << (8 * i);
+    }
+
+    return magic == FRAME_MAGIC;
+}
+
+
+size_t CompressedStreamReader::decompress()
+{
+    size_t size = 0;
+
+    // The whole buffer is filled, so that headers can be peeked at and seeked back from in one go
+    while (size < mBuffer.size() && !mFrameEnded && !mFailed)
+    {
+        if (mCompressedBegin == mCompressedEnd)
+        {
+            mInputStream.read(mCompressedBuffer.data(), static_cast<std::streamsize>(mCompressedBuffer.size()));
+            mCompressedBegin = 0;
+            mCompressedEnd = static_cast<size_t>(mInputStream.gcount());
+
+            if (mCompressedEnd == 0)
+            {
+                Falcor::logError("Compressed project data ends unexpectedly.");
+                mFailed = true;
+                break;
+            }
+        }
+
+        auto decompressedSize = mBuffer.size() - size;
+        auto compressedSize = mCompressedEnd - mCompressedBegin;
+
+        const auto hint = LZ4F_decompress(mpContext, mBuffer.data() + size, &decompressedSize,
+                                          mCompressedBuffer.data() + mCompressedBegin, &compressedSize, nullptr);
+
+        if (LZ4F_isError(hint))
+        {
+            Falcor::logError("Failed to decompress project data: {}", LZ4F_getErrorName(hint));
+            mFailed = true;
+            break;
+        }
+
+        size += decompressedSize;
+        mCompressedBegin += compressedSize;
+        mFrameEnded = hint == 0;
+    }
+
+    return size;
+}
+
+
+CompressedStreamReader::DecompressingStreamBuffer::DecompressingStreamBuffer(CompressedStreamReader& reader)
+    : mReader(reader)
+{
+    setg(mReader.mBuffer.data(), mReader.mBuffer.data(), mReader.mBuffer.data());
+}
+
+
+auto CompressedStreamReader::DecompressingStreamBuffer::underflow() -> int_type
+{
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    mReader.mBufferPosition += static_cast<uint64_t>(egptr() - eback());
+
+    const auto size = mReader.decompress();
+    setg(eback(), eback(), eback() + size);
+
+    return size > 0 ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+}
+
+
+auto CompressedStreamReader::DecompressingStreamBuffer::seekoff(
+    const off_type offset,
+    const std::ios_base::seekdir direction,
+    const std::ios_base::openmode mode
+) -> pos_type
+{
+    if (!(mode & std::ios_base::in) || direction == std::ios_base::end)
+    {
+        return pos_type(off_type(-1));
+    }
+
+    const auto current = static_cast<off_type>(mReader.mBufferPosition) + (gptr() - eback());
+    return seekpos(pos_type(direction == std::ios_base::beg ? offset : current + offset), mode);
+}
+
+
+auto CompressedStreamReader::DecompressingStreamBuffer::seekpos(const pos_type position, const std::ios_base::openmode mode) -> pos_type
+{
+    const auto bufferBegin = static_cast<off_type>(mReader.mBufferPosition);
+    const auto target = off_type(position);
+
+    if (!(mode & std::ios_base::in) || target < bufferBegin || target > bufferBegin + (egptr() - eback()))
+    {
+        return pos_type(off_type(-1));
+    }
+
+    setg(eback(), eback() + (target - bufferBegin), egptr());
+    return position;
+}
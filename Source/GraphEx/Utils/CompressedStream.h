@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Standard.h"
+
+
+struct LZ4F_cctx_s;
+struct LZ4F_dctx_s;
+
+
+namespace GraphEx
+{
+
+// Compresses everything written to its stream into a single LZ4 frame on the underlying stream, one buffer at a time, so that the
+// uncompressed content is never held in memory as a whole
+struct GRAPHEX_EXPORTABLE CompressedStreamWriter
+{
+    static constexpr size_t BUFFER_SIZE = 256 * 1024;
+
+    explicit CompressedStreamWriter(std::ostream& os);
+    ~CompressedStreamWriter();
+
+    MAKE_MOVE_ONLY(CompressedStreamWriter)
+
+    bool isOpen() const;
+
+    // Compresses what is still buffered and ends the frame, which is unreadable without it. The writer is unusable afterwards
+    bool finish();
+
+private:
+    struct CompressingStreamBuffer : std::streambuf
+    {
+        explicit CompressingStreamBuffer(CompressedStreamWriter& writer);
+
+        bool compressBuffered();
+
+    protected:
+        int_type overflow(int_type ch) override;
+        int sync() override;
+
+    private:
+        CompressedStreamWriter& mWriter;
+    };
+
+    bool compress(const char* pData, size_t size);
+    bool writeCompressed(size_t size);
+
+    std::ostream& mOutputStream;
+    LZ4F_cctx_s* mpContext = nullptr;
+    std::vector<char> mBuffer;
+    std::vector<char> mCompressedBuffer;
+    bool mFailed = false;
+    bool mFinished = false;
+
+    CompressingStreamBuffer mStreamBuffer{ *this };
+    std::ostream mStream{ &mStreamBuffer };
+
+public:
+    DEFAULT_GETREF_DEFINITION(Stream, mStream)
+};
+
+
+// Decompresses an LZ4 frame from the underlying stream while its own stream is being read. Seeking is only supported within the
+// content decompressed last, which is enough to peek at headers
+struct GRAPHEX_EXPORTABLE CompressedStreamReader
+{
+    static constexpr size_t BUFFER_SIZE = 256 * 1024;
+    static constexpr uint32_t FRAME_MAGIC = 0x184D2204;  // Of the LZ4 frame format, stored in little endian
+
+    explicit CompressedStreamReader(std::istream& is);
+    ~CompressedStreamReader();
+
+    MAKE_MOVE_ONLY(CompressedStreamReader)
+
+    bool isOpen() const;
+    // Whether the frame was corrupt or ended early, in which case the stream ends prematurely
+    bool hasFailed() const;
+
+    // Recognizes compressed content by the magic number of the frame. Does not consume the stream
+    static bool isCompressed(std::istream& is);
+
+private:
+    struct DecompressingStreamBuffer : std::streambuf
+    {
+        explicit DecompressingStreamBuffer(CompressedStreamReader& reader);
+
+    protected:
+        int_type underflow() override;
+        pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override;
+        pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+
+    private:
+        CompressedStreamReader& mReader;
+    };
+
+    size_t decompress();
+
+    std::istream& mInputStream;
+    LZ4F_dctx_s* mpContext = nullptr;
+    std::vector<char> mCompressedBuffer;
+    size_t mCompressedBegin = 0;
+    size_t mCompressedEnd = 0;
+    std::vector<char> mBuffer;
+    uint64_t mBufferPosition = 0;  // Of the start of the buffer within the decompressed content
+    bool mFailed = false;
+    bool mFrameEnded = false;
+
+    DecompressingStreamBuffer mStreamBuffer{ *this };
+    std::istream mStream{ &mStreamBuffer };
+
+public:
+    DEFAULT_GETREF_DEFINITION(Stream, mStream)
+};
+
+} // namespace GraphEx
@@ -0,0 +1,413 @@
+#include "ComputePassGraph.h"
+
+
+using namespace GraphEx;
+
+
+ComputePassGraph::ComputePassGraph(Falcor::ref<Falcor::Device> pDevice)
+    : mpDevice(std::move(pDevice))
+{ }
+
+
+template<typename F>
+void ComputePassGraph::forEachAccess(const Pass& pass, F&& f)
+{
+    for (const auto& name : pass.reads)
+    {
+        f(name, false);
+    }
+
+    for (const auto& name : pass.writes)
+    {
+        f(name, true);
+    }
+}
+
+
+void ComputePassGraph::addTransientBuffer(const std::string& name, const uint32_t structSize, const uint32_t elementCount)
+{
+    FALCOR_CHECK(mImportedBuffers.find(name) == mImportedBuffers.end(), "ComputePassGraph: Buffer was imported already: " + name);
+    FALCOR_CHECK(structSize > 0 && elementCount > 0, "ComputePassGraph: Transient buffer must not be empty: " + name);
+
+    auto& buffer = mTransientBuffers[name];
+    buffer.structSize = structSize;
+    buffer.elementCount = elementCount;
+    mCompiled = false;
+}
+
+
+void ComputePassGraph::importBuffer(const std::string& name, const Falcor::ref<Falcor::Buffer>& pBuffer)
+{
+    FALCOR_CHECK(pBuffer, "ComputePassGraph: Attempted to import a null buffer: " + name);
+    FALCOR_CHECK(mTransientBuffers.find(name) == mTransientBuffers.end(), "ComputePassGraph: Buffer is transient already: " + name);
+
+    // Imported buffers take no part in the ordering or the sharing, replacing one needs no compilation
+    mImportedBuffers[name] = pBuffer;
+}
+
+
+void ComputePassGraph::addPass(Pass pass)
+{
+    FALCOR_CHECK(pass.execute, "ComputePassGraph: Pass has nothing to execute: " + pass.name);
+
+    mPasses.push_back(std::move(pass));
+    mCompiled = false;
+}
+
+
+void ComputePassGraph::clear()
+{
+    mPasses.clear();
+    mOrder.clear();
+    mTransientBuffers.clear();
+    mImportedBuffers.clear();
+    mSharedBuffers.clear();
+    mCompiled = false;
+}
+
+
+void ComputePassGraph::compile()
+{
+    for (const auto& pass : mPasses)
+    {
+        forEachAccess(pass, [this, &pass](const std::string& name, bool) {
+            FALCOR_CHECK(
+                mTransientBuffers.find(name) != mTransientBuffers.end() || mImportedBuffers.find(name) != mImportedBuffers.end(),
+                "ComputePassGraph: Pass " + pass.name + " accesses an unknown buffer: " + name
+            );
+        });
+    }
+
+    orderPasses();
+    assignSharedBuffers();
+    mCompiled = true;
+}
+
+
+void ComputePassGraph::execute(Falcor::RenderContext* pRenderContext)
+{
+    if (!mCompiled)
+    {
+        compile();
+    }
+
+    allocateSharedBuffers();
+
+    // Whether each buffer was written since the last barrier on it. Buffers not accessed yet may have been written outside of the graph
+    std::unordered_map<const Falcor::Buffer*, bool> writtenSinceBarrier;
+
+    for (const auto passIndex : mOrder)
+    {
+        const auto& pass = mPasses[passIndex];
+        std::unordered_set<const Falcor::Buffer*> passBuffers;
+
+        // Reads only need a barrier after writes, writes after any access
+        forEachAccess(pass, [&](const std::string& name, const bool writes) {
+            const auto pBuffer = getBuffer(name).get();
+            const auto it = writtenSinceBarrier.find(pBuffer);
+
+            if (passBuffers.insert(pBuffer).second && (it == writtenSinceBarrier.end() || it->second || writes))
+            {
+                pRenderContext->uavBarrier(pBuffer);
+            }
+        });
+
+        for (const auto pBuffer : passBuffers)
+        {
+            writtenSinceBarrier[pBuffer] = false;
+        }
+
+        for (const auto& name : pass.writes)
+        {
+            writtenSinceBarrier[getBuffer(name).get()] = true;
+        }
+
+        bindBuffers(pass);
+        pass.execute(pRenderContext);
+    }
+}
+
+
+const Falcor::ref<Falcor::Buffer>& ComputePassGraph::getBuffer(const std::string& name) const
+{
+    if (const auto it = mImportedBuffers.find(name); it != mImportedBuffers.end())
+    {
+        return it->second;
+    }
+
+    const auto it = mTransientBuffers.find(name);
+    FALCOR_CHECK(it != mTransientBuffers.end(), "ComputePassGraph: Couldn't find buffer by name: " + name);
+    FALCOR_CHECK(mCompiled, "ComputePassGraph: Transient buffers are only assigned once the graph is compiled");
+    FALCOR_CHECK(it->second.sharedIndex != UNUSED, "ComputePassGraph: Transient buffer is not used by any pass: " + name);
+
+    return mSharedBuffers[it->second.sharedIndex].pBuffer;
+}
+
+
+std::vector<std::string> ComputePassGraph::getPassOrder() const
+{
+    std::vector<std::string> names;
+    names.reserve(mOrder.size());
+
+    for (const auto passIndex : mOrder)
+    {
+        names.push_back(mPasses[passIndex].name);
+    }
+
+    return names;
+}
+
+
+uint64_t ComputePassGraph::getPeakTransientMemory() const
+{
+    uint64_t size = 0;
+
+    for (const auto& buffer : mSharedBuffers)
+    {
+        size += uint64_t(buffer.structSize) * buffer.elementCount;
+    }
+
+    return size;
+}
+
+
+uint64_t ComputePassGraph::getUnaliasedTransientMemory() const
+{
+    uint64_t size = 0;
+
+    for (const auto& [ name, buffer ] : mTransientBuffers)
+    {
+        if (buffer.sharedIndex != UNUSED)
+        {
+            size += uint64_t(buffer.structSize) * buffer.elementCount;
+        }
+    }
+
+    return size;
+}
+
+
+void ComputePassGraph::orderPasses()
+{
+    const auto passCount = mPasses.size();
+    std::vector<std::vector<size_t>> dependents(passCount);
+    std::vector<size_t> dependencyCounts(passCount, 0);
+
+    const auto addDependency = [&](const size_t pass, const size_t dependent) {
+        dependents[pass].push_back(dependent);
+        ++dependencyCounts[dependent];
+    };
+
+    std::map<std::string, std::vector<size_t>> writers;
+
+    for (size_t i = 0; i < passCount; ++i)
+    {
+        for (const auto& name : mPasses[i].writes)
+        {
+            auto& bufferWriters = writers[name];
+
+            if (!bufferWriters.empty() && bufferWriters.back() == i)
+            {
+                continue;
+            }
+
+            // Writing the same buffer, in the order the passes were added
+            if (!bufferWriters.empty())
+            {
+                addDependency(bufferWriters.back(), i);
+            }
+
+            bufferWriters.push_back(i);
+        }
+    }
+
+    for (size_t i = 0; i < passCount; ++i)
+    {
+        const auto& pass = mPasses[i];
+
+        for (const auto& name : pass.reads)
+        {
+            const auto it = writers.find(name);
+
+            if (it == writers.end())
+            {
+                FALCOR_CHECK(
+                    mTransientBuffers.find(name) == mTransientBuffers.end(),
+                    "ComputePassGraph: Transient buffer is read by " + pass.name + ", but never written: " + name
+                );
+                continue;
+            }
+
+            // Reading what the writers before it left, or the final contents if it does not write the buffer itself
+            if (std::find(pass.writes.begin(), pass.writes.end(), name) == pass.writes.end())
+            {
+                addDependency(it->second.back(), i);
+            }
+        }
+    }
+
+    // Passes that could run in any order run in the order they were added
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<>> readyPasses;
+
+    for (size_t i = 0; i < passCount; ++i)
+    {
+        if (dependencyCounts[i] == 0)
+        {
+            readyPasses.push(i);
+        }
+    }
+
+    mOrder.clear();
+
+    while (!readyPasses.empty())
+    {
+        const auto pass = readyPasses.top();
+        readyPasses.pop();
+        mOrder.push_back(pass);
+
+        for (const auto dependent : dependents[pass])
+        {
+            if (--dependencyCounts[dependent] == 0)
+            {
+                readyPasses.push(dependent);
+            }
+        }
+    }
+
+    if (mOrder.size() != passCount)
+    {
+        mOrder.clear();
+        FALCOR_THROW("ComputePassGraph: The passes depend on each other in a cycle");
+    }
+}
+
+
+void ComputePassGraph::assignSharedBuffers()
+{
+    for (auto& [ name, buffer ] : mTransientBuffers)
+    {
+        buffer.firstUse = buffer.lastUse = buffer.sharedIndex = UNUSED;
+    }
+
+    for (size_t position = 0; position < mOrder.size(); ++position)
+    {
+        const auto& pass = mPasses[mOrder[position]];
+
+        forEachAccess(pass, [this, position](const std::string& name, bool) {
+            if (const auto it = mTransientBuffers.find(name); it != mTransientBuffers.end())
+            {
+                it->second.firstUse = std::min(it->second.firstUse, position);
+                it->second.lastUse = it->second.lastUse == UNUSED ? position : std::max(it->second.lastUse, position);
+            }
+        });
+    }
+
+    std::vector<TransientBuffer*> usedBuffers;
+
+    for (auto& [ name, buffer ] : mTransientBuffers)
+    {
+        if (buffer.firstUse != UNUSED)
+        {
+            usedBuffers.push_back(&buffer);
+        }
+    }
+
+    std::stable_sort(usedBuffers.begin(), usedBuffers.end(), [](const TransientBuffer* pLhs, const TransientBuffer* pRhs) {
+        return pLhs->firstUse < pRhs->firstUse;
+    });
+
+    // The buffers created before are kept for the shared buffers that did not change
+    auto previousSharedBuffers = std::move(mSharedBuffers);
+    mSharedBuffers.clear();
+
+    for (const auto pBuffer : usedBuffers)
+    {
+        // Sharing the smallest buffer free by then that is large enough, otherwise growing the largest one. The views of structured
+        // buffers have a fixed element size, only buffers of the same one are shared
+        auto bestIndex = UNUSED;
+
+        for (size_t i = 0; i < mSharedBuffers.size(); ++i)
+        {
+            const auto& sharedBuffer = mSharedBuffers[i];
+
+            if (sharedBuffer.structSize != pBuffer->structSize || sharedBuffer.lastUse >= pBuffer->firstUse)
+            {
+                continue;
+            }
+
+            if (bestIndex == UNUSED)
+            {
+                bestIndex = i;
+                continue;
+            }
+
+            const auto bestElementCount = mSharedBuffers[bestIndex].elementCount;
+            const auto fits = sharedBuffer.elementCount >= pBuffer->elementCount;
+            const auto bestFits = bestElementCount >= pBuffer->elementCount;
+
+            if (fits && !bestFits)
+            {
+                bestIndex = i;
+            }
+            else if (fits == bestFits && (fits ? sharedBuffer.elementCount < bestElementCount : sharedBuffer.elementCount > bestElementCount))
+            {
+                bestIndex = i;
+            }
+        }
+
+        if (bestIndex == UNUSED)
+        {
+            bestIndex = mSharedBuffers.size();
+            mSharedBuffers.push_back({ pBuffer->structSize, 0, 0, nullptr });
+        }
+
+        auto& sharedBuffer = mSharedBuffers[bestIndex];
+        sharedBuffer.elementCount = std::max(sharedBuffer.elementCount, pBuffer->elementCount);
+        sharedBuffer.lastUse = pBuffer->lastUse;
+        pBuffer->sharedIndex = bestIndex;
+    }
+
+    for (size_t i = 0; i < std::min(mSharedBuffers.size(), previousSharedBuffers.size()); ++i)
+    {
+        if (mSharedBuffers[i].structSize == previousSharedBuffers[i].structSize &&
+            mSharedBuffers[i].elementCount == previousSharedBuffers[i].elementCount)
+        {
+            mSharedBuffers[i].pBuffer = std::move(previousSharedBuffers[i].pBuffer);
+        }
+    }
+}
+
+
+void ComputePassGraph::allocateSharedBuffers()
+{
+    for (auto& sharedBuffer : mSharedBuffers)
+    {
+        if (!sharedBuffer.pBuffer)
+        {
+            sharedBuffer.pBuffer = mpDevice->createStructuredBuffer(
+                sharedBuffer.structSize,
+                sharedBuffer.elementCount,
+                Falcor::ResourceBindFlags::ShaderResource | Falcor::ResourceBindFlags::UnorderedAccess,
+                Falcor::MemoryType::DeviceLocal,
+                nullptr,
+                false
+            );
+        }
+    }
+}
+
+
+void ComputePassGraph::bindBuffers(const Pass& pass) const
+{
+    if (!pass.pProgram)
+    {
+        return;
+    }
+
+    auto rootVar = pass.pProgram->getRootVar();
+
+    forEachAccess(pass, [this, &rootVar](const std::string& name, bool) {
+        rootVar[name].setBuffer(getBuffer(name));
+    });
+}
+
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ProgramWrapper.h"
+#include "Standard.h"
+
+
+namespace GraphEx
+{
+
+// Multi-pass compute pipelines over structured buffers. The passes declare the buffers they read and write, and the graph orders them by
+// those: a pass reading a buffer runs after the passes writing it, and the passes writing the same buffer run in the order they were
+// added. UAV barriers are placed between the passes that depend on each other. Transient buffers, the ones only the passes use, are
+// allocated by the graph, and those whose lifetimes do not overlap share a buffer, so intermediates don't stay allocated in the wrappers
+class GRAPHEX_EXPORTABLE ComputePassGraph
+{
+public:
+    struct Pass
+    {
+        std::string name;
+        Falcor::ref<ComputeProgramWrapper> pProgram;  // The buffers are bound on it under their names, may be null
+        std::vector<std::string> reads;
+        std::vector<std::string> writes;
+        std::function<void(Falcor::RenderContext* pRenderContext)> execute;
+    };
+
+    explicit ComputePassGraph(Falcor::ref<Falcor::Device> pDevice);
+
+    // A transient buffer may have more elements than asked for when it shares a buffer with a larger one, the shaders should be given the
+    // count separately. It can only be accessed while the graph executes
+    void addTransientBuffer(const std::string& name, uint32_t structSize, uint32_t elementCount);
+    // Owned outside of the graph, e.g. the inputs and the results of the pipeline
+    void importBuffer(const std::string& name, const Falcor::ref<Falcor::Buffer>& pBuffer);
+    void addPass(Pass pass);
+    void clear();
+
+    // Orders the passes, and assigns the transient buffers to shared ones. Called by execute() if the graph changed since
+    void compile();
+    void execute(Falcor::RenderContext* pRenderContext);
+
+    const Falcor::ref<Falcor::Buffer>& getBuffer(const std::string& name) const;
+    std::vector<std::string> getPassOrder() const;
+
+    // The memory the transient buffers take, and what they would take without sharing
+    uint64_t getPeakTransientMemory() const;
+    uint64_t getUnaliasedTransientMemory() const;
+
+private:
+    static constexpr size_t UNUSED = std::numeric_limits<size_t>::max();
+
+    struct TransientBuffer
+    {
+        uint32_t structSize = 0;
+        uint32_t elementCount = 0;
+        size_t firstUse = UNUSED;  // Positions in the order of the passes
+        size_t lastUse = UNUSED;
+        size_t sharedIndex = UNUSED;
+    };
+
+    struct SharedBuffer
+    {
+        uint32_t structSize = 0;
+        uint32_t elementCount = 0;
+        size_t lastUse = 0;
+        Falcor::ref<Falcor::Buffer> pBuffer;  // Created when executing
+    };
+
+    void orderPasses();
+    void assignSharedBuffers();
+    void allocateSharedBuffers();
+    void bindBuffers(const Pass& pass) const;
+
+    // Calls the function with the name of each buffer the pass reads, then of each it writes, and whether it writes it
+    template<typename F>
+    static void forEachAccess(const Pass& pass, F&& f);
+
+    Falcor::ref<Falcor::Device> mpDevice;
+    std::vector<Pass> mPasses;
+    std::vector<size_t> mOrder;  // Indices of the passes
+    std::map<std::string, TransientBuffer> mTransientBuffers;
+    std::map<std::string, Falcor::ref<Falcor::Buffer>> mImportedBuffers;
+    std::vector<SharedBuffer> mSharedBuffers;
+    bool mCompiled = false;
+};
+
+} // namespace GraphEx
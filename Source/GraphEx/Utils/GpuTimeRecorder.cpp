@@ -0,0 +1,162 @@
+#include "GpuTimeRecorder.h"
+
+
+using namespace GraphEx;
+
+
+std::unordered_set<GpuTimeRecorder*> GpuTimeRecorder::sRecorders;
+std::map<std::string, GpuTimeRecorder::Stats> GpuTimeRecorder::sStats;
+
+
+void GpuTimeRecorder::Stats::addSample(const double ms)
+{
+    ++sampleCount;
+    lastMs = ms;
+    totalMs += ms;
+    minMs = std::min(minMs, ms);
+    maxMs = std::max(maxMs, ms);
+}
+
+
+double GpuTimeRecorder::Stats::getMeanMs() const
+{
+    return sampleCount > 0 ? totalMs / double(sampleCount) : 0.0;
+}
+
+
+GpuTimeRecorder::GpuTimeRecorder(Falcor::ref<Falcor::Device> pDevice, std::string label)
+    : mpDevice(std::move(pDevice))
+    , mpFence(mpDevice->createFence())
+    , mLabel(std::move(label)) {}
+
+
+GpuTimeRecorder::~GpuTimeRecorder()
+{
+    sRecorders.erase(this);
+}
+
+
+bool GpuTimeRecorder::begin(const uint64_t key)
+{
+    // Skipped rather than waited for, the frames are not stalled for the statistics
+    if (mTimings.size() >= MAX_IN_FLIGHT)
+    {
+        return false;
+    }
+
+    auto& timing = mTimings.emplace_back();
+    timing.key = key;
+
+    if (!mTimers.empty())
+    {
+        timing.pTimer = std::move(mTimers.back());
+        mTimers.pop_back();
+    }
+    else
+    {
+        timing.pTimer = Falcor::GpuTimer::create(mpDevice);
+    }
+
+    timing.pTimer->begin();
+    sRecorders.insert(this);
+
+    return true;
+}
+
+
+void GpuTimeRecorder::end()
+{
+    // Resolved into the staging memory of the timer on the GPU timeline, it is only read once the fence passed
+    const auto& pTimer = mTimings.back().pTimer;
+    pTimer->end();
+    pTimer->resolve();
+}
+
+
+void GpuTimeRecorder::beginFrame()
+{
+    // Reading may erase the recorder from the set
+    const auto recorders = std::vector(sRecorders.begin(), sRecorders.end());
+    auto submitted = false;
+
+    for (const auto pRecorder : recorders)
+    {
+        auto& timings = pRecorder->mTimings;
+
+        // The timings of the previous frame are fenced together, ordered after the commands recorded so far
+        if (!timings.empty() && timings.back().fenceValue == 0)
+        {
+            const auto pRenderContext = pRecorder->mpDevice->getRenderContext();
+
+            if (!submitted)
+            {
+                pRenderContext->submit(false);
+                submitted = true;
+            }
+
+            const auto fenceValue = pRenderContext->signal(pRecorder->mpFence.get());
+
+            for (auto it = timings.rbegin(); it != timings.rend() && it->fenceValue == 0; ++it)
+            {
+                it->fenceValue = fenceValue;
+            }
+        }
+
+        pRecorder->read();
+    }
+}
+
+
+void GpuTimeRecorder::read()
+{
+    const auto completedValue = mpFence->getCurrentValue();
+
+    while (!mTimings.empty() && mTimings.front().fenceValue != 0 && mTimings.front().fenceValue <= completedValue)
+    {
+        auto timing = std::move(mTimings.front());
+        mTimings.pop_front();
+
+        sStats[fmt::format("{} [{:016x}]", mLabel, timing.key)].addSample(timing.pTimer->getElapsedTime());
+        mTimers.push_back(std::move(timing.pTimer));
+    }
+
+    if (mTimings.empty())
+    {
+        sRecorders.erase(this);
+    }
+}
+
+
+auto GpuTimeRecorder::getStats() -> const std::map<std::string, Stats>&
+{
+    return sStats;
+}
+
+
+void GpuTimeRecorder::clearStats()
+{
+    sStats.clear();
+}
+
+
+bool GpuTimeRecorder::writeStats(const std::filesystem::path& filePath)
+{
+    std::ofstream file(filePath);
+
+    if (!file)
+    {
+        Falcor::logError("GpuTimeRecorder: Failed to open file for writing GPU time statistics: {}", filePath.string());
+        return false;
+    }
+
+    file << "program,samples,mean_ms,last_ms,min_ms,max_ms\n";
+
+    for (const auto& [ label, stats ] : sStats)
+    {
+        // The labels contain commas between the entry points
+        file << '"' << label << "\"," << stats.sampleCount << ',' << stats.getMeanMs() << ',' << stats.lastMs << ',' << stats.minMs << ','
+             << stats.maxMs << '\n';
+    }
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Standard.h"
+
+
+namespace GraphEx
+{
+
+// Times draws and dispatches with timestamp queries. The timestamps are read without waiting for the GPU, a few frames later, and added to
+// the statistics shared by all recorders, under the label of the recorder and a key (e.g. the hash of the defines of a program variant)
+class GRAPHEX_EXPORTABLE GpuTimeRecorder final
+{
+public:
+    struct Stats
+    {
+        uint64_t sampleCount = 0;
+        double lastMs = 0.0;
+        double totalMs = 0.0;
+        double minMs = std::numeric_limits<double>::max();
+        double maxMs = 0.0;
+
+        void addSample(double ms);
+        double getMeanMs() const;
+    };
+
+    // Timings not read yet, beyond it nothing is timed
+    static constexpr size_t MAX_IN_FLIGHT = 256;
+
+    GpuTimeRecorder(Falcor::ref<Falcor::Device> pDevice, std::string label);
+    // Timings in flight are dropped, the statistics only miss them
+    ~GpuTimeRecorder();
+
+    GpuTimeRecorder(const GpuTimeRecorder&) = delete;
+    GpuTimeRecorder& operator=(const GpuTimeRecorder&) = delete;
+
+    // Returns whether it began, then it must be ended after the commands to time were recorded
+    bool begin(uint64_t key);
+    void end();
+
+    // Fences the timings of the previous frame and reads the ones that completed. Called by the application at the beginning of each frame
+    static void beginFrame();
+
+    static const std::map<std::string, Stats>& getStats();
+    static void clearStats();
+    // As CSV, e.g. at the end of a headless run
+    static bool writeStats(const std::filesystem::path& filePath);
+
+private:
+    struct PendingTiming
+    {
+        Falcor::ref<Falcor::GpuTimer> pTimer;
+        uint64_t key = 0;
+        uint64_t fenceValue = 0;  // Zero until the frame it was recorded in is submitted
+    };
+
+    void read();
+
+    Falcor::ref<Falcor::Device> mpDevice;
+    Falcor::ref<Falcor::Fence> mpFence;
+    std::string mLabel;
+    std::deque<PendingTiming> mTimings;  // Oldest first
+    std::vector<Falcor::ref<Falcor::GpuTimer>> mTimers;  // Of read timings, to be reused
+
+    static std::unordered_set<GpuTimeRecorder*> sRecorders;  // With timings in flight
+    static std::map<std::string, Stats> sStats;
+
+public:
+    DEFAULT_CONST_GETREF_SETTER_DEFINITION(Label, mLabel)
+};
+
+} // namespace GraphEx
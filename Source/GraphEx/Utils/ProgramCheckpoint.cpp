@@ -0,0 +1,210 @@
+#include "ProgramCheckpoint.h"
+
+#include "ProjectFileStream.h"
+#include "../Serialization/Serialization.h"
+
+
+using namespace GraphEx;
+
+
+template<typename Archive>
+void ProgramCheckpoint::Buffer::serialize(Archive& ar)
+{
+    ar(name, elementCount, structSize, data);
+}
+
+
+ProgramCheckpoint::ProgramCheckpoint(Falcor::ref<ProgramWrapper> pWrapper)
+    : mpWrapper(std::move(pWrapper))
+    , mpFence(mpWrapper->getDevice()->createFence()) {}
+
+
+ProgramCheckpoint::~ProgramCheckpoint()
+{
+    update(true);
+}
+
+
+bool ProgramCheckpoint::begin(const std::filesystem::path& filePath)
+{
+    if (mpPendingCheckpoint)
+    {
+        return false;
+    }
+
+    const auto& pDevice = mpWrapper->getDevice();
+    const auto& defines = mpWrapper->getDefines();
+
+    auto pCheckpoint = std::make_unique<PendingCheckpoint>();
+    pCheckpoint->filePath = filePath;
+    pCheckpoint->defines = { defines.begin(), defines.end() };
+
+    const auto pRenderContext = pDevice->getRenderContext();
+
+    for (const auto& [ name, pBuffer ] : mpWrapper->getStructuredBuffers())
+    {
+        auto& buffer = pCheckpoint->buffers.emplace_back();
+        buffer.name = name;
+        buffer.elementCount = pBuffer->getElementCount();
+        buffer.structSize = pBuffer->getStructSize();
+        buffer.pReadbackBuffer = pDevice->createBuffer(pBuffer->getSize(), Falcor::ResourceBindFlags::None, Falcor::MemoryType::ReadBack);
+
+        pRenderContext->copyResource(buffer.pReadbackBuffer.get(), pBuffer.get());
+    }
+
+    // Ordered after the commands that wrote the buffers so far, which are left running
+    pRenderContext->submit(false);
+    pCheckpoint->fenceValue = pRenderContext->signal(mpFence.get());
+
+    mpPendingCheckpoint = std::move(pCheckpoint);
+    mLastBeginTime = std::chrono::steady_clock::now();
+
+    return true;
+}
+
+
+void ProgramCheckpoint::update(const bool wait)
+{
+    if (!mpPendingCheckpoint)
+    {
+        return;
+    }
+
+    auto& checkpoint = *mpPendingCheckpoint;
+
+    if (!checkpoint.written)
+    {
+        if (wait)
+        {
+            mpFence->wait(checkpoint.fenceValue);
+        }
+        else if (mpFence->getCurrentValue() < checkpoint.fenceValue)
+        {
+            return;
+        }
+
+        // A plain copy out of the readback memory, everything slower than that happens on the worker
+        for (auto& buffer : checkpoint.buffers)
+        {
+            const auto pData = static_cast<const char*>(buffer.pReadbackBuffer->map());
+            buffer.data.assign(pData, buffer.pReadbackBuffer->getSize());
+            buffer.pReadbackBuffer->unmap();
+            buffer.pReadbackBuffer = nullptr;
+        }
+
+        checkpoint.written = std::async(std::launch::async, [&checkpoint] { return write(checkpoint); });
+    }
+
+    if (!wait && checkpoint.written->wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return;
+    }
+
+    if (!checkpoint.written->get())
+    {
+        Falcor::logError("ProgramCheckpoint: Failed to write checkpoint '{}'.", checkpoint.filePath.string());
+    }
+
+    mpPendingCheckpoint.reset();
+}
+
+
+bool ProgramCheckpoint::isPending() const
+{
+    return mpPendingCheckpoint != nullptr;
+}
+
+
+void ProgramCheckpoint::updatePeriodically(const std::filesystem::path& filePath, const std::chrono::steady_clock::duration interval)
+{
+    update();
+
+    if (!mLastBeginTime || std::chrono::steady_clock::now() - *mLastBeginTime >= interval)
+    {
+        begin(filePath);
+    }
+}
+
+
+bool ProgramCheckpoint::restore(ProgramWrapper& wrapper, const std::filesystem::path& filePath)
+{
+    ProjectFileReader reader(filePath);
+
+    if (!reader.isOpen() || reader.getSize() < MAGIC.size() || std::string_view(reader.getData(), MAGIC.size()) != MAGIC)
+    {
+        Falcor::logError("ProgramCheckpoint: '{}' is not a checkpoint file.", filePath.string());
+        return false;
+    }
+
+    std::map<std::string, std::string> defines;
+    std::vector<Buffer> buffers;
+
+    try
+    {
+        auto& is = reader.getStream();
+        is.ignore(static_cast<std::streamsize>(MAGIC.size()));
+
+        BinaryInputArchive ar(is);
+        ar(defines, buffers);
+    }
+    catch (const std::exception& e)
+    {
+        Falcor::logError("ProgramCheckpoint: Failed to read checkpoint '{}':\n{}", filePath.string(), e.what());
+        return false;
+    }
+
+    // The buffers are allocated through the reflection of the program, which depends on the defines
+    wrapper.clearDefines();
+
+    for (const auto& [ name, value ] : defines)
+    {
+        wrapper.addDefine(name, value);
+    }
+
+    wrapper.waitForCompilation();
+
+    auto success = true;
+
+    for (const auto& buffer : buffers)
+    {
+        try
+        {
+            wrapper.allocateStructuredBuffer(buffer.name, buffer.elementCount, buffer.data.data(), buffer.data.size());
+        }
+        catch (const std::exception& e)
+        {
+            Falcor::logError("ProgramCheckpoint: Could not restore buffer '{}' from checkpoint '{}', the program may have changed since:\n{}",
+                             buffer.name, filePath.string(), e.what());
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+
+bool ProgramCheckpoint::write(const PendingCheckpoint& checkpoint)
+{
+    ProjectFileWriter writer(checkpoint.filePath);
+
+    if (!writer.isOpen())
+    {
+        return false;
+    }
+
+    auto& os = writer.getStream();
+    os.write(MAGIC.data(), static_cast<std::streamsize>(MAGIC.size()));
+
+    try
+    {
+        BinaryOutputArchive ar(os);
+        ar(checkpoint.defines, checkpoint.buffers);
+    }
+    catch (const std::exception& e)
+    {
+        Falcor::logError("ProgramCheckpoint: Failed to serialize checkpoint:\n{}", e.what());
+        return false;
+    }
+
+    return os && writer.commit();
+}
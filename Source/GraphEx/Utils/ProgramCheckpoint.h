@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ProgramWrapper.h"
+
+
+namespace GraphEx
+{
+
+// Checkpoints of the structured buffers and the defines of a program wrapper, e.g. to resume a long-running computation after a restart.
+// The buffers are copied to readback memory on the GPU timeline, and written to the file on a worker thread once the copies completed
+class GRAPHEX_EXPORTABLE ProgramCheckpoint final
+{
+public:
+    explicit ProgramCheckpoint(Falcor::ref<ProgramWrapper> pWrapper);
+    // Waits for the pending checkpoint
+    ~ProgramCheckpoint();
+
+    ProgramCheckpoint(const ProgramCheckpoint&) = delete;
+    ProgramCheckpoint& operator=(const ProgramCheckpoint&) = delete;
+
+    // Returns false if the previous checkpoint is still pending
+    bool begin(const std::filesystem::path& filePath);
+    // Call this once per frame while a checkpoint is pending
+    void update(bool wait = false);
+    bool isPending() const;
+    // Updates the pending checkpoint, and begins a new one if the interval elapsed since the last one began. Call this once per frame
+    void updatePeriodically(const std::filesystem::path& filePath, std::chrono::steady_clock::duration interval);
+
+    // Buffers missing from the checkpoint are left as they are
+    static bool restore(ProgramWrapper& wrapper, const std::filesystem::path& filePath);
+
+private:
+    static constexpr std::string_view MAGIC{ "GXCHKPT", 8 };  // Including the terminating zero
+
+    struct Buffer
+    {
+        std::string name;
+        uint32_t elementCount = 0;
+        uint32_t structSize = 0;
+        std::string data;
+        Falcor::ref<Falcor::Buffer> pReadbackBuffer;  // Only while the copy is in flight
+
+        template<typename Archive>
+        void serialize(Archive& ar);
+    };
+
+    struct PendingCheckpoint
+    {
+        std::filesystem::path filePath;
+        std::map<std::string, std::string> defines;
+        std::vector<Buffer> buffers;
+        uint64_t fenceValue = 0;
+        std::optional<std::future<bool>> written;  // Once the copies completed
+    };
+
+    static bool write(const PendingCheckpoint& checkpoint);
+
+    Falcor::ref<ProgramWrapper> mpWrapper;
+    Falcor::ref<Falcor::Fence> mpFence;
+    std::unique_ptr<PendingCheckpoint> mpPendingCheckpoint;
+    std::optional<std::chrono::steady_clock::time_point> mLastBeginTime;
+};
+
+} // namespace GraphEx
@@ -6,21 +6,102 @@
 using namespace GraphEx;
 
 
+namespace
+{
+
+std::atomic<uint64_t> sProgramVarsVersionCounter = ProgramVarProvider::UNVERSIONED;
+
+} // namespace
+
+
 void ProgramDefineProvider::addProgramDefines(Falcor::DefineList& defines) const {}
 void ProgramVarProvider::setProgramVars(const Falcor::ShaderVar& var) const {}
 
 
+uint64_t ProgramVarProvider::getProgramVarsVersion() const
+{
+    return UNVERSIONED;
+}
+
+
+uint64_t ProgramVarProvider::getProgramVarsHash() const
+{
+    return 0;
+}
+
+
+uint64_t ProgramVarProvider::makeProgramVarsVersion()
+{
+    return ++sProgramVarsVersionCounter;
+}
+
+
+VersionedProgramVarProvider::VersionedProgramVarProvider()
+    : mProgramVarsVersion(makeProgramVarsVersion()) {}
+
+
+VersionedProgramVarProvider::VersionedProgramVarProvider(const VersionedProgramVarProvider& other)
+    : ProgramVarProvider(other)
+    , mProgramVarsVersion(makeProgramVarsVersion()) {}
+
+
+VersionedProgramVarProvider& VersionedProgramVarProvider::operator=(const VersionedProgramVarProvider& other)
+{
+    ProgramVarProvider::operator=(other);
+    bumpProgramVarsVersion();
+    return *this;
+}
+
+
+uint64_t VersionedProgramVarProvider::getProgramVarsVersion() const
+{
+    return mProgramVarsVersion;
+}
+
+
+void VersionedProgramVarProvider::bumpProgramVarsVersion()
+{
+    mProgramVarsVersion = makeProgramVarsVersion();
+}
+
+
+#ifdef _DEBUG
+bool ProgramVarsUpload::sVerifySkipped = true;
+#else
+bool ProgramVarsUpload::sVerifySkipped = false;
+#endif
+
+
+bool ProgramVarsUpload::update(const ProgramVarProvider& varProvider)
+{
+    const auto version = varProvider.getProgramVarsVersion();
+
+    if (version != ProgramVarProvider::UNVERSIONED && version == mVersion)
+    {
+        if (!sVerifySkipped || !mHash || varProvider.getProgramVarsHash() == *mHash)
+        {
+            return false;
+        }
+
+        Falcor::logWarning("ProgramVarsUpload: The data of a provider changed without its version, it must be bumped by every change.");
+    }
+
+    mVersion = version;
+    mHash = sVerifySkipped ? std::make_optional(varProvider.getProgramVarsHash()) : std::nullopt;
+
+    return true;
+}
+
+
 void ProgramVarProvider::trySetProgramVarsFor(
     const Falcor::ShaderVar& var,
     const std::string& memberName,
     const ProgramVarProvider& varProvider
 ) {
-    if (!var.hasMember(memberName))
+    if (const auto member = var.findMember(memberName); member.isValid())
     {
-        return;
+        varProvider.setProgramVars(member);
     }
-
-    varProvider.setProgramVars(var[memberName]);
 }
 
 
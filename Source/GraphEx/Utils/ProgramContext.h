@@ -3,6 +3,23 @@
 #include "Standard.h"
 
 
+// Setters of data a VersionedProgramVarProvider sets, which bump its version
+#define VERSIONED_SETTER_DEFINITION(name, member, ...) \
+    __VA_ARGS__ void set##name(decltype(member) value)\
+    {\
+        member = std::move(value);\
+        bumpProgramVarsVersion();\
+    }
+
+#define DEFAULT_CONST_GETTER_VERSIONED_SETTER_DEFINITION(name, member, ...) \
+    DEFAULT_CONST_GETTER_DEFINITION(name, member, __VA_ARGS__)    \
+    VERSIONED_SETTER_DEFINITION(name, member, __VA_ARGS__)
+
+#define DEFAULT_CONST_GETREF_VERSIONED_SETTER_DEFINITION(name, member, ...) \
+    DEFAULT_CONST_GETREF_DEFINITION(name, member, __VA_ARGS__)    \
+    VERSIONED_SETTER_DEFINITION(name, member, __VA_ARGS__)
+
+
 namespace GraphEx
 {
 class GRAPHEX_EXPORTABLE ProgramWrapper;
@@ -30,28 +47,99 @@ struct GRAPHEX_EXPORTABLE ProgramIncludeProvider : ProgramDefineProvider
 
 struct GRAPHEX_EXPORTABLE ProgramVarProvider
 {
+    static constexpr uint64_t UNVERSIONED = 0;
+
     virtual ~ProgramVarProvider() = default;
     virtual void setProgramVars(const Falcor::ShaderVar& var) const;
 
+    // Changes whenever the data set by setProgramVars changes. Versions are unique across all providers, so a provider that takes its
+    // data from another one (e.g. the global light) can return its version as is. The vars of unversioned providers are set for every
+    // draw and dispatch, the vars of versioned ones only if their version changed since they were last set on the same program vars
+    virtual uint64_t getProgramVarsVersion() const;
+    // Hash of the data set by setProgramVars, to verify that the data of skipped providers did not change without their version
+    virtual uint64_t getProgramVarsHash() const;
+
     static void trySetProgramVarsFor(const Falcor::ShaderVar& var, const std::string& memberName, const ProgramVarProvider& varProvider);
 
     template<typename T>
     static void trySetProgramVar(const Falcor::ShaderVar& var, const std::string& memberName, const T& memberValue);
+
+    template<typename... Ts>
+    static uint64_t hashProgramVarData(const Ts&... values);
+
+protected:
+    static uint64_t makeProgramVarsVersion();
+};
+
+
+// Provider whose version is bumped by the setters of its data, see VERSIONED_SETTER_DEFINITION
+struct GRAPHEX_EXPORTABLE VersionedProgramVarProvider : ProgramVarProvider
+{
+    VersionedProgramVarProvider();
+    // Copies take a version of their own, as they change independently from then on
+    VersionedProgramVarProvider(const VersionedProgramVarProvider& other);
+    VersionedProgramVarProvider& operator=(const VersionedProgramVarProvider& other);
+
+    uint64_t getProgramVarsVersion() const override;
+
+protected:
+    void bumpProgramVarsVersion();
+
+private:
+    uint64_t mProgramVarsVersion;
 };
 
 
 template<typename T>
 void ProgramVarProvider::trySetProgramVar(const Falcor::ShaderVar& var, const std::string& memberName, const T& memberValue)
 {
-    if (!var.hasMember(memberName))
+    // A single lookup, instead of checking for the member and then looking it up again
+    if (auto member = var.findMember(memberName); member.isValid())
     {
-        return;
+        member = memberValue;
     }
+}
+
+
+template<typename... Ts>
+uint64_t ProgramVarProvider::hashProgramVarData(const Ts&... values)
+{
+    static_assert((std::is_trivially_copyable_v<Ts> && ...), "Only plain data can be hashed bytewise");
+
+    // 64-bit FNV-1a over the bytes of the values
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    const auto hashBytes = [&hash](const auto& value) {
+        const auto pBytes = reinterpret_cast<const uint8_t*>(&value);
+
+        for (size_t i = 0; i < sizeof(value); ++i)
+        {
+            hash ^= pBytes[i];
+            hash *= 0x100000001B3ull;
+        }
+    };
 
-    var[memberName] = memberValue;
+    (hashBytes(values), ...);
+    return hash;
 }
 
 
+// The vars of a provider last set on a member, so that they are not set again while the provider's version did not change. Since versions
+// are unique, this also tells whether another provider's vars were set there since
+struct GRAPHEX_EXPORTABLE ProgramVarsUpload
+{
+    // Returns whether the vars of the provider have to be set, and takes them as set
+    bool update(const ProgramVarProvider& varProvider);
+
+    // Sets the vars of skipped providers anyway if their data changed without their version, and warns about it
+    static bool sVerifySkipped;
+
+private:
+    uint64_t mVersion = ProgramVarProvider::UNVERSIONED;
+    std::optional<uint64_t> mHash;  // Only while verifying
+};
+
+
 struct GRAPHEX_EXPORTABLE ProgramContextProvider : ProgramDefineProvider, ProgramVarProvider {};
 struct GRAPHEX_EXPORTABLE ProgramIncludedContextProvider : ProgramIncludeProvider, ProgramVarProvider {};
 
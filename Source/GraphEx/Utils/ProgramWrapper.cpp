@@ -1,15 +1,122 @@
 #include "ProgramWrapper.h"
 
+#include "../Serialization/Serialization.h"
+
 
 using namespace GraphEx;
 
 
+std::unordered_set<ProgramWrapper*> ProgramWrapper::sCompilingWrappers;
+CompilationMutex ProgramWrapper::sCompilationMutex;
+
+
+namespace
+{
+
+// Of the calling thread, there is a single compilation mutex
+thread_local uint32_t sCompilationLockCount = 0;
+
+
+// The shader files and entry points of the program
+std::string makeGpuTimingLabel(const Falcor::ProgramDesc& desc)
+{
+    std::string label;
+
+    for (const auto& group : desc.entryPointGroups)
+    {
+        const auto& shaderModule = desc.shaderModules.at(group.shaderModuleIndex);
+        const auto fileName = shaderModule.sources.empty() ? shaderModule.name : shaderModule.sources.front().path.filename().string();
+
+        for (const auto& entryPoint : group.entryPoints)
+        {
+            label += (label.empty() ? "" : ", ") + fileName + ":" + entryPoint.name;
+        }
+    }
+
+    return label;
+}
+
+} // namespace
+
+
+void CompilationMutex::lock()
+{
+    mMutex.lock();
+    ++sCompilationLockCount;
+}
+
+
+void CompilationMutex::unlock()
+{
+    --sCompilationLockCount;
+    mMutex.unlock();
+}
+
+
+bool CompilationMutex::try_lock()
+{
+    if (!mMutex.try_lock())
+    {
+        return false;
+    }
+
+    ++sCompilationLockCount;
+    return true;
+}
+
+
+bool CompilationMutex::isHeld() const
+{
+    return sCompilationLockCount > 0;
+}
+
+
+ProgramVarHandle::ProgramVarHandle(const std::string_view path)
+    : mPath(path)
+{
+    for (size_t begin = 0; begin <= path.size();)
+    {
+        const auto end = std::min(path.find('.', begin), path.size());
+        mMemberNames.emplace_back(path.substr(begin, end - begin));
+        begin = end + 1;
+    }
+}
+
+
+Falcor::ShaderVar ProgramVarHandle::resolve(const Falcor::ref<Falcor::ProgramVars>& pVars)
+{
+    if (pVars == mpResolvedVars)
+    {
+        return mVar;
+    }
+
+    auto var = pVars->getRootVar();
+
+    for (const auto& memberName : mMemberNames)
+    {
+        if (var = var.findMember(memberName); !var.isValid())
+        {
+            break;
+        }
+    }
+
+    mpResolvedVars = pVars;
+    mVar = var;
+    mUpload = { };
+
+    return mVar;
+}
+
+
 ProgramWrapper::ProgramWrapper(Falcor::ref<Falcor::Device> pDevice)
     : mpDevice(std::move(pDevice)) {}
 
 
 ProgramWrapper::~ProgramWrapper()
 {
+    // The compilation in flight is waited for along with the pending compilation
+    sCompilingWrappers.erase(this);
+
     while (!mContextProviders.empty())
     {
         (*mContextProviders.begin())->releaseProgram(this);
@@ -20,26 +127,73 @@ ProgramWrapper::~ProgramWrapper()
 void ProgramWrapper::allocateStructuredBuffer(const std::string& name, const uint32_t nElements, const void* pInitData, size_t initDataSize)
 {
     FALCOR_CHECK(mpCachedVars, "ProgramWrapper: ProgramVars was not created");
-    mStructuredBuffers[name] = mpDevice->createStructuredBuffer(mpCachedVars->getRootVar()[name], nElements);
+    auto pBuffer = mpDevice->createStructuredBuffer(mpCachedVars->getRootVar()[name], nElements);
 
-    if (!pInitData)
+    // The previous buffer is kept if the data does not fit, e.g. when restoring a checkpoint of a program that changed since
+    if (pInitData)
     {
-        return;
+        const auto expectedDataSize = pBuffer->getStructSize() * pBuffer->getElementCount();
+
+        if (initDataSize == 0)
+        {
+            initDataSize = expectedDataSize;
+        }
+        else if (initDataSize != expectedDataSize)
+        {
+            FALCOR_THROW("ProgramWrapper: StructuredBuffer '" + name + "' initial data size mismatch.");
+        }
+
+        pBuffer->setBlob(pInitData, 0, initDataSize);
+    }
+
+    mStructuredBuffers[name] = std::move(pBuffer);
+}
+
+
+void ProgramWrapper::allocateStructuredBuffer(const std::string& name, const uint32_t nElements, const BlobData& initData)
+{
+    allocateStructuredBuffer(name, nElements, initData.empty() ? nullptr : initData.getData(), initData.getSize());
+}
+
+
+void ProgramWrapper::updateStructuredBuffer(
+    const std::string& name,
+    const uint32_t nElements,
+    const void* pData,
+    const size_t dataSize,
+    const uint32_t firstElement
+) {
+    FALCOR_CHECK(mpCachedVars, "ProgramWrapper: ProgramVars was not created");
+
+    const auto pRenderContext = mpDevice->getRenderContext();
+    auto& pBuffer = mStructuredBuffers[name];
+
+    if (!pBuffer || pBuffer->getElementCount() < nElements)
+    {
+        const auto elementCount = pBuffer ? std::max(nElements, pBuffer->getElementCount() * 2) : nElements;
+        auto pGrownBuffer = mpDevice->createStructuredBuffer(mpCachedVars->getRootVar()[name], elementCount);
+
+        if (pBuffer)
+        {
+            pRenderContext->copyBufferRegion(pGrownBuffer.get(), 0, pBuffer.get(), 0, pBuffer->getSize());
+        }
+
+        pBuffer = std::move(pGrownBuffer);
     }
 
-    const auto& buffer = mStructuredBuffers[name];
-    const auto expectedDataSize = buffer->getStructSize() * buffer->getElementCount();
+    const auto offset = static_cast<uint64_t>(firstElement) * pBuffer->getStructSize();
 
-    if (initDataSize == 0)
+    if (dataSize % pBuffer->getStructSize() != 0 || offset + dataSize > pBuffer->getSize())
     {
-        initDataSize = expectedDataSize;
+        FALCOR_THROW("ProgramWrapper: StructuredBuffer '" + name + "' update data size mismatch.");
     }
-    else if (initDataSize != expectedDataSize)
+
+    if (!mpUploadRing)
     {
-        FALCOR_THROW("ProgramWrapper: StructuredBuffer '" + name + "' initial data size mismatch.");
+        mpUploadRing = std::make_unique<UploadRing>(mpDevice);
     }
 
-    buffer->setBlob(pInitData, 0, initDataSize);
+    mpUploadRing->upload(pRenderContext, pBuffer, offset, pData, dataSize);
 }
 
 
@@ -49,6 +203,14 @@ Falcor::ShaderVar ProgramWrapper::operator[](const std::string& name)
 }
 
 
+Falcor::ShaderVar ProgramWrapper::operator[](ProgramVarHandle& handle)
+{
+    auto var = handle.resolve(getVars());
+    FALCOR_CHECK(var.isValid(), "ProgramWrapper: Couldn't find program var by path: " + handle.getPath());
+    return var;
+}
+
+
 void ProgramWrapper::addDefine(const std::string& name, const std::string& value)
 {
     mDefines.add(name, value);
@@ -80,17 +242,121 @@ void ProgramWrapper::addContextProvider(BindableProgramContextProvider* pContext
 void ProgramWrapper::removeContextProvider(BindableProgramContextProvider* pContextProvider)
 {
     mContextProviders.erase(pContextProvider);
+    mUploads.erase(pContextProvider);
     setNeedsUpdateDefines();
 }
 
 
 void ProgramWrapper::updateDefines(const bool force)
 {
-    if (!force && !mDirty)
+    if (force || mDirty)
     {
-        return;
+        switchVariant(collectDefines(), false);
     }
+}
+
 
+void ProgramWrapper::updateVars(Falcor::ShaderVar& vars) const
+{
+    for (const auto& pContextProvider : mContextProviders)
+    {
+        // The vars set on another variant are not in these
+        auto& [ pUploadedVars, upload ] = mUploads[pContextProvider];
+
+        if (pUploadedVars != mpCachedVars.get())
+        {
+            pUploadedVars = mpCachedVars.get();
+            upload = { };
+        }
+
+        if (upload.update(*pContextProvider))
+        {
+            pContextProvider->setProgramVars(vars);
+        }
+    }
+}
+
+
+void ProgramWrapper::setProgramVarsFor(ProgramVarHandle& handle, const ProgramVarProvider& varProvider)
+{
+    if (const auto var = handle.resolve(getVars()); var.isValid() && handle.mUpload.update(varProvider))
+    {
+        varProvider.setProgramVars(var);
+    }
+}
+
+
+void ProgramWrapper::setNeedsUpdateDefines()
+{
+    mDirty = true;
+}
+
+
+bool ProgramWrapper::isCompiling() const
+{
+    return mpPendingCompilation != nullptr;
+}
+
+
+void ProgramWrapper::waitForCompilation()
+{
+    // Finishing may start compiling the defines that changed meanwhile, in the background again
+    while (mpPendingCompilation)
+    {
+        finishCompilation();
+    }
+
+    switchVariant(collectDefines(), true);
+}
+
+
+void ProgramWrapper::finishCompilations()
+{
+    // Finishing a compilation may start the next one, which is only finished in a later frame
+    const auto wrappers = std::vector(sCompilingWrappers.begin(), sCompilingWrappers.end());
+
+    for (const auto pWrapper : wrappers)
+    {
+        if (pWrapper->mpPendingCompilation->compiled.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            pWrapper->finishCompilation();
+        }
+    }
+}
+
+
+size_t ProgramWrapper::getCompilationCount()
+{
+    return sCompilingWrappers.size();
+}
+
+
+CompilationMutex& ProgramWrapper::getCompilationMutex()
+{
+    return sCompilationMutex;
+}
+
+
+bool ProgramWrapper::shouldSkipWhileCompiling() const
+{
+    return mSkipWhileCompiling && isCompiling();
+}
+
+
+std::unique_lock<CompilationMutex> ProgramWrapper::lockForFirstUse()
+{
+    if (!mpActiveVariant || mpActiveVariant->used)
+    {
+        return { };
+    }
+
+    mpActiveVariant->used = true;
+    return std::unique_lock(sCompilationMutex);
+}
+
+
+Falcor::DefineList ProgramWrapper::collectDefines() const
+{
     auto defines = mDefines;
 
     for (const auto& pContextProvider : mContextProviders)
@@ -98,32 +364,212 @@ void ProgramWrapper::updateDefines(const bool force)
         pContextProvider->addProgramDefines(defines);
     }
 
-    mpProgram->setDefines(defines);
+    return defines;
+}
+
+
+void ProgramWrapper::switchVariant(const Falcor::DefineList& defines, const bool wait)
+{
     mDirty = false;
 
-    // Must recache program vars. New defines may have added new shader components that define new vars
+    // The first variant has nothing to fall back to
+    if (wait || !mAsyncCompilation || !mpCachedVars)
+    {
+        if (!activateVariant(defines))
+        {
+            mpProgram->setDefines(defines);
+
+            // Must recache program vars. New defines may have added new shader components that define new vars
+            cacheProgramVars();
+        }
+
+        return;
+    }
+
+    if (mpProgram->getDefines() == defines || defines == mFailedDefines || activateVariant(defines))
+    {
+        return;
+    }
+
+    // One compilation at a time, the latest defines are compiled once the one in flight completed
+    if (mpPendingCompilation)
+    {
+        mDirty = mpPendingCompilation->outdated || mpPendingCompilation->defines != defines;
+        return;
+    }
+
+    // The program is created here, only compiling and linking it is left to the worker
+    auto pCompilation = std::make_unique<PendingCompilation>();
+    pCompilation->defines = defines;
+
+    {
+        std::lock_guard lock(sCompilationMutex);
+        pCompilation->pProgram = Falcor::Program::create(mpDevice, mpProgram->getDesc(), defines);
+    }
+
+    pCompilation->compiled = std::async(std::launch::async, [pProgram = pCompilation->pProgram.get()] {
+        std::lock_guard lock(sCompilationMutex);
+        pProgram->getActiveVersion();
+    });
+
+    mpPendingCompilation = std::move(pCompilation);
+    sCompilingWrappers.insert(this);
+}
+
+
+bool ProgramWrapper::activateVariant(const Falcor::DefineList& defines)
+{
+    const auto definesHash = hashDefines(defines);
+
+    const auto itVariant = std::find_if(mVariants.begin(), mVariants.end(), [&](const ProgramVariant& variant) {
+        return variant.definesHash == definesHash && variant.defines == defines;
+    });
+
+    if (itVariant == mVariants.end())
+    {
+        return false;
+    }
+
+    const auto programChanged = itVariant->pProgram != mpProgram;
+    mpProgram = itVariant->pProgram;
+
+    // The program may have been switched to other defines since, it still has the linked version of these
+    if (mpProgram->getDefines() != defines)
+    {
+        mpProgram->setDefines(defines);
+    }
+
     cacheProgramVars();
+
+    if (programChanged)
+    {
+        onActiveProgramChanged();
+    }
+
+    return true;
 }
 
 
-void ProgramWrapper::updateVars(Falcor::ShaderVar& vars) const
+void ProgramWrapper::addVariant(const uint64_t definesHash, const Falcor::DefineList& defines, const Falcor::ref<Falcor::Program>& pProgram)
 {
-    for (const auto& pContextProvider : mContextProviders)
+    FALCOR_ASSERT(sCompilationMutex.isHeld());
+
+    mVariants.push_front({ definesHash, defines, pProgram, Falcor::ProgramVars::create(mpDevice, pProgram->getReflector()) });
+
+    if (mVariants.size() > MAX_CACHED_VARIANTS)
     {
-        pContextProvider->setProgramVars(vars);
+        // Other vars may take the address of the dropped ones
+        for (auto it = mUploads.begin(); it != mUploads.end();)
+        {
+            it = it->second.first == mVariants.back().pVars.get() ? mUploads.erase(it) : std::next(it);
+        }
+
+        if (mpActiveVariant == &mVariants.back())
+        {
+            mpActiveVariant = nullptr;
+        }
+
+        mVariants.pop_back();
     }
 }
 
 
-void ProgramWrapper::setNeedsUpdateDefines()
+void ProgramWrapper::finishCompilation()
 {
-    mDirty = true;
+    const auto pCompilation = std::move(mpPendingCompilation);
+    sCompilingWrappers.erase(this);
+
+    try
+    {
+        pCompilation->compiled.get();
+
+        if (!pCompilation->outdated)
+        {
+            std::lock_guard lock(sCompilationMutex);
+            addVariant(hashDefines(pCompilation->defines), pCompilation->defines, pCompilation->pProgram);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        if (!pCompilation->outdated)
+        {
+            mFailedDefines = pCompilation->defines;
+            Falcor::logError("ProgramWrapper: Failed to compile program variant, the previous one is kept:\n{}", e.what());
+        }
+    }
+
+    // The defines may have changed again while it compiled, the variant to use is chosen anew
+    setNeedsUpdateDefines();
+    updateDefines();
 }
 
 
 void ProgramWrapper::cacheProgramVars()
 {
-    mpCachedVars = Falcor::ProgramVars::create(mpDevice, mpProgram->getReflector());
+    // Switching back to a recent variant is a lookup, instead of linking the program and creating its vars again
+    const auto& defines = mpProgram->getDefines();
+    const auto definesHash = hashDefines(defines);
+
+    // Linking the program may compile it
+    std::lock_guard lock(sCompilationMutex);
+
+    const auto itVariant = std::find_if(mVariants.begin(), mVariants.end(), [&](const ProgramVariant& variant) {
+        return variant.pProgram == mpProgram && variant.definesHash == definesHash && variant.defines == defines;
+    });
+
+    mActiveDefinesHash = definesHash;
+
+    if (itVariant != mVariants.end())
+    {
+        mVariants.splice(mVariants.begin(), mVariants, itVariant);
+        mpCachedVars = itVariant->pVars;
+        mpActiveVariant = &*itVariant;
+        return;
+    }
+
+    addVariant(definesHash, defines, mpProgram);
+    mpCachedVars = mVariants.front().pVars;
+    mpActiveVariant = &mVariants.front();
+}
+
+
+void ProgramWrapper::clearVariantCache()
+{
+    mpActiveVariant = nullptr;
+    mVariants.clear();
+    mUploads.clear();
+    mFailedDefines.reset();
+
+    if (mpPendingCompilation)
+    {
+        mpPendingCompilation->outdated = true;
+    }
+}
+
+
+uint64_t ProgramWrapper::hashDefines(const Falcor::DefineList& defines)
+{
+    // 64-bit FNV-1a over the defines in their (sorted) order, separated so that moving characters between names and values matters
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    const auto hashString = [&hash](const std::string& string) {
+        for (const auto c : string)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001B3ull;
+        }
+
+        hash ^= 0xFF;
+        hash *= 0x100000001B3ull;
+    };
+
+    for (const auto& [ name, value ] : defines)
+    {
+        hashString(name);
+        hashString(value);
+    }
+
+    return hash;
 }
 
 
@@ -144,6 +590,12 @@ void ProgramWrapper::setProgram(Falcor::ref<Falcor::Program> pProgram, Falcor::D
 {
     mpProgram = std::move(pProgram);
     mDefines = std::move(defines);
+    clearVariantCache();
+
+    if (mpGpuTimeRecorder)
+    {
+        mpGpuTimeRecorder->setLabel(makeGpuTimingLabel(mpProgram->getDesc()));
+    }
 
     if (createProgramVars)
     {
@@ -152,6 +604,48 @@ void ProgramWrapper::setProgram(Falcor::ref<Falcor::Program> pProgram, Falcor::D
 }
 
 
+BufferReadback& ProgramWrapper::getReadback()
+{
+    if (!mpReadback)
+    {
+        mpReadback = std::make_unique<BufferReadback>(mpDevice);
+    }
+
+    return *mpReadback;
+}
+
+
+void ProgramWrapper::setGpuTiming(const bool enabled)
+{
+    if (!enabled)
+    {
+        mpGpuTimeRecorder.reset();
+    }
+    else if (!mpGpuTimeRecorder)
+    {
+        mpGpuTimeRecorder = std::make_unique<GpuTimeRecorder>(mpDevice, mpProgram ? makeGpuTimingLabel(mpProgram->getDesc()) : "");
+    }
+}
+
+
+bool ProgramWrapper::getGpuTiming() const
+{
+    return mpGpuTimeRecorder != nullptr;
+}
+
+
+bool ProgramWrapper::beginGpuTiming()
+{
+    return mpGpuTimeRecorder && mpGpuTimeRecorder->begin(mActiveDefinesHash);
+}
+
+
+void ProgramWrapper::endGpuTiming()
+{
+    mpGpuTimeRecorder->end();
+}
+
+
 void ProgramWrapper::unmapStructuredBuffer(const std::string& name) const
 {
     FALCOR_CHECK(mStructuredBuffers.find(name) != mStructuredBuffers.end(), "ProgramWrapper: Couldn't find buffer by name: " + name);
@@ -172,11 +666,95 @@ ComputeProgramWrapper::ComputeProgramWrapper(Falcor::ref<Falcor::Device> pDevice
 
 void ComputeProgramWrapper::runProgram(const Falcor::uint3& dimensions)
 {
-    auto& pDevice = getDevice();
-    auto& pVars = getVars();
+    if (const auto pVars = prepareDispatch())
+    {
+        const auto groups = getThreadGroupCount(dimensions);
+        const auto lock = lockForFirstUse();
+        const auto timed = beginGpuTiming();
+
+        getDevice()->getRenderContext()->dispatch(mpState.get(), pVars, groups);
+
+        if (timed)
+        {
+            endGpuTiming();
+        }
+    }
+}
+
+
+void ComputeProgramWrapper::runProgramIndirect(const Falcor::ref<Falcor::Buffer>& pArgBuffer, const uint64_t argBufferOffset)
+{
+    FALCOR_CHECK(pArgBuffer, "ComputeProgramWrapper: Attempted to run compute program indirectly, but no argument buffer was given");
+
+    if (const auto pVars = prepareDispatch())
+    {
+        const auto lock = lockForFirstUse();
+        const auto timed = beginGpuTiming();
+
+        getDevice()->getRenderContext()->dispatchIndirect(mpState.get(), pVars, pArgBuffer.get(), argBufferOffset);
+
+        if (timed)
+        {
+            endGpuTiming();
+        }
+    }
+}
+
+
+void ComputeProgramWrapper::runProgramBatch(
+    const std::vector<Falcor::uint3>& dimensions,
+    const std::function<void(const Falcor::ShaderVar& rootVar, size_t dispatchIndex)>& setDispatchVars
+) {
+    const auto pVars = prepareDispatch();
+
+    if (!pVars)
+    {
+        return;
+    }
+
+    // Checked up front, so that either all of the dispatches are recorded or none of them
+    std::vector<Falcor::uint3> groupCounts;
+    groupCounts.reserve(dimensions.size());
+
+    for (const auto& dispatchDimensions : dimensions)
+    {
+        groupCounts.push_back(getThreadGroupCount(dispatchDimensions));
+    }
+
+    const auto pRenderContext = getDevice()->getRenderContext();
+    const auto rootVar = pVars->getRootVar();
+    const auto timed = beginGpuTiming();
+
+    for (size_t i = 0; i < groupCounts.size(); ++i)
+    {
+        if (setDispatchVars)
+        {
+            setDispatchVars(rootVar, i);
+        }
+
+        // Not held while the callback runs, which may compile programs itself
+        const auto lock = lockForFirstUse();
+        pRenderContext->dispatch(mpState.get(), pVars, groupCounts[i]);
+    }
+
+    if (timed)
+    {
+        endGpuTiming();
+    }
+}
+
+
+Falcor::ProgramVars* ComputeProgramWrapper::prepareDispatch()
+{
+    const auto& pVars = getVars();
 
     FALCOR_CHECK(pVars, "ComputeProgramWrapper: Attempted to run compute program, but ProgramVars were not created for it");
 
+    if (shouldSkipWhileCompiling())
+    {
+        return nullptr;
+    }
+
     auto rootVar = pVars->getRootVar();
     updateVars(rootVar);
 
@@ -185,14 +763,20 @@ void ComputeProgramWrapper::runProgram(const Falcor::uint3& dimensions)
         pVars->setBuffer(name, pBuffer);
     }
 
+    return pVars.get();
+}
+
+
+Falcor::uint3 ComputeProgramWrapper::getThreadGroupCount(const Falcor::uint3& dimensions) const
+{
     const auto groups = Falcor::div_round_up(dimensions, mThreadGroupSize);
 
-    if (any(groups > pDevice->getLimits().maxComputeDispatchThreadGroups))
+    if (any(groups > getDevice()->getLimits().maxComputeDispatchThreadGroups))
     {
         FALCOR_THROW("ComputeProgramWrapper: Attempted to run compute program, but dispatch dimensions exceed maximum");
     }
 
-    pDevice->getRenderContext()->dispatch(mpState.get(), pVars.get(), groups);
+    return groups;
 }
 
 
@@ -211,6 +795,7 @@ void ComputeProgramWrapper::recreateProgram(
     const bool createProgramVars
 ) {
     const auto& pDevice = getDevice();
+    const auto  lock = std::unique_lock(getCompilationMutex());
     const auto  pProgram = Falcor::Program::createCompute(pDevice, path, csEntry, { }, flags, shaderModel);
 
     setProgram(pProgram, programDefines, createProgramVars);
@@ -224,6 +809,7 @@ void ComputeProgramWrapper::recreateProgram(
     const bool createProgramVars
 ) {
     const auto& pDevice = getDevice();
+    const auto  lock = std::unique_lock(getCompilationMutex());
     const auto  pProgram = Falcor::Program::create(pDevice, desc, { });
 
     setProgram(pProgram, programDefines, createProgramVars);
@@ -231,11 +817,21 @@ void ComputeProgramWrapper::recreateProgram(
 }
 
 
+void ComputeProgramWrapper::onActiveProgramChanged()
+{
+    mpState->setProgram(getProgram());
+}
+
+
 void ComputeProgramWrapper::cacheProgramVars()
 {
     ProgramWrapper::cacheProgramVars();
 
-    mThreadGroupSize = getProgram()->getReflector()->getThreadGroupSize();
+    {
+        std::lock_guard lock(getCompilationMutex());
+        mThreadGroupSize = getProgram()->getReflector()->getThreadGroupSize();
+    }
+
     FALCOR_CHECK(
         mThreadGroupSize.x >= 1 && mThreadGroupSize.y >= 1 && mThreadGroupSize.z >= 1, "ComputeProgramWrapper: Invalid thread group size"
     );
@@ -273,6 +869,12 @@ GraphicsProgramWrapper::GraphicsProgramWrapper(Falcor::ref<Falcor::Device> pDevi
     : ProgramWrapper(std::move(pDevice)), mpState(Falcor::GraphicsState::create(getDevice())) {}
 
 
+void GraphicsProgramWrapper::onActiveProgramChanged()
+{
+    mpState->setProgram(getProgram());
+}
+
+
 Falcor::ref<Falcor::Vao> GraphicsProgramWrapper::getVao() const
 {
     return mpState->getVao();
@@ -321,6 +923,11 @@ void GraphicsProgramWrapper::draw(
 
     FALCOR_CHECK(pVars, "GraphicsProgramWrapper: Attempted to draw with graphics program, but ProgramVars were not created for it");
 
+    if (shouldSkipWhileCompiling())
+    {
+        return;
+    }
+
     auto rootVar = pVars->getRootVar();
 
     updateVars(rootVar);
@@ -331,7 +938,15 @@ void GraphicsProgramWrapper::draw(
         setFbo(pFbo, true);
     }
 
+    const auto lock = lockForFirstUse();
+    const auto timed = beginGpuTiming();
+
     pRenderContext->draw(mpState.get(), pVars.get(), vertexCount, startVertexLocation);
+
+    if (timed)
+    {
+        endGpuTiming();
+    }
 }
 
 
@@ -346,6 +961,11 @@ void GraphicsProgramWrapper::drawIndexed(
 
     FALCOR_CHECK(pVars, "GraphicsProgramWrapper: Attempted to draw with graphics program, but ProgramVars were not created for it");
 
+    if (shouldSkipWhileCompiling())
+    {
+        return;
+    }
+
     auto rootVar = pVars->getRootVar();
     updateVars(rootVar);
     bindStructuredBuffers();
@@ -355,7 +975,15 @@ void GraphicsProgramWrapper::drawIndexed(
         setFbo(pFbo, true);
     }
 
+    const auto lock = lockForFirstUse();
+    const auto timed = beginGpuTiming();
+
     pRenderContext->drawIndexed(mpState.get(), pVars.get(), indexCount, startIndexLocation, baseVertexLocation);
+
+    if (timed)
+    {
+        endGpuTiming();
+    }
 }
 
 
@@ -381,6 +1009,7 @@ void GraphicsProgramWrapper::recreateProgram(
     const bool createProgramVars
 ) {
     const auto& pDevice = getDevice();
+    const auto  lock = std::unique_lock(getCompilationMutex());
     const auto  pProgram = Falcor::Program::create(pDevice, desc, { });
 
     setProgram(pProgram, programDefines, createProgramVars);
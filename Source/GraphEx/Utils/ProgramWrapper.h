@@ -1,10 +1,52 @@
 #pragma once
 
+#include "BufferReadback.h"
+#include "GpuTimeRecorder.h"
 #include "ProgramContext.h"
+#include "UploadRing.h"
 
 namespace GraphEx
 {
 
+class BlobData;
+
+
+// A member of the program vars by its path (e.g. "VScb.color"), resolved once for each vars it is used with, then accessed at its offset
+class GRAPHEX_EXPORTABLE ProgramVarHandle
+{
+public:
+    explicit ProgramVarHandle(std::string_view path);
+
+    Falcor::ShaderVar resolve(const Falcor::ref<Falcor::ProgramVars>& pVars);
+
+private:
+    std::string mPath;
+    std::vector<std::string> mMemberNames;
+    Falcor::ref<Falcor::ProgramVars> mpResolvedVars;  // Kept alive, so that other vars can't take its address
+    Falcor::ShaderVar mVar;
+    ProgramVarsUpload mUpload;
+
+    friend class ProgramWrapper;
+
+public:
+    DEFAULT_CONST_GETREF_DEFINITION(Path, mPath)
+};
+
+
+// The shader compiler is not thread-safe. Creating, linking and first using a program must hold this while background compilations may run
+class GRAPHEX_EXPORTABLE CompilationMutex
+{
+public:
+    void lock();
+    void unlock();
+    bool try_lock();
+    bool isHeld() const;
+
+private:
+    std::recursive_mutex mMutex;
+};
+
+
 class GRAPHEX_EXPORTABLE ProgramWrapper : public Falcor::Object
 {
 protected:
@@ -15,14 +57,30 @@ public:
     template<typename T>
     std::vector<T> readStructuredBuffer(const std::string& name);
 
+    template<typename T>
+    std::future<std::vector<T>> readStructuredBufferAsync(
+        const std::string& name,
+        std::function<void(const std::vector<T>&)> callback = nullptr
+    );
+
     template<typename T>
     T* mapStructuredBuffer(const std::string& name) const;
 
     void* mapStructuredBufferRaw(const std::string& name) const;
     void  unmapStructuredBuffer(const std::string& name) const;
     void  allocateStructuredBuffer(const std::string& name, uint32_t nElements, const void* pInitData, size_t initDataSize);
+    void  allocateStructuredBuffer(const std::string& name, uint32_t nElements, const BlobData& initData);
+    // Grows the buffer to at least twice its size if it is too small, so it may have more elements than asked for
+    void  updateStructuredBuffer(
+        const std::string& name,
+        uint32_t nElements,
+        const void* pData,
+        size_t dataSize,
+        uint32_t firstElement = 0
+    );
 
     Falcor::ShaderVar operator[](const std::string& name);
+    Falcor::ShaderVar operator[](ProgramVarHandle& handle);
 
     void addDefine(const std::string& name, const std::string& value);
     void addDefines(const Falcor::DefineList& defines);
@@ -33,18 +91,77 @@ public:
 
     void updateDefines(bool force = false);
     void updateVars(Falcor::ShaderVar& vars) const;
+    void setProgramVarsFor(ProgramVarHandle& handle, const ProgramVarProvider& varProvider);
 
     void setNeedsUpdateDefines();
 
+    // With asynchronous compilation, the previous variant is used until the new one is swapped in at the beginning of a frame
+    bool isCompiling() const;
+    void waitForCompilation();
+    static void finishCompilations();
+    static size_t getCompilationCount();
+    static CompilationMutex& getCompilationMutex();
+
     virtual void cacheProgramVars();
+    // E.g. after the shader files were reloaded
+    void clearVariantCache();
+
+    // Each draw and dispatch (or batch of dispatches) is timed for the variant it used, see GpuTimeRecorder
+    void setGpuTiming(bool enabled);
+    bool getGpuTiming() const;
 
 private:
+    static constexpr size_t MAX_CACHED_VARIANTS = 16;
+
+    // Variants compiled in the background have a program of their own
+    struct ProgramVariant
+    {
+        uint64_t definesHash = 0;
+        Falcor::DefineList defines;
+        Falcor::ref<Falcor::Program> pProgram;
+        Falcor::ref<Falcor::ProgramVars> pVars;
+        bool used = false;  // Drawn or dispatched with, so its kernels were created
+    };
+
+    struct PendingCompilation
+    {
+        Falcor::DefineList defines;
+        Falcor::ref<Falcor::Program> pProgram;
+        std::future<void> compiled;
+        bool outdated = false;  // The program was replaced while it compiled
+    };
+
+    Falcor::DefineList collectDefines() const;
+    void switchVariant(const Falcor::DefineList& defines, bool wait);
+    bool activateVariant(const Falcor::DefineList& defines);
+    void addVariant(uint64_t definesHash, const Falcor::DefineList& defines, const Falcor::ref<Falcor::Program>& pProgram);
+    void finishCompilation();
+
+    static uint64_t hashDefines(const Falcor::DefineList& defines);
+
     Falcor::ref<Falcor::Device> mpDevice;
     Falcor::ref<Falcor::Program> mpProgram;
     Falcor::ref<Falcor::ProgramVars> mpCachedVars;
     Falcor::DefineList mDefines;
     std::unordered_set<BindableProgramContextProvider*> mContextProviders;
     std::unordered_map<std::string, Falcor::ref<Falcor::Buffer>> mStructuredBuffers;
+    std::unique_ptr<UploadRing> mpUploadRing;  // Created with the first update
+    std::list<ProgramVariant> mVariants;  // Most recently used first
+    mutable std::unordered_map<const BindableProgramContextProvider*, std::pair<const Falcor::ProgramVars*, ProgramVarsUpload>> mUploads;
+
+    std::unique_ptr<PendingCompilation> mpPendingCompilation;
+    std::optional<Falcor::DefineList> mFailedDefines;
+    bool mAsyncCompilation = false;
+    bool mSkipWhileCompiling = false;
+
+    ProgramVariant* mpActiveVariant = nullptr;
+
+    static std::unordered_set<ProgramWrapper*> sCompilingWrappers;
+    static CompilationMutex sCompilationMutex;
+
+    std::unique_ptr<BufferReadback> mpReadback;  // Created with the first asynchronous read
+    std::unique_ptr<GpuTimeRecorder> mpGpuTimeRecorder;  // While GPU timing is enabled
+    uint64_t mActiveDefinesHash = 0;
 
     bool mDirty = false;
 
@@ -53,12 +170,24 @@ public:
     DEFAULT_CONST_GETREF_DEFINITION(Program, mpProgram)
     DEFAULT_CONST_GETREF_DEFINITION(Defines, mDefines)
     DEFAULT_CONST_GETREF_DEFINITION(StructuredBuffers, mStructuredBuffers)
+    DEFAULT_CONST_GETTER_SETTER_DEFINITION(AsyncCompilation, mAsyncCompilation)
+    DEFAULT_CONST_GETTER_SETTER_DEFINITION(SkipWhileCompiling, mSkipWhileCompiling)
+    DEFAULT_CONST_GETREF_DEFINITION(GpuTimeRecorder, mpGpuTimeRecorder)
 
     const Falcor::ref<Falcor::ProgramVars>& getVars();
     Falcor::ShaderVar getRootVar();
+    BufferReadback& getReadback();
 
 protected:
     void setProgram(Falcor::ref<Falcor::Program> pProgram, Falcor::DefineList defines, bool createProgramVars = true);
+    // Called when a variant with a program of its own was swapped in
+    virtual void onActiveProgramChanged() { }
+    bool shouldSkipWhileCompiling() const;
+    // Unlocked unless it is the first draw or dispatch of the active variant
+    std::unique_lock<CompilationMutex> lockForFirstUse();
+    // Returns whether it began, then it must be ended
+    bool beginGpuTiming();
+    void endGpuTiming();
 };
 
 
@@ -70,6 +199,17 @@ std::vector<T> ProgramWrapper::readStructuredBuffer(const std::string& name)
 }
 
 
+template<typename T>
+std::future<std::vector<T>> ProgramWrapper::readStructuredBufferAsync(
+    const std::string& name,
+    std::function<void(const std::vector<T>&)> callback
+) {
+    FALCOR_CHECK(mStructuredBuffers.find(name) != mStructuredBuffers.end(), "ProgramWrapper: Couldn't find buffer by name: " + name);
+    FALCOR_CHECK(mStructuredBuffers.at(name)->getStructSize() == sizeof(T), "ProgramWrapper: Element size mismatch of buffer: " + name);
+    return getReadback().readElements<T>(mStructuredBuffers.at(name), std::move(callback));
+}
+
+
 template<typename T>
 T* ProgramWrapper::mapStructuredBuffer(const std::string& name) const
 {
@@ -84,6 +224,15 @@ struct GRAPHEX_EXPORTABLE ComputeProgramWrapper final : ProgramWrapper
     void runProgram(const Falcor::uint3& dimensions);
     void runProgram(Falcor::uint width = 1, Falcor::uint height = 1, Falcor::uint depth = 1);
 
+    // The arguments are thread group counts (three uints), not dimensions
+    void runProgramIndirect(const Falcor::ref<Falcor::Buffer>& pArgBuffer, uint64_t argBufferOffset = 0);
+
+    // The vars and buffers are bound once, the callback sets what differs between the dispatches
+    void runProgramBatch(
+        const std::vector<Falcor::uint3>& dimensions,
+        const std::function<void(const Falcor::ShaderVar& rootVar, size_t dispatchIndex)>& setDispatchVars = nullptr
+    );
+
     void recreateProgram(
         const std::filesystem::path& path,
         const std::string& csEntry = "main",
@@ -101,6 +250,14 @@ struct GRAPHEX_EXPORTABLE ComputeProgramWrapper final : ProgramWrapper
 
     void cacheProgramVars() override;
 
+protected:
+    void onActiveProgramChanged() override;
+
+private:
+    Falcor::ProgramVars* prepareDispatch();
+    Falcor::uint3 getThreadGroupCount(const Falcor::uint3& dimensions) const;
+
+public:
     static Falcor::ref<ComputeProgramWrapper> create(
         const Falcor::ref<Falcor::Device>& pDevice,
         const std::filesystem::path& path,
@@ -187,6 +344,9 @@ struct GRAPHEX_EXPORTABLE GraphicsProgramWrapper final : ProgramWrapper
         bool createProgramVars = true
     );
 
+protected:
+    void onActiveProgramChanged() override;
+
 private:
     Falcor::ref<Falcor::GraphicsState> mpState;
 
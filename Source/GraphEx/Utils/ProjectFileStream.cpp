@@ -0,0 +1,369 @@
+#include "ProjectFileStream.h"
+
+#if FALCOR_WINDOWS
+#include <Windows.h>
+#elif FALCOR_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+using namespace GraphEx;
+
+
+bool GraphEx::syncFileToDisk(const std::filesystem::path& filePath)
+{
+#if FALCOR_WINDOWS
+    // The file may still be open elsewhere, like a sidecar that is appended to and mapped for reading
+    const auto handle = CreateFileW(filePath.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    const auto success = FlushFileBuffers(handle) != 0;
+    CloseHandle(handle);
+    return success;
+#elif FALCOR_LINUX
+    const auto fd = ::open(filePath.c_str(), O_WRONLY);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    const auto success = ::fsync(fd) == 0;
+    ::close(fd);
+    return success;
+#else
+    return true;
+#endif
+}
+
+
+void GraphEx::writeUInt64(std::ostream& os, const uint64_t value)
+{
+    std::array<char, sizeof(uint64_t)> bytes{ };
+
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+
+    os.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+
+std::optional<uint64_t> GraphEx::readUInt64(std::istream& is)
+{
+    std::array<unsigned char, sizeof(uint64_t)> bytes{ };
+
+    if (!is.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+    {
+        return std::nullopt;
+    }
+
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+
+    return value;
+}
+
+
+ProjectFileWriter::ProjectFileWriter(std::filesystem::path filePath, const size_t bufferSize)
+    : mFilePath(std::move(filePath))
+    , mBuffer(bufferSize)
+{
+    // Same directory as the destination, so that the final rename never crosses file systems
+    mTempFilePath = mFilePath;
+    mTempFilePath += ".saving";
+
+    // The buffer must be installed before the file is opened to take effect
+    mStream.rdbuf()->pubsetbuf(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+    mStream.open(mTempFilePath, std::ios::out | std::ios::trunc | std::ios::binary);
+}
+
+
+ProjectFileWriter::~ProjectFileWriter()
+{
+    if (!mCommitted)
+    {
+        discard();
+    }
+}
+
+
+bool ProjectFileWriter::isOpen() const
+{
+    return mStream.is_open() && !mCommitted;
+}
+
+
+bool ProjectFileWriter::commit()
+{
+    if (!isOpen())
+    {
+        return false;
+    }
+
+    mStream.flush();
+    mStream.close();
+
+    if (mStream.fail())
+    {
+        Falcor::logError("Failed to write temporary project file '{}'.", mTempFilePath.string());
+        discard();
+        return false;
+    }
+
+    if (!syncFileToDisk(mTempFilePath))
+    {
+        Falcor::logWarning("Could not sync temporary project file '{}' to disk.", mTempFilePath.string());
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(mTempFilePath, mFilePath, ec);
+
+    if (ec)
+    {
+        Falcor::logError("Failed to replace project file '{}': {}", mFilePath.string(), ec.message());
+        discard();
+        return false;
+    }
+
+    mCommitted = true;
+    return true;
+}
+
+
+void ProjectFileWriter::discard()
+{
+    if (mStream.is_open())
+    {
+        mStream.close();
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(mTempFilePath, ec);
+}
+
+
+ProjectFileReader::ProjectFileReader(const std::filesystem::path& filePath)
+{
+    map(filePath);
+
+    if (isOpen())
+    {
+        mStreamBuffer.reset(mpData, mSize);
+    }
+}
+
+
+ProjectFileReader::~ProjectFileReader()
+{
+    unmap();
+}
+
+
+bool ProjectFileReader::isOpen() const
+{
+    return mpData != nullptr;
+}
+
+
+char* ProjectFileReader::getData()
+{
+    return mpData;
+}
+
+
+size_t ProjectFileReader::getSize() const
+{
+    return mSize;
+}
+
+
+std::istream& ProjectFileReader::getStream()
+{
+    return mStream;
+}
+
+
+void ProjectFileReader::map(const std::filesystem::path& filePath)
+{
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(filePath, ec);
+
+    if (ec)
+    {
+        return;
+    }
+
+    mSize = static_cast<size_t>(fileSize);
+
+    const auto useFallbackBuffer = [&]()
+    {
+        mFallbackBuffer.resize(mSize + 1, '\0');
+
+        std::ifstream is(filePath, std::ios::in | std::ios::binary);
+
+        if (is.read(mFallbackBuffer.data(), static_cast<std::streamsize>(mSize)))
+        {
+            mpData = mFallbackBuffer.data();
+        }
+    };
+
+    if (mSize == 0)
+    {
+        useFallbackBuffer();
+        return;
+    }
+
+#if FALCOR_WINDOWS
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+
+    // The view is zero-filled up to the end of its last page, so only a page-aligned file lacks the terminating zero
+    if (mSize % systemInfo.dwPageSize == 0)
+    {
+        useFallbackBuffer();
+        return;
+    }
+
+    // Writers must be able to keep the file open, the sidecar of a project is appended to while it is mapped
+    mFileHandle = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (mFileHandle == INVALID_HANDLE_VALUE)
+    {
+        mFileHandle = nullptr;
+        return;
+    }
+
+    mMappingHandle = CreateFileMappingW(mFileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+
+    if (!mMappingHandle)
+    {
+        unmap();
+        return;
+    }
+
+    mpData = static_cast<char*>(MapViewOfFile(mMappingHandle, FILE_MAP_COPY, 0, 0, 0));
+    mMappedSize = mSize;
+
+    if (!mpData)
+    {
+        unmap();
+    }
+#elif FALCOR_LINUX
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto fd = ::open(filePath.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+        return;
+    }
+
+    // Reserve at least one byte of anonymous zero pages behind the file, then map the file over the start of the reservation,
+    // so the content is terminated even if the file size is a multiple of the page size
+    mMappedSize = (mSize / pageSize + 1) * pageSize;
+    const auto pReserved = ::mmap(nullptr, mMappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (pReserved == MAP_FAILED)
+    {
+        ::close(fd);
+        useFallbackBuffer();
+        return;
+    }
+
+    const auto pFile = ::mmap(pReserved, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    ::close(fd);
+
+    if (pFile == MAP_FAILED)
+    {
+        ::munmap(pReserved, mMappedSize);
+        useFallbackBuffer();
+        return;
+    }
+
+    ::madvise(pFile, mSize, MADV_SEQUENTIAL);
+    mpData = static_cast<char*>(pFile);
+#else
+    useFallbackBuffer();
+#endif
+}
+
+
+void ProjectFileReader::unmap()
+{
+    if (mpData && mpData != mFallbackBuffer.data())
+    {
+#if FALCOR_WINDOWS
+        UnmapViewOfFile(mpData);
+#elif FALCOR_LINUX
+        ::munmap(mpData, mMappedSize);
+#endif
+    }
+
+#if FALCOR_WINDOWS
+    if (mMappingHandle)
+    {
+        CloseHandle(mMappingHandle);
+        mMappingHandle = nullptr;
+    }
+
+    if (mFileHandle)
+    {
+        CloseHandle(mFileHandle);
+        mFileHandle = nullptr;
+    }
+#endif
+
+    mpData = nullptr;
+    mMappedSize = 0;
+    mFallbackBuffer.clear();
+}
+
+
+void ProjectFileReader::MemoryStreamBuffer::reset(char* pBegin, const size_t size)
+{
+    setg(pBegin, pBegin, pBegin + size);
+}
+
+
+auto ProjectFileReader::MemoryStreamBuffer::seekoff(
+    const off_type offset,
+    const std::ios_base::seekdir direction,
+    const std::ios_base::openmode mode
+) -> pos_type
+{
+    if (!(mode & std::ios_base::in))
+    {
+        return pos_type(off_type(-1));
+    }
+
+    char* pOrigin = direction == std::ios_base::beg ? eback() : direction == std::ios_base::cur ? gptr() : egptr();
+    char* pTarget = pOrigin + offset;
+
+    if (pTarget < eback() || pTarget > egptr())
+    {
+        return pos_type(off_type(-1));
+    }
+
+    setg(eback(), pTarget, egptr());
+    return pos_type(off_type(pTarget - eback()));
+}
+
+
+auto ProjectFileReader::MemoryStreamBuffer::seekpos(const pos_type position, const std::ios_base::openmode mode) -> pos_type
+{
+    return seekoff(off_type(position), std::ios_base::beg, mode);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Standard.h"
+
+
+namespace GraphEx
+{
+
+// Streams a file into a temporary sibling of the destination, and replaces the destination only once everything was written
+// successfully, so that a crash or a failed serialization mid-save never leaves a truncated project file behind
+struct GRAPHEX_EXPORTABLE ProjectFileWriter
+{
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 4 * 1024 * 1024;
+
+    explicit ProjectFileWriter(std::filesystem::path filePath, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~ProjectFileWriter();
+
+    MAKE_MOVE_ONLY(ProjectFileWriter)
+
+    bool isOpen() const;
+
+    // Flushes and syncs the temporary file, then renames it over the destination. The writer is unusable afterwards
+    bool commit();
+
+    // Drops everything written so far, the destination is left untouched
+    void discard();
+
+private:
+    std::filesystem::path mFilePath;
+    std::filesystem::path mTempFilePath;
+    std::vector<char> mBuffer;
+    std::ofstream mStream;
+    bool mCommitted = false;
+
+public:
+    DEFAULT_GETREF_DEFINITION(Stream, mStream)
+    DEFAULT_CONST_GETREF_DEFINITION(FilePath, mFilePath)
+};
+
+
+// Maps a project file into memory for loading. The mapping is private and writable (copy-on-write), so the content can be parsed in
+// place without touching the file, and it is always followed by a terminating zero byte
+struct GRAPHEX_EXPORTABLE ProjectFileReader
+{
+    explicit ProjectFileReader(const std::filesystem::path& filePath);
+    ~ProjectFileReader();
+
+    MAKE_MOVE_ONLY(ProjectFileReader)
+
+    bool isOpen() const;
+
+    // Null-terminated content of the file, valid as long as the reader lives
+    char* getData();
+    size_t getSize() const;
+
+    // Reads the mapping without copying it, for archives that consume streams
+    std::istream& getStream();
+
+private:
+    struct MemoryStreamBuffer : std::streambuf
+    {
+        void reset(char* pBegin, size_t size);
+
+    protected:
+        pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override;
+        pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+    };
+
+    void map(const std::filesystem::path& filePath);
+    void unmap();
+
+    char* mpData = nullptr;
+    size_t mSize = 0;
+    size_t mMappedSize = 0;
+    std::vector<char> mFallbackBuffer;  // Used when the terminating zero cannot be provided by the mapping itself
+
+#if FALCOR_WINDOWS
+    void* mFileHandle = nullptr;
+    void* mMappingHandle = nullptr;
+#endif
+
+    MemoryStreamBuffer mStreamBuffer;
+    std::istream mStream{ &mStreamBuffer };
+};
+
+
+// Waits until the written content of the file reached the disk. A file replacing another by a rename must be synced before it, for the
+// rename to survive a power loss
+GRAPHEX_EXPORTABLE bool syncFileToDisk(const std::filesystem::path& filePath);
+
+// Fixed-width little endian integers for file headers, written by hand so that they can be patched in place without an archive around them
+GRAPHEX_EXPORTABLE void writeUInt64(std::ostream& os, uint64_t value);
+GRAPHEX_EXPORTABLE std::optional<uint64_t> readUInt64(std::istream& is);
+
+} // namespace GraphEx
@@ -0,0 +1,104 @@
+#include "ShaderCache.h"
+
+
+using namespace GraphEx;
+
+
+ShaderCache::ShaderCache(std::filesystem::path directory)
+    : mDirectory(std::move(directory))
+{ }
+
+
+auto ShaderCache::getEntries() const -> std::vector<Entry>
+{
+    std::vector<Entry> entries;
+    std::error_code ec;
+
+    // Files may disappear while iterating, when another process prunes the cache
+    for (auto it = std::filesystem::recursive_directory_iterator(mDirectory, ec); !ec && it != std::filesystem::recursive_directory_iterator();
+         it.increment(ec))
+    {
+        if (!it->is_regular_file(ec))
+        {
+            continue;
+        }
+
+        const auto size = it->file_size(ec);
+        const auto lastWriteTime = ec ? std::filesystem::file_time_type() : it->last_write_time(ec);
+
+        if (!ec)
+        {
+            entries.push_back({ it->path(), size, lastWriteTime });
+        }
+    }
+
+    return entries;
+}
+
+
+uint64_t ShaderCache::getTotalSize() const
+{
+    uint64_t size = 0;
+
+    for (const auto& entry : getEntries())
+    {
+        size += entry.size;
+    }
+
+    return size;
+}
+
+
+size_t ShaderCache::prune(const uint64_t maxSize) const
+{
+    auto entries = getEntries();
+    auto size = uint64_t(0);
+
+    for (const auto& entry : entries)
+    {
+        size += entry.size;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.lastWriteTime < rhs.lastWriteTime;
+    });
+
+    size_t removedCount = 0;
+
+    for (auto it = entries.begin(); it != entries.end() && size > maxSize; ++it)
+    {
+        // Files in use by another process may not be removable on every platform, those are left for the next time
+        std::error_code ec;
+
+        if (std::filesystem::remove(it->filePath, ec))
+        {
+            size -= it->size;
+            ++removedCount;
+        }
+    }
+
+    return removedCount;
+}
+
+
+void ShaderCache::clear() const
+{
+    prune(0);
+}
+
+
+std::filesystem::path ShaderCache::getDefaultDirectory()
+{
+    return std::filesystem::temp_directory_path() / "GraphEx" / "ShaderCache";
+}
+
+
+void ShaderCache::configure(Falcor::SampleAppConfig& config, const std::filesystem::path& directory)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    // Bounded by size when pruning, not by the number of entries
+    config.deviceDesc.shaderCachePath = directory.string();
+    config.deviceDesc.maxShaderCacheEntryCount = 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Standard.h"
+
+
+namespace GraphEx
+{
+
+// Persistent cache of compiled shader kernels, shared by every GraphEx process on the machine (e.g. the workers of a batch run). The
+// kernels are cached by the shader compiler of the device, under keys that cover the hashes of the source file and everything it
+// imports, the defines, the entry points and the target profile, so entries never go stale, they only fall out of use. This points
+// the devices to a common directory instead of one next to each executable, and keeps that directory within a size budget.
+// Entries are written whole and never modified, so processes can share the directory. Pruning only removes files, a process that
+// misses an entry removed under it just compiles the kernel again
+struct GRAPHEX_EXPORTABLE ShaderCache
+{
+    static constexpr uint64_t DEFAULT_MAX_SIZE = 1024 * 1024 * 1024;
+
+    struct Entry
+    {
+        std::filesystem::path filePath;
+        uint64_t size = 0;
+        std::filesystem::file_time_type lastWriteTime;
+    };
+
+    explicit ShaderCache(std::filesystem::path directory = getDefaultDirectory());
+
+    std::vector<Entry> getEntries() const;
+    uint64_t getTotalSize() const;
+
+    // Removes the least recently written entries until the cache fits the given size. Returns the number of entries removed
+    size_t prune(uint64_t maxSize) const;
+    void clear() const;
+
+    static std::filesystem::path getDefaultDirectory();
+
+    // Makes the device of the application use the cache in the given directory. Call this on the config the application is created with
+    static void configure(Falcor::SampleAppConfig& config, const std::filesystem::path& directory = getDefaultDirectory());
+
+private:
+    std::filesystem::path mDirectory;
+
+public:
+    DEFAULT_CONST_GETREF_DEFINITION(Directory, mDirectory)
+};
+
+} // namespace GraphEx
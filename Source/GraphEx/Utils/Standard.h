@@ -11,6 +11,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <queue>
+#include <deque>
 #include <functional>
 #include <filesystem>
 #include <charconv>
@@ -18,6 +19,11 @@
 #include <iostream>
 #include <array>
 #include <sstream>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <mutex>
 
 #include <Falcor.h>
 
@@ -86,7 +92,10 @@
     class& operator=(class&&) noexcept = default;
 
 
-#if FALCOR_WINDOWS
+#if FALCOR_WINDOWS && defined(GRAPHEX_PLUGIN_MODULES)
+#define GRAPHEX_EXPORT __declspec(dllexport)
+#define GRAPHEX_IMPORT __declspec(dllimport)
+#elif FALCOR_WINDOWS
 #define GRAPHEX_EXPORT
 #define GRAPHEX_IMPORT
 #elif FALCOR_LINUX
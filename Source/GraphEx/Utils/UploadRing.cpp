@@ -0,0 +1,181 @@
+#include "UploadRing.h"
+
+
+using namespace GraphEx;
+
+
+std::unordered_set<UploadRing*> UploadRing::sRings;
+
+
+UploadRing::UploadRing(Falcor::ref<Falcor::Device> pDevice, const uint64_t capacity, const uint64_t maxCapacity)
+    : mpDevice(std::move(pDevice))
+    , mpFence(mpDevice->createFence())
+    , mMaxCapacity(maxCapacity)
+{
+    createBuffer(Falcor::align_to(ALIGNMENT, capacity));
+    sRings.insert(this);
+}
+
+
+UploadRing::~UploadRing()
+{
+    sRings.erase(this);
+    mpBuffer->unmap();
+}
+
+
+void UploadRing::upload(
+    Falcor::RenderContext* pRenderContext,
+    const Falcor::ref<Falcor::Buffer>& pBuffer,
+    const uint64_t offset,
+    const void* pData,
+    const uint64_t size
+) {
+    if (size == 0)
+    {
+        return;
+    }
+
+    const auto ringOffset = allocate(pRenderContext, size);
+    std::memcpy(mpData + ringOffset, pData, size);
+    pRenderContext->copyBufferRegion(pBuffer.get(), offset, mpBuffer.get(), ringOffset, size);
+}
+
+
+void UploadRing::endFrame(Falcor::RenderContext* pRenderContext)
+{
+    for (const auto pRing : sRings)
+    {
+        pRing->closeFrame(pRenderContext);
+        pRing->reclaim();
+    }
+}
+
+
+uint64_t UploadRing::allocate(Falcor::RenderContext* pRenderContext, const uint64_t size)
+{
+    const auto alignedSize = Falcor::align_to(ALIGNMENT, size);
+    uint64_t offset = 0;
+
+    reclaim();
+
+    while (!tryAllocate(alignedSize, offset))
+    {
+        if (alignedSize > getCapacity() || getCapacity() < mMaxCapacity)
+        {
+            grow(pRenderContext, alignedSize);
+            continue;
+        }
+
+        // Everything in the ring is still in use, the oldest frame has to complete first
+        closeFrame(pRenderContext);
+        mpFence->wait(mFrames.front().fenceValue);
+        reclaim();
+    }
+
+    return offset;
+}
+
+
+bool UploadRing::tryAllocate(const uint64_t size, uint64_t& offset)
+{
+    const auto capacity = getCapacity();
+
+    if (mUsedSize == 0)
+    {
+        mHead = mTail = 0;
+    }
+
+    // The free space is either after the head (and before the tail, once wrapped), or between the head and the tail
+    if (mHead >= mTail && mUsedSize < capacity)
+    {
+        if (capacity - mHead < size)
+        {
+            if (mTail < size)
+            {
+                return false;
+            }
+
+            // The end of the ring is skipped, allocations are contiguous
+            mUsedSize += capacity - mHead;
+            mOpenFrameSize += capacity - mHead;
+            mHead = 0;
+        }
+    }
+    else if (mTail - mHead < size)
+    {
+        return false;
+    }
+
+    offset = mHead;
+    mHead = (mHead + size) % capacity;
+    mUsedSize += size;
+    mOpenFrameSize += size;
+
+    return true;
+}
+
+
+void UploadRing::closeFrame(Falcor::RenderContext* pRenderContext)
+{
+    if (mOpenFrameSize == 0)
+    {
+        return;
+    }
+
+    // The copies recorded so far must be submitted for the fence to follow them
+    pRenderContext->submit(false);
+    mFrames.push_back({ mHead, mOpenFrameSize, pRenderContext->signal(mpFence.get()) });
+    mOpenFrameSize = 0;
+}
+
+
+void UploadRing::reclaim()
+{
+    const auto completedValue = mpFence->getCurrentValue();
+
+    while (!mFrames.empty() && mFrames.front().fenceValue <= completedValue)
+    {
+        mTail = mFrames.front().end;
+        mUsedSize -= mFrames.front().size;
+        mFrames.pop_front();
+    }
+
+    mRetiredBuffers.erase(
+        std::remove_if(mRetiredBuffers.begin(), mRetiredBuffers.end(), [completedValue](const RetiredBuffer& retiredBuffer) {
+            return retiredBuffer.fenceValue <= completedValue;
+        }),
+        mRetiredBuffers.end()
+    );
+}
+
+
+void UploadRing::grow(Falcor::RenderContext* pRenderContext, const uint64_t size)
+{
+    // The old memory is kept until the copies from it completed
+    closeFrame(pRenderContext);
+
+    if (!mFrames.empty())
+    {
+        mRetiredBuffers.push_back({ mpBuffer, mFrames.back().fenceValue });
+    }
+
+    mpBuffer->unmap();
+    createBuffer(std::max(getCapacity() * 2, size));
+
+    mHead = mTail = mUsedSize = 0;
+    mFrames.clear();
+}
+
+
+void UploadRing::createBuffer(const uint64_t capacity)
+{
+    mpBuffer = mpDevice->createBuffer(capacity, Falcor::ResourceBindFlags::None, Falcor::MemoryType::Upload);
+    mpData = static_cast<uint8_t*>(mpBuffer->map());
+}
+
+
+uint64_t UploadRing::getCapacity() const
+{
+    return mpBuffer->getSize();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Standard.h"
+
+
+namespace GraphEx
+{
+
+// Upload memory for updating device buffers without allocating any. The memory is mapped once and used as a ring, the space written in a
+// frame is reused once the GPU completed that frame. If a frame needs more than there is, the ring grows to twice its size (the old memory
+// is released once the GPU is done with it), or, at its maximum size, waits for the oldest frame
+class GRAPHEX_EXPORTABLE UploadRing final
+{
+public:
+    static constexpr uint64_t DEFAULT_CAPACITY = 4 * 1024 * 1024;
+    static constexpr uint64_t DEFAULT_MAX_CAPACITY = 256 * 1024 * 1024;
+    static constexpr uint64_t ALIGNMENT = 256;
+
+    // Single uploads larger than the maximum capacity still grow the ring beyond it
+    explicit UploadRing(
+        Falcor::ref<Falcor::Device> pDevice,
+        uint64_t capacity = DEFAULT_CAPACITY,
+        uint64_t maxCapacity = DEFAULT_MAX_CAPACITY
+    );
+    ~UploadRing();
+
+    UploadRing(const UploadRing&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+
+    // Copies the data into the ring, and records the copy from there into the buffer
+    void upload(
+        Falcor::RenderContext* pRenderContext,
+        const Falcor::ref<Falcor::Buffer>& pBuffer,
+        uint64_t offset,
+        const void* pData,
+        uint64_t size
+    );
+
+    // Ends the frame of every ring. Called by the application at the end of each frame
+    static void endFrame(Falcor::RenderContext* pRenderContext);
+
+private:
+    struct Frame
+    {
+        uint64_t end = 0;
+        uint64_t size = 0;  // Including the space skipped at the end of the ring
+        uint64_t fenceValue = 0;
+    };
+
+    struct RetiredBuffer
+    {
+        Falcor::ref<Falcor::Buffer> pBuffer;
+        uint64_t fenceValue = 0;
+    };
+
+    uint64_t allocate(Falcor::RenderContext* pRenderContext, uint64_t size);
+    bool tryAllocate(uint64_t size, uint64_t& offset);
+    void closeFrame(Falcor::RenderContext* pRenderContext);
+    void reclaim();
+    void grow(Falcor::RenderContext* pRenderContext, uint64_t size);
+    void createBuffer(uint64_t capacity);
+
+    Falcor::ref<Falcor::Device> mpDevice;
+    Falcor::ref<Falcor::Fence> mpFence;
+    Falcor::ref<Falcor::Buffer> mpBuffer;
+    uint8_t* mpData = nullptr;
+    uint64_t mMaxCapacity = DEFAULT_MAX_CAPACITY;
+
+    uint64_t mHead = 0;
+    uint64_t mTail = 0;
+    uint64_t mUsedSize = 0;
+    uint64_t mOpenFrameSize = 0;
+    std::deque<Frame> mFrames;  // In flight, oldest first
+    std::vector<RetiredBuffer> mRetiredBuffers;
+
+    static std::unordered_set<UploadRing*> sRings;
+
+public:
+    uint64_t getCapacity() const;
+};
+
+} // namespace GraphEx
@@ -24,6 +24,43 @@ void Test::cleanup()
 }
 
 
+const Falcor::ref<Falcor::Device>& Test::getTestDevice()
+{
+    static const auto pDevice = Falcor::make_ref<Falcor::Device>(Falcor::Device::Desc{ });
+    return pDevice;
+}
+
+
+std::filesystem::path Test::getTestShaderPath(const std::string& fileName)
+{
+    return std::filesystem::path(GRAPHEX_TEST_DIR) / "Shaders" / fileName;
+}
+
+
+bool Test::runFramesUntil(const Falcor::ref<Falcor::Device>& pDevice, const std::function<bool()>& condition, const size_t maxFrameCount)
+{
+    const auto pRenderContext = pDevice->getRenderContext();
+
+    for (size_t i = 0; i < maxFrameCount; ++i)
+    {
+        ProgramWrapper::finishCompilations();
+        BufferReadback::beginFrame();
+        GpuTimeRecorder::beginFrame();
+
+        if (condition())
+        {
+            return true;
+        }
+
+        UploadRing::endFrame(pRenderContext);
+        pRenderContext->submit(false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return condition();
+}
+
+
 void TestApplication::onFrameRender(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo)
 {
     Application::onFrameRender(pRenderContext, pTargetFbo);
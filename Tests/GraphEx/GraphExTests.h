@@ -17,6 +17,14 @@ struct TestModuleContainer : ModuleContainer<Module>
 void cleanup();
 
 
+// Headless device for the tests that need the GPU, created by the first of them and shared by all
+const Falcor::ref<Falcor::Device>& getTestDevice();
+std::filesystem::path getTestShaderPath(const std::string& fileName);
+// Runs frames the way the application does at their beginning and end, until the condition holds. Returns false if it did not within the
+// frame limit
+bool runFramesUntil(const Falcor::ref<Falcor::Device>& pDevice, const std::function<bool()>& condition, size_t maxFrameCount = 1000);
+
+
 struct TestApplication : Application
 {
     explicit TestApplication(const Falcor::SampleAppConfig& config)
@@ -0,0 +1,7 @@
+#include "TestPluginModule.h"
+
+
+extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
+{
+    registry.registerClass<GraphEx::PluginModule, GraphEx::Test::TestPluginModule>();
+}
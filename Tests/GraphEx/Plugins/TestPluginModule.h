@@ -0,0 +1,77 @@
+#pragma once
+
+#include <GraphEx/GraphEx.h>
+
+
+namespace GraphEx::Test
+{
+
+struct TestPluginModuleState : ModuleState
+{
+    int intValue = 0;
+
+    template<typename Archive>
+    void serialize(Archive& ar)
+    {
+        ar(SerializeNamed<Archive>("intValue", intValue));
+    }
+};
+
+
+// Registered by the tests in the host, for the plugin module to look up
+struct TestPluginHostModule : Module
+{
+    explicit TestPluginHostModule(ModuleContainerBase* pContainer)
+        : Module(pContainer) {}
+
+    void init(Falcor::RenderContext* pRenderContext) override {}
+    void update(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo) override {}
+    void cleanup() override {}
+
+    ModuleId getModuleId() const override
+    {
+        return "GraphEx.Test.TestPluginHostModule";
+    }
+
+    int value = 0;
+};
+
+
+// Built into a library of its own, which the plugin tests load and reload
+struct TestPluginModule : PluginModule, HasSerializableState<TestPluginModuleState>
+{
+    GRAPHEX_PLUGIN_MODULE(TestPluginModule, "TestPluginModule", "Plugin module of the tests");
+
+    explicit TestPluginModule(ModuleContainerBase* pContainer)
+        : PluginModule(pContainer), mpContainer(pContainer) {}
+
+    void init(Falcor::RenderContext* pRenderContext) override
+    {
+        mInitCalled = true;
+
+        // Runs in the library, which must look the module up in the registry of the host
+        if (const auto pHostModule = mpContainer->getMaybeContained<TestPluginHostModule>())
+        {
+            mHostValue = pHostModule->value;
+        }
+    }
+
+    void update(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo) override {}
+    void cleanup() override {}
+
+    ModuleId getModuleId() const override
+    {
+        return "GraphEx.Test.TestPluginModule";
+    }
+
+private:
+    ModuleContainerBase* mpContainer;
+    bool mInitCalled = false;
+    std::optional<int> mHostValue;
+
+public:
+    DEFAULT_CONST_GETTER_DEFINITION(InitCalled, mInitCalled)
+    DEFAULT_CONST_GETTER_DEFINITION(HostValue, mHostValue)
+};
+
+} // namespace GraphEx::Test
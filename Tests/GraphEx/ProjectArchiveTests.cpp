@@ -0,0 +1,65 @@
+#include "ProjectArchiveTests.h"
+
+
+namespace GraphEx::Test
+{
+
+void ProjectArchiveFixture::TearDown()
+{
+    Internal::SerializationManager::get().setBlobStore(nullptr);
+    cleanup();
+}
+
+
+std::shared_ptr<ArchiveTestState> makeArchiveTestState(const size_t recordCount)
+{
+    auto pState = std::make_shared<ArchiveTestState>();
+    pState->label = "Archive Test";
+    pState->records.reserve(recordCount);
+
+    for (size_t i = 0; i < recordCount; ++i)
+    {
+        const auto f = static_cast<float>(i);
+        pState->records.push_back({ "Object " + std::to_string(i), Falcor::float3(f, f * 0.5f, -f), static_cast<int32_t>(i) });
+    }
+
+    return pState;
+}
+
+
+std::string saveBinaryProject()
+{
+    std::ostringstream oss(std::ios::out | std::ios::binary);
+    {
+        auto archive = Internal::SerializationManager::get().beginBinarySave(oss);
+        EXPECT_NE(archive, std::nullopt);
+        ModuleRegistry::get().saveModuleStates(*archive);
+        Internal::SerializationManager::get().finish();
+    }
+
+    return oss.str();
+}
+
+
+void loadBinaryProject(const std::string& data)
+{
+    std::istringstream iss(data, std::ios::in | std::ios::binary);
+    auto archive = Internal::SerializationManager::get().beginBinaryLoad(iss);
+    ASSERT_NE(archive, std::nullopt);
+    ModuleRegistry::get().loadModuleStates(*archive);
+    Internal::SerializationManager::get().finish();
+}
+
+
+std::string readFile(const std::filesystem::path& filePath)
+{
+    std::ifstream is(filePath, std::ios::in | std::ios::binary);
+    return { std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
+}
+
+} // namespace GraphEx::Test
+
+
+GRAPHEX_REGISTER_MODULE_STATE(GraphEx::Test::ArchiveTestState);
+GRAPHEX_REGISTER_MODULE_STATE(GraphEx::Test::ArchiveBlobState);
+GRAPHEX_REGISTER_SERIALIZABLE(GraphEx::Test::ArchivePayloadObject);
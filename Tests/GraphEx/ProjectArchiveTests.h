@@ -0,0 +1,176 @@
+#pragma once
+
+#include "GraphExTests.h"
+
+
+namespace GraphEx::Test
+{
+
+struct ArchiveTestRecord
+{
+    std::string name;
+    Falcor::float3 position{ 0.0f };
+    int32_t id = 0;
+
+    template<typename Archive>
+    void serialize(Archive& ar)
+    {
+        ar(SerializeNamed<Archive>("name", name));
+        ar(SerializeNamed<Archive>("position", position));
+        ar(SerializeNamed<Archive>("id", id));
+    }
+};
+
+
+struct ArchiveTestState : ModuleState
+{
+    std::string label;
+    std::vector<ArchiveTestRecord> records;
+
+    template<typename Archive>
+    void serialize(Archive& ar)
+    {
+        ar(SerializeNamed<Archive>("label", label));
+        ar(SerializeNamed<Archive>("records", records));
+    }
+};
+
+
+struct ArchiveUnregisteredState : ModuleState
+{
+    int intValue = 0;
+
+    template<typename Archive>
+    void serialize(Archive& ar)
+    {
+        ar(SerializeNamed<Archive>("intValue", intValue));
+    }
+};
+
+
+struct ArchiveBlobState : ModuleState
+{
+    BlobData blob;
+
+    template<typename Archive>
+    void serialize(Archive& ar)
+    {
+        ar(SerializeNamed<Archive>("blob", blob));
+    }
+};
+
+
+struct ArchiveTestModule : Module, HasSerializableState<ArchiveTestState>
+{
+    explicit ArchiveTestModule(ModuleContainerBase* pContainer)
+        : Module(pContainer) {}
+
+    void init(Falcor::RenderContext* pRenderContext) override {}
+    void update(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo) override {}
+    void cleanup() override {}
+
+    ModuleId getModuleId() const override
+    {
+        return "GraphEx.Test.ArchiveTestModule";
+    }
+};
+
+
+struct ArchiveSecondTestModule : Module, HasSerializableState<ArchiveTestState>
+{
+    explicit ArchiveSecondTestModule(ModuleContainerBase* pContainer)
+        : Module(pContainer) {}
+
+    void init(Falcor::RenderContext* pRenderContext) override {}
+    void update(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo) override {}
+    void cleanup() override {}
+
+    ModuleId getModuleId() const override
+    {
+        return "GraphEx.Test.ArchiveSecondTestModule";
+    }
+};
+
+
+struct ArchiveBlobTestModule : Module, HasSerializableState<ArchiveBlobState>
+{
+    explicit ArchiveBlobTestModule(ModuleContainerBase* pContainer)
+        : Module(pContainer) {}
+
+    void init(Falcor::RenderContext* pRenderContext) override {}
+    void update(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo) override {}
+    void cleanup() override {}
+
+    ModuleId getModuleId() const override
+    {
+        return "GraphEx.Test.ArchiveBlobTestModule";
+    }
+};
+
+
+struct ArchiveUnregisteredTestModule : Module, HasSerializableState<ArchiveUnregisteredState>
+{
+    explicit ArchiveUnregisteredTestModule(ModuleContainerBase* pContainer)
+        : Module(pContainer) {}
+
+    void init(Falcor::RenderContext* pRenderContext) override {}
+    void update(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Fbo>& pTargetFbo) override {}
+    void cleanup() override {}
+
+    ModuleId getModuleId() const override
+    {
+        return "GraphEx.Test.ArchiveUnregisteredTestModule";
+    }
+};
+
+
+struct ArchivePayloadObject : Core::SceneObject
+{
+    std::vector<Falcor::float3> vertices;
+
+    bool hasPayload() const override
+    {
+        return true;
+    }
+
+    void savePayload(BinaryOutputArchive& ar) const override
+    {
+        ar(vertices);
+    }
+
+    void loadPayload(BinaryInputArchive& ar) override
+    {
+        ar(vertices);
+    }
+
+    template<typename Archive>
+    void serialize(Archive& ar)
+    {
+        ar(SerializeBase<Core::SceneObject>(this));
+    }
+};
+
+
+// Registers the modules of a test into a container of its own, and unregisters them again after the test
+struct ProjectArchiveFixture : ::testing::Test
+{
+    template<typename ModuleT>
+    auto registerModule()
+    {
+        return ModuleRegistry::get().registerModuleForContainer<ModuleT>(mTestContainer.getModuleContainerId(), &mTestContainer);
+    }
+
+    void TearDown() override;
+
+    TestModuleContainer mTestContainer;
+};
+
+
+std::shared_ptr<ArchiveTestState> makeArchiveTestState(size_t recordCount);
+
+std::string saveBinaryProject();
+void loadBinaryProject(const std::string& data);
+
+std::string readFile(const std::filesystem::path& filePath);
+
+} // namespace GraphEx::Test
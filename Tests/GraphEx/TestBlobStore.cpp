@@ -0,0 +1,148 @@
+#include "ProjectArchiveTests.h"
+
+
+namespace GraphEx::Test
+{
+
+struct BlobStoreTest : ProjectArchiveFixture {};
+
+
+TEST_F(BlobStoreTest, BlobsGoToSidecar)
+{
+    const auto filePath = Internal::BlobStore::getSidecarPath(std::filesystem::temp_directory_path() / "GraphExTestBlobs.gxproj");
+    std::filesystem::remove(filePath);
+
+    std::vector<float> values(4096);
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = static_cast<float>(i);
+    }
+
+    const auto blob = BlobData::fromVector(values);
+
+    const auto save = [&blob]()
+    {
+        std::ostringstream oss;
+        {
+            auto archive = Internal::SerializationManager::get().beginSave(oss);
+            EXPECT_NE(archive, std::nullopt);
+            (*archive)(SaveNamed("blob", blob));
+        }
+
+        return oss.str();
+    };
+
+    const auto load = [](const std::string& data)
+    {
+        BlobData result;
+        std::istringstream iss(data);
+        {
+            auto archive = Internal::SerializationManager::get().beginLoad(iss);
+            EXPECT_NE(archive, std::nullopt);
+            (*archive)(LoadNamed("blob", result));
+        }
+
+        return result;
+    };
+
+    // Without a store the data stays in the project
+    const auto inlineProject = save();
+    EXPECT_GT(inlineProject.size(), blob.getSize());
+    EXPECT_EQ(load(inlineProject).getDataAs<float>()[4095], 4095.0f);
+
+    auto pBlobStore = std::make_shared<Internal::BlobStore>(filePath);
+    Internal::SerializationManager::get().setBlobStore(pBlobStore);
+
+    const auto project = save();
+    EXPECT_LT(project.size(), 1024);
+    ASSERT_TRUE(pBlobStore->flush());
+    const auto sidecarSize = std::filesystem::file_size(filePath);
+
+    // The same content is stored once, even when it comes from a copy that knows nothing about the store
+    const auto copy = BlobData::fromVector(values);
+    const auto reference = pBlobStore->write(copy.getData(), copy.getSize());
+    ASSERT_TRUE(pBlobStore->flush());
+    ASSERT_NE(reference, std::nullopt);
+    EXPECT_EQ(std::filesystem::file_size(filePath), sidecarSize);
+
+    // A new store, as after reopening the project, finds the blob in the mapped sidecar and keeps deduplicating against it
+    pBlobStore = std::make_shared<Internal::BlobStore>(filePath);
+    Internal::SerializationManager::get().setBlobStore(pBlobStore);
+
+    const auto loaded = load(project);
+    ASSERT_EQ(loaded.getElementCount<float>(), values.size());
+    EXPECT_EQ(loaded.getDataAs<float>()[1234], 1234.0f);
+
+    const auto other = BlobData::fromVector(std::vector<float>{ 1.0f, 2.0f });
+    EXPECT_EQ(pBlobStore->write(blob.getData(), blob.getSize())->offset, reference->offset);
+    EXPECT_NE(pBlobStore->write(other.getData(), other.getSize())->offset, reference->offset);
+
+    // The loaded view outlives the mapping being replaced for the newly appended blob
+    const auto loadedOther = pBlobStore->read(*pBlobStore->write(other.getData(), other.getSize()));
+    ASSERT_NE(loadedOther, std::nullopt);
+    EXPECT_EQ(loadedOther->getDataAs<float>()[1], 2.0f);
+    EXPECT_EQ(loaded.getDataAs<float>()[4095], 4095.0f);
+
+    // A reference that does not match a record is rejected instead of reading arbitrary bytes
+    auto invalidReference = *reference;
+    invalidReference.offset += 4;
+    EXPECT_EQ(pBlobStore->read(invalidReference), std::nullopt);
+
+    Internal::SerializationManager::get().setBlobStore(nullptr);
+
+    // Still mapped by the loaded blobs, which prevents removal on some platforms
+    std::error_code ec;
+    std::filesystem::remove(filePath, ec);
+}
+
+
+TEST_F(BlobStoreTest, SnapshotSharesBlobs)
+{
+    const auto filePath = Internal::BlobStore::getSidecarPath(std::filesystem::temp_directory_path() / "GraphExTestSnapshotBlobs.gxproj");
+    std::filesystem::remove(filePath);
+
+    const auto pTestModule = registerModule<ArchiveBlobTestModule>();
+
+    pTestModule->getState()->blob = BlobData::fromVector(std::vector<float>(1024, 2.0f));
+
+    auto pBlobStore = std::make_shared<Internal::BlobStore>(filePath);
+    Internal::SerializationManager::get().setBlobStore(pBlobStore);
+
+    const auto snapshot = ModuleRegistry::get().takeStateSnapshot();
+    const auto itSnapshot = std::find_if(snapshot.begin(), snapshot.end(), [&pTestModule](const auto& moduleState) {
+        return moduleState.first == pTestModule->getModuleId();
+    });
+
+    ASSERT_NE(itSnapshot, snapshot.end());
+    const auto pSnapshotState = std::dynamic_pointer_cast<ArchiveBlobState>(itSnapshot->second);
+    ASSERT_NE(pSnapshotState, nullptr);
+
+    // The snapshot neither copies the content nor writes it to the store, that is left to the save
+    EXPECT_EQ(pSnapshotState->blob.getData(), pTestModule->getState()->blob.getData());
+    EXPECT_FALSE(std::filesystem::exists(filePath));
+
+    const auto data = std::async(std::launch::async, [&snapshot, &pBlobStore]()
+    {
+        Internal::SerializationManager::get().setBlobStore(pBlobStore);
+        std::ostringstream oss(std::ios::out | std::ios::binary);
+        {
+            auto archive = Internal::SerializationManager::get().beginBinarySave(oss);
+            EXPECT_NE(archive, std::nullopt);
+            ModuleRegistry::saveModuleStateSnapshot(*archive, snapshot);
+            Internal::SerializationManager::get().finish();
+        }
+
+        Internal::SerializationManager::get().setBlobStore(nullptr);
+        return oss.str();
+    }).get();
+
+    EXPECT_LT(data.size(), 1024);
+    EXPECT_TRUE(std::filesystem::exists(filePath));
+
+    // A failed save leaves no project data file behind that it created
+    pBlobStore->discardUnflushedFile();
+    EXPECT_FALSE(std::filesystem::exists(filePath));
+}
+
+} // namespace GraphEx::Test
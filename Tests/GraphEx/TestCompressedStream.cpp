@@ -0,0 +1,122 @@
+#include "ProjectArchiveTests.h"
+
+
+namespace GraphEx::Test
+{
+
+struct CompressedStreamTest : ProjectArchiveFixture {};
+
+
+TEST_F(CompressedStreamTest, RoundTrip)
+{
+    // Large enough to span several buffers on both sides
+    const auto pState = makeArchiveTestState(5000);
+
+    std::ostringstream uncompressed;
+    {
+        auto archive = Internal::SerializationManager::get().beginSave(uncompressed);
+        ASSERT_NE(archive, std::nullopt);
+        (*archive)(SaveNamed("state", *pState));
+    }
+
+    std::ostringstream oss(std::ios::out | std::ios::binary);
+    {
+        CompressedStreamWriter writer(oss);
+        ASSERT_TRUE(writer.isOpen());
+
+        auto archive = Internal::SerializationManager::get().beginSave(writer.getStream());
+        ASSERT_NE(archive, std::nullopt);
+        (*archive)(SaveNamed("state", *pState));
+        archive.reset();
+
+        ASSERT_TRUE(writer.finish());
+    }
+
+    const auto compressed = oss.str();
+    EXPECT_LT(compressed.size(), uncompressed.str().size() / 2);
+
+    std::istringstream iss(compressed, std::ios::in | std::ios::binary);
+    ASSERT_TRUE(CompressedStreamReader::isCompressed(iss));
+    EXPECT_EQ(static_cast<std::streamoff>(iss.tellg()), 0);
+
+    CompressedStreamReader reader(iss);
+    ASSERT_TRUE(reader.isOpen());
+
+    // Peeking at the header of the decompressed content must not consume it
+    EXPECT_EQ(Internal::SerializationManager::detectProjectFormat(reader.getStream()), Internal::ProjectFormat::Json);
+
+    ArchiveTestState loaded;
+    {
+        auto archive = Internal::SerializationManager::get().beginLoad(reader.getStream());
+        ASSERT_NE(archive, std::nullopt);
+        (*archive)(LoadNamed("state", loaded));
+    }
+
+    EXPECT_FALSE(reader.hasFailed());
+    ASSERT_EQ(loaded.records.size(), 5000);
+    EXPECT_EQ(loaded.records[4321].name, "Object 4321");
+    EXPECT_EQ(loaded.records[4321].position.z, -4321.0f);
+
+    // A truncated frame is reported instead of passing for a shorter file
+    std::istringstream truncated(compressed.substr(0, compressed.size() / 2), std::ios::in | std::ios::binary);
+    CompressedStreamReader truncatedReader(truncated);
+    const std::string content{ std::istreambuf_iterator<char>(truncatedReader.getStream()), std::istreambuf_iterator<char>() };
+    EXPECT_TRUE(truncatedReader.hasFailed());
+    EXPECT_LT(content.size(), uncompressed.str().size());
+
+    std::istringstream plain(uncompressed.str());
+    EXPECT_FALSE(CompressedStreamReader::isCompressed(plain));
+}
+
+
+TEST_F(CompressedStreamTest, LoadCompressedJsonProject)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "GraphExTestCompressedLoad.gxproj";
+
+    const auto pTestModule = registerModule<ArchiveTestModule>();
+
+    pTestModule->setState(makeArchiveTestState(5000));
+
+    {
+        ProjectFileWriter writer(filePath);
+        CompressedStreamWriter compressor(writer.getStream());
+        ASSERT_TRUE(compressor.isOpen());
+        {
+            auto archive = Internal::SerializationManager::get().beginSave(compressor.getStream());
+            ASSERT_NE(archive, std::nullopt);
+            ModuleRegistry::get().saveModuleStates(*archive);
+        }
+        Internal::SerializationManager::get().finish();
+        ASSERT_TRUE(compressor.finish());
+        ASSERT_TRUE(writer.commit());
+    }
+
+    cleanup();
+
+    const auto pRestoredModule = registerModule<ArchiveTestModule>();
+
+    // Same path as loading a project: the mapped file is decompressed into the stream archive, which buffers the whole document
+    {
+        ProjectFileReader reader(filePath);
+        ASSERT_TRUE(reader.isOpen());
+        ASSERT_TRUE(CompressedStreamReader::isCompressed(reader.getStream()));
+
+        CompressedStreamReader decompressor(reader.getStream());
+        ASSERT_TRUE(decompressor.isOpen());
+        EXPECT_EQ(Internal::SerializationManager::detectProjectFormat(decompressor.getStream()), Internal::ProjectFormat::Json);
+
+        auto archive = Internal::SerializationManager::get().beginLoad(decompressor.getStream());
+        ASSERT_NE(archive, std::nullopt);
+        ModuleRegistry::get().loadModuleStates(*archive);
+        Internal::SerializationManager::get().finish();
+        EXPECT_FALSE(decompressor.hasFailed());
+    }
+
+    const auto& pRestoredState = pRestoredModule->getState();
+    ASSERT_EQ(pRestoredState->records.size(), 5000);
+    EXPECT_EQ(pRestoredState->records[4321].name, "Object 4321");
+
+    std::filesystem::remove(filePath);
+}
+
+} // namespace GraphEx::Test
@@ -0,0 +1,56 @@
+#include "GraphExTests.h"
+
+
+using namespace GraphEx;
+
+
+namespace GraphEx::Test
+{
+
+TEST(ComputePassGraph, OrderPassesAndShareTransientBuffers)
+{
+    ComputePassGraph graph(nullptr);
+    const auto execute = [](Falcor::RenderContext*) { };
+
+    graph.addTransientBuffer("a", 16, 1000);
+    graph.addTransientBuffer("b", 16, 500);
+    graph.addTransientBuffer("c", 16, 800);
+    graph.addTransientBuffer("unused", 16, 100);
+
+    // Added out of order, each reads what the one before it writes
+    graph.addPass({ "third", nullptr, { "b" }, { "c" }, execute });
+    graph.addPass({ "second", nullptr, { "a" }, { "b" }, execute });
+    graph.addPass({ "first", nullptr, { }, { "a" }, execute });
+    graph.addPass({ "fourth", nullptr, { "c" }, { }, execute });
+    graph.compile();
+
+    EXPECT_EQ(graph.getPassOrder(), std::vector<std::string>({ "first", "second", "third", "fourth" }));
+
+    // "c" is only written once "a" is not read anymore
+    EXPECT_EQ(graph.getUnaliasedTransientMemory(), uint64_t(16) * (1000 + 500 + 800));
+    EXPECT_EQ(graph.getPeakTransientMemory(), uint64_t(16) * (1000 + 500));
+}
+
+
+TEST(ComputePassGraph, RejectInvalidGraphs)
+{
+    const auto execute = [](Falcor::RenderContext*) { };
+
+    ComputePassGraph cyclicGraph(nullptr);
+    cyclicGraph.addTransientBuffer("a", 4, 1);
+    cyclicGraph.addTransientBuffer("b", 4, 1);
+    cyclicGraph.addPass({ "first", nullptr, { "b" }, { "a" }, execute });
+    cyclicGraph.addPass({ "second", nullptr, { "a" }, { "b" }, execute });
+    EXPECT_ANY_THROW(cyclicGraph.compile());
+
+    ComputePassGraph unwrittenGraph(nullptr);
+    unwrittenGraph.addTransientBuffer("a", 4, 1);
+    unwrittenGraph.addPass({ "first", nullptr, { "a" }, { }, execute });
+    EXPECT_ANY_THROW(unwrittenGraph.compile());
+
+    ComputePassGraph unknownBufferGraph(nullptr);
+    unknownBufferGraph.addPass({ "first", nullptr, { }, { "a" }, execute });
+    EXPECT_ANY_THROW(unknownBufferGraph.compile());
+}
+
+} // namespace GraphEx::Test
@@ -0,0 +1,78 @@
+#include "GraphExTests.h"
+
+
+using namespace GraphEx;
+
+
+namespace GraphEx::Test
+{
+
+TEST(GpuTimeRecorder, AggregateStats)
+{
+    GpuTimeRecorder::Stats stats;
+    EXPECT_EQ(stats.getMeanMs(), 0.0);
+
+    stats.addSample(2.0);
+    stats.addSample(1.0);
+    stats.addSample(3.0);
+
+    EXPECT_EQ(stats.sampleCount, 3u);
+    EXPECT_DOUBLE_EQ(stats.getMeanMs(), 2.0);
+    EXPECT_EQ(stats.lastMs, 3.0);
+    EXPECT_EQ(stats.minMs, 1.0);
+    EXPECT_EQ(stats.maxMs, 3.0);
+}
+
+
+
+TEST(GpuTimeRecorder, TimingOfDispatches)
+{
+    GpuTimeRecorder::clearStats();
+
+    const auto pWrapper = ComputeProgramWrapper::create(getTestDevice(), getTestShaderPath("TestBuffers.cs.slang"));
+    pWrapper->waitForCompilation();
+    pWrapper->allocateStructuredBuffer("values", 100, nullptr, 0);
+    pWrapper->allocateStructuredBuffer("other", 100, nullptr, 0);
+    pWrapper->setGpuTiming(true);
+
+    // More dispatches in a frame than may be timed, those beyond are skipped rather than waited for
+    const auto dispatchCount = GpuTimeRecorder::MAX_IN_FLIGHT + 44;
+
+    for (size_t i = 0; i < dispatchCount; ++i)
+    {
+        pWrapper->runProgram(100);
+    }
+
+    const auto labelPrefix = pWrapper->getGpuTimeRecorder()->getLabel() + " [";
+    EXPECT_EQ(pWrapper->getGpuTimeRecorder()->getLabel(), "TestBuffers.cs.slang:main");
+
+    const auto findStats = [&]() -> const GpuTimeRecorder::Stats* {
+        for (const auto& [ label, stats ] : GpuTimeRecorder::getStats())
+        {
+            if (label.compare(0, labelPrefix.size(), labelPrefix) == 0)
+            {
+                return &stats;
+            }
+        }
+
+        return nullptr;
+    };
+
+    ASSERT_TRUE(runFramesUntil(getTestDevice(), [&]() { return findStats() != nullptr; }));
+    EXPECT_EQ(GpuTimeRecorder::getStats().size(), 1);
+
+    // The timings of a frame are fenced together and read at once
+    const auto pStats = findStats();
+    EXPECT_EQ(pStats->sampleCount, GpuTimeRecorder::MAX_IN_FLIGHT);
+    EXPECT_GE(pStats->minMs, 0.0);
+    EXPECT_LE(pStats->minMs, pStats->maxMs);
+
+    // Once read, the dispatches are timed again
+    pWrapper->runProgram(100);
+    ASSERT_TRUE(runFramesUntil(getTestDevice(), [&]() { return findStats()->sampleCount > GpuTimeRecorder::MAX_IN_FLIGHT; }));
+    EXPECT_EQ(findStats()->sampleCount, GpuTimeRecorder::MAX_IN_FLIGHT + 1);
+
+    GpuTimeRecorder::clearStats();
+}
+
+} // namespace GraphEx::Test
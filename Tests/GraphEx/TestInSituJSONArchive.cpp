@@ -0,0 +1,109 @@
+#include "ProjectArchiveTests.h"
+
+
+namespace GraphEx::Test
+{
+
+struct InSituJSONArchiveTest : ProjectArchiveFixture {};
+
+
+TEST_F(InSituJSONArchiveTest, LoadMalformedJsonFails)
+{
+    std::istringstream truncated("{ \"moduleStates\": [");
+    EXPECT_EQ(Internal::SerializationManager::get().beginLoad(truncated), std::nullopt);
+
+    std::istringstream scalarRoot("42");
+    EXPECT_EQ(Internal::SerializationManager::get().beginLoad(scalarRoot), std::nullopt);
+}
+
+
+TEST_F(InSituJSONArchiveTest, LoadWithoutDom)
+{
+    // Values are only parsed when read, so names out of order, escapes and nested nodes must all be found in the buffer itself
+    const std::string content = R"({
+        "count": 3,
+        "nested": { "values": [ 1, -2, 3.5 ], "empty": [ ], "flag": true },
+        "text": "a \"quoted\" [value], {with} brackets",
+        "large": 4294967295,
+        "big": -9223372036854775808
+    })";
+
+    auto archive = InputArchive(content.c_str());
+
+    std::string text;
+    archive(SerializeNamed<InputArchive>("text", text));
+    EXPECT_EQ(text, "a \"quoted\" [value], {with} brackets");
+
+    std::vector<double> values;
+    bool flag = false;
+    archive.setNextName("nested");
+    archive.startNode();
+    archive(SerializeNamed<InputArchive>("flag", flag), SerializeNamed<InputArchive>("values", values));
+    archive.finishNode();
+    EXPECT_TRUE(flag);
+    EXPECT_EQ(values, std::vector<double>({ 1.0, -2.0, 3.5 }));
+
+    int32_t count = 0;
+    uint32_t large = 0;
+    int64_t big = 0;
+    archive(SerializeNamed<InputArchive>("count", count), SerializeNamed<InputArchive>("large", large), SerializeNamed<InputArchive>("big", big));
+    EXPECT_EQ(count, 3);
+    EXPECT_EQ(large, 4294967295u);
+    EXPECT_EQ(big, std::numeric_limits<int64_t>::min());
+
+    // Same range checks as the DOM had
+    int32_t truncated = 0;
+    EXPECT_THROW(archive(SerializeNamed<InputArchive>("large", truncated)), cereal::Exception);
+    EXPECT_THROW(archive(SerializeNamed<InputArchive>("missing", truncated)), cereal::Exception);
+}
+
+
+TEST_F(InSituJSONArchiveTest, LoadStatesConcurrently)
+{
+    const auto pFirstModule = registerModule<ArchiveTestModule>();
+    const auto pSecondModule = registerModule<ArchiveSecondTestModule>();
+
+    pFirstModule->setState(makeArchiveTestState(8));
+    pSecondModule->setState(makeArchiveTestState(32));
+
+    std::ostringstream oss;
+    {
+        auto archive = Internal::SerializationManager::get().beginSave(oss);
+        ASSERT_NE(archive, std::nullopt);
+        ModuleRegistry::get().saveModuleStates(*archive);
+        Internal::SerializationManager::get().finish();
+    }
+
+    pFirstModule->setState(std::make_shared<ArchiveTestState>());
+    pSecondModule->setState(std::make_shared<ArchiveTestState>());
+
+    // Both states are of the same polymorphic type, so the second one only refers to the name written by the first one
+    std::istringstream iss(oss.str());
+    {
+        auto archive = Internal::SerializationManager::get().beginLoad(iss);
+        ASSERT_NE(archive, std::nullopt);
+        ModuleRegistry::get().loadModuleStates(*archive);
+        Internal::SerializationManager::get().finish();
+    }
+
+    ASSERT_EQ(pFirstModule->getState()->records.size(), 8);
+    ASSERT_EQ(pSecondModule->getState()->records.size(), 32);
+    EXPECT_EQ(pSecondModule->getState()->records[31].name, "Object 31");
+}
+
+
+TEST_F(InSituJSONArchiveTest, SplitArrayKeepsSharedPointers)
+{
+    std::istringstream independent(R"({ "values": [ { "ptr_wrapper": { "id": 2147483649, "data": 1 } }, { "ptr_wrapper": { "id": 0 } } ] })");
+    auto independentArchive = InputArchive(independent);
+    const auto elementArchives = independentArchive.splitArray("values");
+    ASSERT_TRUE(elementArchives.has_value());
+    EXPECT_EQ(elementArchives->size(), 2);
+
+    // The second element refers to the pointer written in the first one, so they can only be read together
+    std::istringstream shared(R"({ "values": [ { "ptr_wrapper": { "id": 2147483649, "data": 1 } }, { "ptr_wrapper": { "id": 1 } } ] })");
+    auto sharedArchive = InputArchive(shared);
+    EXPECT_FALSE(sharedArchive.splitArray("values").has_value());
+}
+
+} // namespace GraphEx::Test
@@ -1,4 +1,5 @@
 #include "GraphExTests.h"
+#include "Plugins/TestPluginModule.h"
 
 
 namespace GraphEx::Test
@@ -180,4 +181,88 @@ TEST(ModuleRegistry, Cleanup)
     cleanup();
 }
 
+
+#ifdef GRAPHEX_TEST_PLUGIN_PATH
+
+struct TestPluginModuleContainer : TestModuleContainer
+{
+    std::vector<ModuleId> registeredModuleIds;
+
+protected:
+    // Only the IDs are kept, a reference to a plugin module would keep it from being reloaded
+    void onModuleRegistered(const std::shared_ptr<Module>& pModule) override
+    {
+        registeredModuleIds.push_back(pModule->getModuleId());
+    }
+};
+
+
+TEST(ModuleRegistry, PluginModuleResolvesHostModule)
+{
+    auto testContainer = TestModuleContainer();
+    const auto containerId = testContainer.getModuleContainerId();
+
+    const auto pHostModule = ModuleRegistry::get().registerModuleForContainer<TestPluginHostModule>(containerId, &testContainer);
+    pHostModule->value = 7;
+
+    const auto pModule = ModuleRegistry::get().registerPluginModuleForContainer(containerId, &testContainer, GRAPHEX_TEST_PLUGIN_PATH,
+                                                                               "TestPluginModule");
+    ASSERT_NE(pModule, nullptr);
+
+    // The library shares the registry of the host rather than having one of its own, which would be empty
+    pModule->init(nullptr);
+    EXPECT_EQ(std::static_pointer_cast<TestPluginModule>(pModule)->getHostValue(), 7);
+
+    cleanup();
+}
+
+
+TEST(ModuleRegistry, ReloadPluginModuleWithState)
+{
+    // A copy is reloaded, so that the write time of the built library is left as it is
+    const auto libraryPath = std::filesystem::temp_directory_path() / "GraphEx" / "Tests" / std::filesystem::path(GRAPHEX_TEST_PLUGIN_PATH).filename();
+    std::filesystem::create_directories(libraryPath.parent_path());
+    std::filesystem::copy_file(GRAPHEX_TEST_PLUGIN_PATH, libraryPath, std::filesystem::copy_options::overwrite_existing);
+
+    auto testContainer = TestPluginModuleContainer();
+    const auto containerId = testContainer.getModuleContainerId();
+    const ModuleId moduleId = "GraphEx.Test.TestPluginModule";
+
+    // No references to the module may be left over the reload, nor to anything else created by the library
+    {
+        const auto pModule = ModuleRegistry::get().registerPluginModuleForContainer(containerId, &testContainer, libraryPath, "TestPluginModule");
+        ASSERT_NE(pModule, nullptr);
+        EXPECT_TRUE(ModuleRegistry::get().containerHasModule(containerId, moduleId));
+        std::static_pointer_cast<TestPluginModule>(pModule)->getState()->intValue = 42;
+        EXPECT_FALSE(std::static_pointer_cast<TestPluginModule>(pModule)->getInitCalled());
+        EXPECT_EQ(testContainer.registeredModuleIds, std::vector<ModuleId>{ moduleId });
+    }
+
+    std::filesystem::last_write_time(libraryPath, std::filesystem::last_write_time(libraryPath) + std::chrono::seconds(1));
+
+    // The change is only reported once the write time settled
+    ModuleRegistry::get().reloadChangedPluginModules(nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    ModuleRegistry::get().reloadChangedPluginModules(nullptr);
+
+    {
+        const auto pModule = ModuleRegistry::get().getModuleForContainer(containerId, moduleId);
+        ASSERT_NE(pModule, nullptr);
+
+        // Only the module recreated by the reload was initialized
+        EXPECT_TRUE(std::static_pointer_cast<TestPluginModule>(pModule)->getInitCalled());
+        EXPECT_EQ(std::static_pointer_cast<TestPluginModule>(pModule)->getState()->intValue, 42);
+
+        // The recreated module is announced to the container like the original one
+        EXPECT_EQ(testContainer.registeredModuleIds, std::vector<ModuleId>(2, moduleId));
+    }
+
+    cleanup();
+
+    std::error_code ec;
+    std::filesystem::remove(libraryPath, ec);
+}
+
+#endif // GRAPHEX_TEST_PLUGIN_PATH
+
 } // namespace GraphEx::Test
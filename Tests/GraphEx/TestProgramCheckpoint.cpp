@@ -0,0 +1,76 @@
+#include "GraphExTests.h"
+
+#include <numeric>
+
+
+using namespace GraphEx;
+
+
+namespace GraphEx::Test
+{
+
+TEST(ProgramCheckpoint, RoundTrip)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "GraphExTestCheckpoint.gxchkpt";
+    std::filesystem::remove(filePath);
+
+    std::vector<uint32_t> values(100);
+    std::iota(values.begin(), values.end(), 0u);
+    std::vector<uint32_t> other(10, 7);
+
+    const auto pWrapper = ComputeProgramWrapper::create(getTestDevice(), getTestShaderPath("TestBuffers.cs.slang"));
+    pWrapper->addDefine("ADDEND", "3");
+    pWrapper->waitForCompilation();
+    pWrapper->allocateStructuredBuffer("values", 100, values.data(), values.size() * sizeof(uint32_t));
+    pWrapper->allocateStructuredBuffer("other", 10, other.data(), other.size() * sizeof(uint32_t));
+
+    ProgramCheckpoint checkpoint(pWrapper);
+    ASSERT_TRUE(checkpoint.begin(filePath));
+    EXPECT_FALSE(checkpoint.begin(filePath));
+    checkpoint.update(true);
+    EXPECT_FALSE(checkpoint.isPending());
+
+    // The restored defines select the variant that the dispatch runs
+    const auto pRestored = ComputeProgramWrapper::create(getTestDevice(), getTestShaderPath("TestBuffers.cs.slang"));
+    ASSERT_TRUE(ProgramCheckpoint::restore(*pRestored, filePath));
+    EXPECT_EQ(pRestored->getDefines().at("ADDEND"), "3");
+    EXPECT_EQ(pRestored->readStructuredBuffer<uint32_t>("values"), values);
+
+    pRestored->runProgram(100);
+
+    for (auto& value : values)
+    {
+        value += 3;
+    }
+
+    for (auto& value : other)
+    {
+        value += 1;
+    }
+
+    EXPECT_EQ(pRestored->readStructuredBuffer<uint32_t>("values"), values);
+    EXPECT_EQ(pRestored->readStructuredBuffer<uint32_t>("other"), other);
+
+    // The elements of the values were widened since, that buffer is skipped and left as it was, while the other one is restored
+    const auto pChanged = ComputeProgramWrapper::create(getTestDevice(), getTestShaderPath("TestBuffersWide.cs.slang"));
+    const std::vector<uint32_t> wideValues(16, 5);
+    pChanged->allocateStructuredBuffer("values", 8, wideValues.data(), wideValues.size() * sizeof(uint32_t));
+    const auto pWideBuffer = pChanged->getStructuredBuffers().at("values");
+
+    EXPECT_FALSE(ProgramCheckpoint::restore(*pChanged, filePath));
+    EXPECT_EQ(pChanged->getStructuredBuffers().at("values"), pWideBuffer);
+    EXPECT_EQ(pChanged->readStructuredBuffer<uint32_t>("other"), std::vector<uint32_t>(10, 7));
+
+    const auto changedValues = pChanged->readStructuredBuffer<Falcor::uint2>("values");
+    ASSERT_EQ(changedValues.size(), 8);
+
+    for (const auto& value : changedValues)
+    {
+        EXPECT_EQ(value.x, 5u);
+        EXPECT_EQ(value.y, 5u);
+    }
+
+    std::filesystem::remove(filePath);
+}
+
+} // namespace GraphEx::Test
@@ -0,0 +1,110 @@
+#include "GraphExTests.h"
+
+
+using namespace GraphEx;
+
+
+namespace GraphEx::Test
+{
+
+TEST(ProgramContext, SkipUnchangedProviderVars)
+{
+    Core::Material material;
+    Core::Material otherMaterial;
+    ProgramVarsUpload upload;
+
+    EXPECT_TRUE(upload.update(material));
+    EXPECT_FALSE(upload.update(material));
+
+    material.setShininess(2.0f);
+    EXPECT_TRUE(upload.update(material));
+    EXPECT_FALSE(upload.update(material));
+
+    // Another provider's vars were set in between
+    EXPECT_TRUE(upload.update(otherMaterial));
+    EXPECT_TRUE(upload.update(material));
+
+    // A copy changes independently of the original
+    auto copiedMaterial = material;
+    EXPECT_TRUE(upload.update(copiedMaterial));
+
+    // Unversioned providers are always set
+    ProgramVarProvider unversionedProvider;
+    EXPECT_TRUE(upload.update(unversionedProvider));
+    EXPECT_TRUE(upload.update(unversionedProvider));
+}
+
+
+TEST(ProgramContext, SceneObjectVersioning)
+{
+    struct ColoredObject : Core::SceneObject
+    {
+        Falcor::float3 color{ 1.0f };
+
+        void setProgramVars(const Falcor::ShaderVar& var) const override
+        {
+            SceneObject::setProgramVars(var);
+            trySetProgramVar(var, "_color", color);
+        }
+
+        // Its color is not versioned, so it opts out
+        uint64_t getProgramVarsVersion() const override
+        {
+            return UNVERSIONED;
+        }
+    };
+
+    Core::SceneObject object;
+    ProgramVarsUpload upload;
+
+    EXPECT_TRUE(upload.update(object));
+    EXPECT_FALSE(upload.update(object));
+
+    object.getMaterial().setShininess(2.0f);
+    EXPECT_TRUE(upload.update(object));
+    EXPECT_FALSE(upload.update(object));
+
+    object.getTransform().setPosition(Falcor::float3(1.0f));
+    EXPECT_TRUE(upload.update(object));
+
+    ColoredObject coloredObject;
+    EXPECT_TRUE(upload.update(coloredObject));
+    coloredObject.color = Falcor::float3(0.5f);
+    EXPECT_TRUE(upload.update(coloredObject));
+}
+
+
+TEST(ProgramContext, CameraManagerVersioning)
+{
+    EventManager::get().registerEvent<Core::KeyboardEvent>();
+    EventManager::get().registerEvent<Core::MouseEvent>();
+    EventManager::get().registerEvent<Core::GamepadEvent>();
+
+    auto testContainer = TestModuleContainer();
+    const auto pCameraManager =
+        ModuleRegistry::get().registerModuleForContainer<Core::CameraManager>(testContainer.getModuleContainerId(), &testContainer);
+    pCameraManager->init(nullptr);
+    pCameraManager->update(nullptr, nullptr);
+
+    ProgramVarsUpload upload;
+    EXPECT_TRUE(upload.update(*pCameraManager));
+
+    // Falcor reports no changes of the camera
+    pCameraManager->update(nullptr, nullptr);
+    EXPECT_FALSE(upload.update(*pCameraManager));
+
+    pCameraManager->getActiveCamera()->setPosition(Falcor::float3(1.0f, 0.0f, 0.0f));
+    pCameraManager->update(nullptr, nullptr);
+    EXPECT_TRUE(upload.update(*pCameraManager));
+
+    pCameraManager->setMakeNewCameraActive(false);
+    pCameraManager->addCamera(Falcor::Camera::create("Other Camera"));
+    EXPECT_FALSE(upload.update(*pCameraManager));
+
+    pCameraManager->switchCamera(1);
+    EXPECT_TRUE(upload.update(*pCameraManager));
+
+    cleanup();
+}
+
+} // namespace GraphEx::Test
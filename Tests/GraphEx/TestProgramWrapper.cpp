@@ -0,0 +1,116 @@
+#include "GraphExTests.h"
+
+#include <numeric>
+
+
+using namespace GraphEx;
+
+
+namespace GraphEx::Test
+{
+
+TEST(ProgramWrapper, UpdateStructuredBufferGrowsAndKeepsContents)
+{
+    const auto pWrapper = ComputeProgramWrapper::create(getTestDevice(), getTestShaderPath("TestBuffers.cs.slang"));
+
+    std::vector<uint32_t> values(150);
+    std::iota(values.begin(), values.end(), 0u);
+
+    pWrapper->updateStructuredBuffer("values", 100, values.data(), 100 * sizeof(uint32_t));
+    EXPECT_EQ(pWrapper->getStructuredBuffers().at("values")->getElementCount(), 100);
+
+    // Written past the end, the buffer grows to twice its size, keeping what was written before
+    pWrapper->updateStructuredBuffer("values", 150, values.data() + 100, 50 * sizeof(uint32_t), 100);
+    const auto pGrownBuffer = pWrapper->getStructuredBuffers().at("values");
+    EXPECT_EQ(pGrownBuffer->getElementCount(), 200);
+
+    // Within the buffer, it is not reallocated
+    values[20] = 1000;
+    pWrapper->updateStructuredBuffer("values", 21, values.data() + 20, sizeof(uint32_t), 20);
+    EXPECT_EQ(pWrapper->getStructuredBuffers().at("values"), pGrownBuffer);
+
+    auto result = pWrapper->readStructuredBuffer<uint32_t>("values");
+    result.resize(values.size());
+    EXPECT_EQ(result, values);
+}
+
+
+
+TEST(ProgramWrapper, ReadStructuredBufferAsync)
+{
+    std::vector<uint32_t> values(100);
+    std::iota(values.begin(), values.end(), 0u);
+
+    const auto pWrapper = ComputeProgramWrapper::create(getTestDevice(), getTestShaderPath("TestBuffers.cs.slang"));
+    pWrapper->allocateStructuredBuffer("values", 100, values.data(), values.size() * sizeof(uint32_t));
+
+    std::vector<uint32_t> callbackValues;
+    auto future = pWrapper->readStructuredBufferAsync<uint32_t>("values", [&](const std::vector<uint32_t>& elements) {
+        callbackValues = elements;
+    });
+
+    // A callback that throws still makes its future ready, and the readbacks after it are delivered
+    auto throwingFuture = pWrapper->readStructuredBufferAsync<uint32_t>("values", [](const std::vector<uint32_t>&) {
+        throw std::runtime_error("Readback callback failed");
+    });
+    auto laterFuture = pWrapper->readStructuredBufferAsync<uint32_t>("values");
+
+    ASSERT_TRUE(runFramesUntil(getTestDevice(), [&]() {
+        return laterFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }));
+
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_EQ(future.get(), values);
+    EXPECT_EQ(callbackValues, values);
+
+    ASSERT_EQ(throwingFuture.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_THROW(throwingFuture.get(), std::runtime_error);
+    EXPECT_EQ(laterFuture.get(), values);
+}
+
+
+
+TEST(ProgramWrapper, BatchCallbackMayCompile)
+{
+    std::vector<uint32_t> values(100, 0);
+
+    const auto pWrapper = ComputeProgramWrapper::create(getTestDevice(), getTestShaderPath("TestBuffers.cs.slang"));
+    pWrapper->waitForCompilation();
+    pWrapper->allocateStructuredBuffer("values", 100, values.data(), values.size() * sizeof(uint32_t));
+    pWrapper->allocateStructuredBuffer("other", 100, values.data(), values.size() * sizeof(uint32_t));
+
+    // Compiling another variant from the callback, before the first dispatch of this one, must not deadlock
+    const auto pOtherWrapper = ComputeProgramWrapper::create(getTestDevice(), getTestShaderPath("TestBuffers.cs.slang"));
+    pOtherWrapper->addDefine("ADDEND", "2");
+
+    pWrapper->runProgramBatch({ Falcor::uint3(100, 1, 1) }, [&](const Falcor::ShaderVar&, size_t) {
+        pOtherWrapper->waitForCompilation();
+        pWrapper->getRootVar();
+    });
+
+    EXPECT_EQ(pWrapper->readStructuredBuffer<uint32_t>("values"), std::vector<uint32_t>(100, 1));
+}
+
+
+
+TEST(ProgramWrapper, CompilationMutexMayBeHeldAroundWrappers)
+{
+    auto& mutex = ProgramWrapper::getCompilationMutex();
+    EXPECT_FALSE(mutex.isHeld());
+
+    {
+        std::lock_guard lock(mutex);
+        EXPECT_TRUE(mutex.isHeld());
+        EXPECT_FALSE(std::async(std::launch::async, [&mutex]() { return mutex.isHeld(); }).get());
+
+        // The wrappers take it again to compile
+        const auto pWrapper = ComputeProgramWrapper::create(getTestDevice(), getTestShaderPath("TestBuffers.cs.slang"));
+        pWrapper->addDefine("ADDEND", "2");
+        pWrapper->waitForCompilation();
+        EXPECT_TRUE(mutex.isHeld());
+    }
+
+    EXPECT_FALSE(mutex.isHeld());
+}
+
+} // namespace GraphEx::Test
@@ -0,0 +1,465 @@
+#include "ProjectArchiveTests.h"
+
+#if FALCOR_WINDOWS
+#include <Windows.h>
+#include <psapi.h>
+#elif FALCOR_LINUX
+#include <sys/resource.h>
+#endif
+
+
+namespace GraphEx::Test
+{
+
+struct ProjectArchiveTest : ProjectArchiveFixture {};
+
+
+size_t getPeakResidentSetSize()
+{
+#if FALCOR_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters{ };
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#elif FALCOR_LINUX
+    rusage usage{ };
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#else
+    return 0;
+#endif
+}
+
+
+TEST_F(ProjectArchiveTest, SaveAndLoadBinary)
+{
+    const auto pTestModule = registerModule<ArchiveTestModule>();
+
+    pTestModule->setState(makeArchiveTestState(16));
+
+    const auto data = saveBinaryProject();
+
+    cleanup();
+
+    const auto pRestoredModule = registerModule<ArchiveTestModule>();
+
+    loadBinaryProject(data);
+
+    const auto& pRestoredState = pRestoredModule->getState();
+    ASSERT_EQ(pRestoredState->records.size(), 16);
+    EXPECT_EQ(pRestoredState->label, "Archive Test");
+    EXPECT_EQ(pRestoredState->records[7].name, "Object 7");
+    EXPECT_EQ(pRestoredState->records[7].position.y, 3.5f);
+    EXPECT_EQ(pRestoredState->records[7].id, 7);
+}
+
+
+TEST_F(ProjectArchiveTest, BinarySkipsUnregisteredState)
+{
+    const auto pTestModule = registerModule<ArchiveTestModule>();
+    const auto pUnregisteredModule = registerModule<ArchiveUnregisteredTestModule>();
+
+    pTestModule->setState(makeArchiveTestState(4));
+
+    auto pUnregisteredState = std::make_shared<ArchiveUnregisteredState>();
+    pUnregisteredState->intValue = 42;
+    pUnregisteredModule->setState(pUnregisteredState);
+
+    const auto data = saveBinaryProject();
+
+    cleanup();
+
+    const auto pRestoredModule = registerModule<ArchiveTestModule>();
+    const auto pRestoredUnregisteredModule = registerModule<ArchiveUnregisteredTestModule>();
+
+    loadBinaryProject(data);
+
+    EXPECT_EQ(pRestoredModule->getState()->records.size(), 4);
+    EXPECT_EQ(pRestoredUnregisteredModule->getState()->intValue, 0);
+}
+
+
+TEST_F(ProjectArchiveTest, DetectFormat)
+{
+    EXPECT_EQ(Internal::SerializationManager::getProjectFormat("project.gxprojb"), Internal::ProjectFormat::Binary);
+    EXPECT_EQ(Internal::SerializationManager::getProjectFormat("project.gxproj"), Internal::ProjectFormat::Json);
+
+    registerModule<ArchiveTestModule>();
+
+    std::istringstream binaryStream(saveBinaryProject(), std::ios::in | std::ios::binary);
+    EXPECT_EQ(Internal::SerializationManager::detectProjectFormat(binaryStream), Internal::ProjectFormat::Binary);
+    EXPECT_EQ(binaryStream.tellg(), 0);  // Detection must not consume the header
+
+    std::istringstream jsonStream("{ \"moduleStates\": [] }");
+    EXPECT_EQ(Internal::SerializationManager::detectProjectFormat(jsonStream), Internal::ProjectFormat::Json);
+
+    std::istringstream shortStream("GX");
+    EXPECT_EQ(Internal::SerializationManager::detectProjectFormat(shortStream), Internal::ProjectFormat::Json);
+    EXPECT_EQ(Internal::SerializationManager::get().beginBinaryLoad(shortStream), std::nullopt);
+}
+
+
+TEST_F(ProjectArchiveTest, FileWriterReplacesOnlyOnCommit)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "GraphExTestFileWriter.gxproj";
+
+    {
+        std::ofstream os(filePath, std::ios::out | std::ios::trunc);
+        os << "original";
+    }
+
+    {
+        ProjectFileWriter writer(filePath);
+        ASSERT_TRUE(writer.isOpen());
+        writer.getStream() << "interrupted";
+    }
+
+    EXPECT_EQ(readFile(filePath), "original");
+
+    {
+        ProjectFileWriter writer(filePath);
+        ASSERT_TRUE(writer.isOpen());
+        writer.getStream() << "replaced";
+        EXPECT_EQ(readFile(filePath), "original");
+        EXPECT_TRUE(writer.commit());
+        EXPECT_FALSE(writer.isOpen());
+    }
+
+    EXPECT_EQ(readFile(filePath), "replaced");
+
+    const auto leftovers = std::count_if(
+        std::filesystem::directory_iterator(filePath.parent_path()),
+        std::filesystem::directory_iterator(),
+        [&](const auto& entry) { return entry.path().filename().string().rfind(filePath.filename().string() + ".", 0) == 0; }
+    );
+
+    EXPECT_EQ(leftovers, 0);
+
+    std::filesystem::remove(filePath);
+}
+
+
+TEST_F(ProjectArchiveTest, LoadJsonFromMappedFile)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "GraphExTestMappedLoad.gxproj";
+
+    const auto pTestModule = registerModule<ArchiveTestModule>();
+
+    pTestModule->setState(makeArchiveTestState(64));
+
+    {
+        ProjectFileWriter writer(filePath);
+        {
+            auto archive = Internal::SerializationManager::get().beginSave(writer.getStream());
+            ASSERT_NE(archive, std::nullopt);
+            ModuleRegistry::get().saveModuleStates(*archive);
+        }
+        Internal::SerializationManager::get().finish();
+        ASSERT_TRUE(writer.commit());
+    }
+
+    cleanup();
+
+    const auto pRestoredModule = registerModule<ArchiveTestModule>();
+
+    {
+        ProjectFileReader reader(filePath);
+        ASSERT_TRUE(reader.isOpen());
+        EXPECT_EQ(reader.getSize(), std::filesystem::file_size(filePath));
+        EXPECT_EQ(Internal::SerializationManager::detectProjectFormat(reader.getStream()), Internal::ProjectFormat::Json);
+
+        auto archive = Internal::SerializationManager::get().beginLoad(reader);
+        ASSERT_NE(archive, std::nullopt);
+        ModuleRegistry::get().loadModuleStates(*archive);
+        Internal::SerializationManager::get().finish();
+    }
+
+    const auto& pRestoredState = pRestoredModule->getState();
+    ASSERT_EQ(pRestoredState->records.size(), 64);
+    EXPECT_EQ(pRestoredState->records[63].name, "Object 63");
+    EXPECT_EQ(pRestoredState->records[63].id, 63);
+
+    std::filesystem::remove(filePath);
+}
+
+
+TEST_F(ProjectArchiveTest, MappedFileIsTerminated)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "GraphExTestMappedTerminator.bin";
+
+    // Sizes around common page sizes, where the terminating zero cannot come from the tail of the last mapped page
+    for (const size_t size : { size_t(1), size_t(4095), size_t(4096), size_t(65536) })
+    {
+        {
+            std::ofstream os(filePath, std::ios::out | std::ios::trunc | std::ios::binary);
+            const std::string content(size, 'x');
+            os.write(content.data(), static_cast<std::streamsize>(content.size()));
+        }
+
+        ProjectFileReader reader(filePath);
+        ASSERT_TRUE(reader.isOpen());
+        ASSERT_EQ(reader.getSize(), size);
+        EXPECT_EQ(reader.getData()[size - 1], 'x');
+        EXPECT_EQ(reader.getData()[size], '\0');
+
+        // The mapping is private, writing to it must not change the file
+        reader.getData()[0] = 'y';
+    }
+
+    EXPECT_EQ(readFile(filePath).front(), 'x');
+
+    std::filesystem::remove(filePath);
+}
+
+
+TEST_F(ProjectArchiveTest, SceneObjectPayloadLoadsOnDemand)
+{
+    auto pObject = std::make_shared<ArchivePayloadObject>();
+    pObject->setHumanReadableName("Payload Object");
+    pObject->getTransform().setPosition({ 1.0f, 2.0f, 3.0f });
+    pObject->vertices = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+
+    const auto save = [](const std::vector<Core::SerializedSceneObjectState>& objects)
+    {
+        std::ostringstream oss;
+        {
+            auto archive = Internal::SerializationManager::get().beginSave(oss);
+            EXPECT_NE(archive, std::nullopt);
+            (*archive)(SaveNamed("objects", objects));
+            Internal::SerializationManager::get().finish();
+        }
+
+        return oss.str();
+    };
+
+    const auto load = [](const std::string& data)
+    {
+        std::vector<Core::SerializedSceneObjectState> objects;
+        std::istringstream iss(data);
+        {
+            auto archive = Internal::SerializationManager::get().beginLoad(iss);
+            EXPECT_NE(archive, std::nullopt);
+            (*archive)(LoadNamed("objects", objects));
+            Internal::SerializationManager::get().finish();
+        }
+
+        return objects;
+    };
+
+    const auto loaded = load(save({ Core::SerializedSceneObjectState(pObject) }));
+    ASSERT_EQ(loaded.size(), 1);
+    ASSERT_TRUE(loaded[0].success());
+
+    // Only the stub is loaded up front
+    const auto pLoaded = std::dynamic_pointer_cast<ArchivePayloadObject>(loaded[0].get());
+    ASSERT_NE(pLoaded, nullptr);
+    EXPECT_EQ(pLoaded->getHumanReadableName(), "Payload Object");
+    EXPECT_EQ(pLoaded->getTransform().getPosition().z, 3.0f);
+    EXPECT_FALSE(pLoaded->isPayloadLoaded());
+    EXPECT_TRUE(pLoaded->vertices.empty());
+
+    // Saving an object whose payload was never needed keeps the payload
+    const auto reloaded = load(save(loaded));
+    const auto pReloaded = std::dynamic_pointer_cast<ArchivePayloadObject>(reloaded[0].get());
+    ASSERT_NE(pReloaded, nullptr);
+
+    for (const auto& pObjectWithPayload : { pLoaded, pReloaded })
+    {
+        EXPECT_TRUE(pObjectWithPayload->ensurePayloadLoaded());
+        EXPECT_TRUE(pObjectWithPayload->isPayloadLoaded());
+        ASSERT_EQ(pObjectWithPayload->vertices.size(), 3);
+        EXPECT_EQ(pObjectWithPayload->vertices[2].y, 1.0f);
+    }
+}
+
+
+TEST_F(ProjectArchiveTest, LoadSelectedModuleStates)
+{
+    const auto pFirstModule = registerModule<ArchiveTestModule>();
+    const auto pSecondModule = registerModule<ArchiveSecondTestModule>();
+
+    pFirstModule->setState(makeArchiveTestState(8));
+    pSecondModule->setState(makeArchiveTestState(32));
+
+    std::ostringstream oss;
+    {
+        auto archive = Internal::SerializationManager::get().beginSave(oss);
+        ASSERT_NE(archive, std::nullopt);
+        ModuleRegistry::get().saveModuleStates(*archive);
+        Internal::SerializationManager::get().finish();
+    }
+
+    const auto binaryData = saveBinaryProject();
+
+    const ModuleRegistry::ModuleStateFilter selectSecond = [](const ModuleId& moduleId) {
+        return moduleId == "GraphEx.Test.ArchiveSecondTestModule";
+    };
+
+    // The skipped first state is where the name of their common polymorphic type is written, the second one must still load
+    pFirstModule->setState(std::make_shared<ArchiveTestState>());
+    pSecondModule->setState(std::make_shared<ArchiveTestState>());
+
+    std::istringstream iss(oss.str());
+    {
+        auto archive = Internal::SerializationManager::get().beginLoad(iss);
+        ASSERT_NE(archive, std::nullopt);
+        ModuleRegistry::get().loadModuleStates(*archive, selectSecond);
+        Internal::SerializationManager::get().finish();
+    }
+
+    EXPECT_TRUE(pFirstModule->getState()->records.empty());
+    ASSERT_EQ(pSecondModule->getState()->records.size(), 32);
+
+    // Binary archives cannot skip, but apply the selected states only just the same
+    pSecondModule->setState(std::make_shared<ArchiveTestState>());
+
+    std::istringstream binaryIss(binaryData, std::ios::in | std::ios::binary);
+    {
+        auto archive = Internal::SerializationManager::get().beginBinaryLoad(binaryIss);
+        ASSERT_NE(archive, std::nullopt);
+        ModuleRegistry::get().loadModuleStates(*archive, selectSecond);
+        Internal::SerializationManager::get().finish();
+    }
+
+    EXPECT_TRUE(pFirstModule->getState()->records.empty());
+    EXPECT_EQ(pSecondModule->getState()->records.size(), 32);
+}
+
+
+TEST_F(ProjectArchiveTest, SaveFromSnapshotOnWorkerThread)
+{
+    const auto pTestModule = registerModule<ArchiveTestModule>();
+
+    pTestModule->setState(makeArchiveTestState(16));
+
+    const auto snapshot = ModuleRegistry::get().takeStateSnapshot();
+
+    // Changes made after the snapshot was taken must not end up in the saved project
+    pTestModule->getState()->label = "Changed";
+    pTestModule->getState()->records.clear();
+
+    std::vector<size_t> savedCounts;
+
+    const auto data = std::async(std::launch::async, [&snapshot, &savedCounts]()
+    {
+        std::ostringstream oss(std::ios::out | std::ios::binary);
+        {
+            auto archive = Internal::SerializationManager::get().beginBinarySave(oss);
+            EXPECT_NE(archive, std::nullopt);
+            ModuleRegistry::saveModuleStateSnapshot(*archive, snapshot, [&savedCounts](const size_t savedCount) {
+                savedCounts.push_back(savedCount);
+            });
+            Internal::SerializationManager::get().finish();
+        }
+
+        return oss.str();
+    }).get();
+
+    ASSERT_EQ(savedCounts.size(), snapshot.size());
+    EXPECT_EQ(savedCounts.back(), snapshot.size());
+
+    loadBinaryProject(data);
+
+    const auto& pRestoredState = pTestModule->getState();
+    ASSERT_EQ(pRestoredState->records.size(), 16);
+    EXPECT_EQ(pRestoredState->label, "Archive Test");
+    EXPECT_EQ(pRestoredState->records[7].name, "Object 7");
+}
+
+
+// Not a correctness test: run explicitly with --gtest_also_run_disabled_tests to compare the archive families
+TEST_F(ProjectArchiveTest, DISABLED_BenchmarkJsonAgainstBinary)
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t RECORD_COUNT = 200000;
+
+    const auto pTestModule = registerModule<ArchiveTestModule>();
+
+    pTestModule->setState(makeArchiveTestState(RECORD_COUNT));
+
+    const auto toMilliseconds = [](const Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+
+    auto start = Clock::now();
+    std::ostringstream jsonStream;
+    {
+        auto archive = Internal::SerializationManager::get().beginSave(jsonStream);
+        ModuleRegistry::get().saveModuleStates(*archive);
+        Internal::SerializationManager::get().finish();
+    }
+    const auto jsonSaveTime = toMilliseconds(Clock::now() - start);
+
+    start = Clock::now();
+    const auto binaryData = saveBinaryProject();
+    const auto binarySaveTime = toMilliseconds(Clock::now() - start);
+
+    start = Clock::now();
+    {
+        std::istringstream iss(jsonStream.str());
+        auto archive = Internal::SerializationManager::get().beginLoad(iss);
+        ModuleRegistry::get().loadModuleStates(*archive);
+        Internal::SerializationManager::get().finish();
+    }
+    const auto jsonLoadTime = toMilliseconds(Clock::now() - start);
+
+    start = Clock::now();
+    loadBinaryProject(binaryData);
+    const auto binaryLoadTime = toMilliseconds(Clock::now() - start);
+
+    EXPECT_EQ(pTestModule->getState()->records.size(), RECORD_COUNT);
+
+    std::cout << "Records: " << RECORD_COUNT << "\n"
+              << "JSON:   " << jsonStream.str().size() << " bytes, save " << jsonSaveTime << " ms, load " << jsonLoadTime << " ms\n"
+              << "Binary: " << binaryData.size() << " bytes, save " << binarySaveTime << " ms, load " << binaryLoadTime << " ms\n";
+}
+
+
+// Not a correctness test: run explicitly with --gtest_also_run_disabled_tests. Run it in a separate process from the other benchmarks,
+// as the peak resident set size is only ever growing during the lifetime of the process
+TEST_F(ProjectArchiveTest, DISABLED_BenchmarkStreamingSave)
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t RECORD_COUNT = 1000000;
+
+    const auto pTestModule = registerModule<ArchiveTestModule>();
+
+    pTestModule->setState(makeArchiveTestState(RECORD_COUNT));
+
+    for (const auto& extension : { ".gxproj", ".gxprojb" })
+    {
+        const auto filePath = std::filesystem::temp_directory_path() / (std::string("GraphExBenchmarkStreamingSave") + extension);
+        const auto peakBefore = getPeakResidentSetSize();
+        const auto start = Clock::now();
+
+        {
+            ProjectFileWriter writer(filePath);
+            ASSERT_TRUE(writer.isOpen());
+
+            if (Internal::SerializationManager::getProjectFormat(filePath) == Internal::ProjectFormat::Binary)
+            {
+                auto archive = Internal::SerializationManager::get().beginBinarySave(writer.getStream());
+                ModuleRegistry::get().saveModuleStates(*archive);
+            }
+            else
+            {
+                auto archive = Internal::SerializationManager::get().beginSave(writer.getStream());
+                ModuleRegistry::get().saveModuleStates(*archive);
+            }
+
+            Internal::SerializationManager::get().finish();
+            ASSERT_TRUE(writer.commit());
+        }
+
+        const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const auto fileSize = std::filesystem::file_size(filePath);
+
+        std::cout << extension << ": " << fileSize << " bytes in " << seconds * 1000.0 << " ms, "
+                  << static_cast<double>(fileSize) / (1024.0 * 1024.0) / seconds << " MiB/s, peak RSS grew by "
+                  << (getPeakResidentSetSize() - peakBefore) / 1024 << " KiB\n";
+
+        std::filesystem::remove(filePath);
+    }
+}
+
+} // namespace GraphEx::Test
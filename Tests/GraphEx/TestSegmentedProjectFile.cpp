@@ -0,0 +1,125 @@
+#include "ProjectArchiveTests.h"
+
+
+namespace GraphEx::Test
+{
+
+struct SegmentedProjectFileTest : ProjectArchiveFixture {};
+
+
+TEST_F(SegmentedProjectFileTest, AutosaveRewritesOnlyChangedStates)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "GraphExTestAutosave.gxautosave";
+
+    const auto pTestModule = registerModule<ArchiveTestModule>();
+    const auto pSecondTestModule = registerModule<ArchiveSecondTestModule>();
+
+    pTestModule->setState(makeArchiveTestState(1000));
+    pSecondTestModule->setState(makeArchiveTestState(8));
+
+    {
+        Internal::SegmentedProjectFile file;
+        ASSERT_TRUE(file.create(filePath));
+
+        EXPECT_EQ(ModuleRegistry::get().saveChangedModuleStates(file), 2);
+        EXPECT_EQ(ModuleRegistry::get().saveChangedModuleStates(file), 0);
+        EXPECT_EQ(file.getStaleSize(), 0);
+
+        const auto sizeBefore = std::filesystem::file_size(filePath);
+
+        pSecondTestModule->getState()->label = "Changed";
+        pSecondTestModule->markStateDirty();
+
+        // Only the small state is appended, the large one stays where it is
+        EXPECT_EQ(ModuleRegistry::get().saveChangedModuleStates(file), 1);
+        EXPECT_LT(std::filesystem::file_size(filePath) - sizeBefore, file.getLiveSize() / 4);
+        EXPECT_GT(file.getStaleSize(), 0);
+    }
+
+    {
+        std::ifstream is(filePath, std::ios::in | std::ios::binary);
+        EXPECT_EQ(Internal::SerializationManager::detectProjectFormat(is), Internal::ProjectFormat::Segmented);
+    }
+
+    cleanup();
+
+    const auto pRestoredModule = registerModule<ArchiveTestModule>();
+    const auto pRestoredSecondModule = registerModule<ArchiveSecondTestModule>();
+
+    {
+        Internal::SegmentedProjectFile file;
+        ASSERT_TRUE(file.open(filePath));
+        EXPECT_TRUE(ModuleRegistry::get().loadModuleStates(file));
+    }
+
+    EXPECT_EQ(pRestoredModule->getState()->records.size(), 1000);
+    EXPECT_EQ(pRestoredSecondModule->getState()->label, "Changed");
+    EXPECT_EQ(pRestoredSecondModule->getState()->records.size(), 8);
+
+    std::filesystem::remove(filePath);
+}
+
+
+TEST_F(SegmentedProjectFileTest, KeepsLastCommit)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "GraphExTestSegmentedCommit.gxautosave";
+
+    {
+        Internal::SegmentedProjectFile file;
+        ASSERT_TRUE(file.create(filePath));
+        ASSERT_TRUE(file.writeSegment("a", "committed"));
+        ASSERT_TRUE(file.commit());
+
+        // Interrupted save: the content is appended, but the header never points at it
+        ASSERT_TRUE(file.writeSegment("a", "uncommitted"));
+        ASSERT_TRUE(file.writeSegment("b", "uncommitted"));
+    }
+
+    {
+        Internal::SegmentedProjectFile file;
+        ASSERT_TRUE(file.open(filePath));
+        EXPECT_EQ(file.readSegment("a"), "committed");
+        EXPECT_FALSE(file.hasSegment("b"));
+    }
+
+    {
+        std::ofstream os(filePath, std::ios::out | std::ios::trunc | std::ios::binary);
+        os << "{ \"moduleStates\": [] }";
+    }
+
+    Internal::SegmentedProjectFile file;
+    EXPECT_FALSE(file.open(filePath));
+
+    std::filesystem::remove(filePath);
+}
+
+
+TEST_F(SegmentedProjectFileTest, Compacts)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "GraphExTestSegmentedCompaction.gxautosave";
+    const std::string largeSegment(Internal::SegmentedProjectFile::COMPACTION_MIN_STALE_SIZE, 'x');
+
+    {
+        Internal::SegmentedProjectFile file;
+        ASSERT_TRUE(file.create(filePath));
+
+        ASSERT_TRUE(file.writeSegment("kept", "small"));
+        ASSERT_TRUE(file.writeSegment("rewritten", largeSegment));
+        ASSERT_TRUE(file.commit());
+        file.setWrittenRevision("kept", 7);
+
+        // The large segment turns stale, which outweighs the live content and triggers the compaction
+        ASSERT_TRUE(file.writeSegment("rewritten", "shrunk"));
+        ASSERT_TRUE(file.commit());
+
+        EXPECT_EQ(file.getStaleSize(), 0);
+        EXPECT_LT(std::filesystem::file_size(filePath), Internal::SegmentedProjectFile::HEADER_SIZE + 1024);
+        EXPECT_EQ(file.readSegment("kept"), "small");
+        EXPECT_EQ(file.readSegment("rewritten"), "shrunk");
+        EXPECT_EQ(file.getWrittenRevision("kept"), 7);
+    }
+
+    std::filesystem::remove(filePath);
+}
+
+} // namespace GraphEx::Test
@@ -0,0 +1,41 @@
+#include "GraphExTests.h"
+
+
+using namespace GraphEx;
+
+
+namespace GraphEx::Test
+{
+
+TEST(ShaderCache, PruneLeastRecentlyWritten)
+{
+    const auto directory = std::filesystem::temp_directory_path() / "GraphExTestShaderCache";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory / "nested");
+
+    const auto writeEntry = [&](const std::filesystem::path& filePath, const size_t size, const int age) {
+        std::ofstream(filePath, std::ios::binary) << std::string(size, 'x');
+        std::filesystem::last_write_time(filePath, std::filesystem::file_time_type::clock::now() - std::chrono::hours(age));
+    };
+
+    writeEntry(directory / "oldest", 100, 3);
+    writeEntry(directory / "nested" / "older", 100, 2);
+    writeEntry(directory / "newest", 100, 1);
+
+    const ShaderCache shaderCache(directory);
+    EXPECT_EQ(shaderCache.getEntries().size(), 3);
+    EXPECT_EQ(shaderCache.getTotalSize(), 300);
+
+    EXPECT_EQ(shaderCache.prune(300), 0);
+    EXPECT_EQ(shaderCache.prune(150), 2);
+    EXPECT_FALSE(std::filesystem::exists(directory / "oldest"));
+    EXPECT_FALSE(std::filesystem::exists(directory / "nested" / "older"));
+    EXPECT_TRUE(std::filesystem::exists(directory / "newest"));
+
+    shaderCache.clear();
+    EXPECT_EQ(shaderCache.getTotalSize(), 0);
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace GraphEx::Test
@@ -0,0 +1,81 @@
+#include "ProjectArchiveTests.h"
+
+
+namespace GraphEx::Test
+{
+
+struct UndoHistoryTest : ProjectArchiveFixture {};
+
+
+TEST_F(UndoHistoryTest, SharesUnchangedContent)
+{
+    const auto pTestModule = registerModule<ArchiveTestModule>();
+
+    pTestModule->setState(makeArchiveTestState(4096));
+
+    const auto stateSize = ModuleRegistry::get().saveModuleState(pTestModule->getModuleId())->data.size();
+
+    UndoHistory history;
+    history.update();
+    EXPECT_EQ(history.getStepCount(), 1);
+    EXPECT_FALSE(history.canUndo());
+
+    pTestModule->getState()->records[2048].name = "Edited";
+    pTestModule->markStateDirty();
+
+    // The edit has not settled yet, undo records it first so that it can be redone
+    ASSERT_TRUE(history.undo());
+    EXPECT_EQ(history.getStepCount(), 2);
+    EXPECT_EQ(pTestModule->getState()->records[2048].name, "Object 2048");
+
+    // Only the chunks around the edited record are stored twice
+    EXPECT_LT(history.getMemoryUsage(), stateSize + stateSize / 4);
+
+    ASSERT_TRUE(history.redo());
+    EXPECT_EQ(pTestModule->getState()->records[2048].name, "Edited");
+    EXPECT_FALSE(history.canRedo());
+
+    // Setting the state is not taken for an edit of its own
+    history.update();
+    EXPECT_EQ(history.getStepCount(), 2);
+
+    // Over the budget, the oldest steps go first, but the current one stays
+    history.setMemoryBudget(0);
+    pTestModule->getState()->records[0].name = "Edited again";
+    pTestModule->markStateDirty();
+
+    EXPECT_FALSE(history.undo());
+    EXPECT_EQ(history.getStepCount(), 1);
+    EXPECT_EQ(pTestModule->getState()->records[0].name, "Edited again");
+}
+
+
+TEST_F(UndoHistoryTest, KeepsBlobsInMemory)
+{
+    const auto filePath = Internal::BlobStore::getSidecarPath(std::filesystem::temp_directory_path() / "GraphExTestUndoBlobs.gxproj");
+    std::filesystem::remove(filePath);
+
+    const auto pTestModule = registerModule<ArchiveBlobTestModule>();
+
+    const auto blob = BlobData::fromVector(std::vector<float>(1024, 2.0f));
+    pTestModule->getState()->blob = blob;
+
+    Internal::SerializationManager::get().setBlobStore(std::make_shared<Internal::BlobStore>(filePath));
+
+    UndoHistory history;
+    history.update();
+    EXPECT_GE(history.getMemoryUsage(), blob.getSize());
+
+    pTestModule->getState()->blob = BlobData::fromVector(std::vector<float>(16, 3.0f));
+    pTestModule->markStateDirty();
+
+    // The recorded blob is shared rather than copied, and the project data file is left alone
+    ASSERT_TRUE(history.undo());
+    EXPECT_EQ(pTestModule->getState()->blob.getData(), blob.getData());
+    EXPECT_FALSE(std::filesystem::exists(filePath));
+
+    ASSERT_TRUE(history.redo());
+    EXPECT_EQ(pTestModule->getState()->blob.getDataAs<float>()[15], 3.0f);
+}
+
+} // namespace GraphEx::Test
@@ -0,0 +1,59 @@
+#include "GraphExTests.h"
+
+#include <numeric>
+
+
+using namespace GraphEx;
+
+
+namespace GraphEx::Test
+{
+
+TEST(UploadRing, WrapAndGrow)
+{
+    const auto& pDevice = getTestDevice();
+    const auto pRenderContext = pDevice->getRenderContext();
+
+    std::vector<uint32_t> values(832);
+    std::iota(values.begin(), values.end(), 0u);
+
+    const auto pBuffer = pDevice->createStructuredBuffer(
+        sizeof(uint32_t),
+        static_cast<uint32_t>(values.size()),
+        Falcor::ResourceBindFlags::ShaderResource | Falcor::ResourceBindFlags::UnorderedAccess,
+        Falcor::MemoryType::DeviceLocal,
+        nullptr,
+        false
+    );
+
+    const auto upload = [&](UploadRing& ring, const size_t firstValue, const size_t valueCount) {
+        ring.upload(pRenderContext, pBuffer, firstValue * sizeof(uint32_t), values.data() + firstValue, valueCount * sizeof(uint32_t));
+    };
+
+    // The GPU is held back until the host signals the fence, so that the first frame is still in flight when the second one begins
+    const auto pBlocker = pDevice->createFence();
+    pRenderContext->wait(pBlocker.get(), 1);
+
+    // At its maximum size already, the ring must reuse its memory instead of growing
+    UploadRing ring(pDevice, 1024, 1024);
+
+    upload(ring, 0, 128);
+    UploadRing::endFrame(pRenderContext);
+    upload(ring, 128, 64);
+
+    // Once the first frame completed, the next upload does not fit behind the second one and wraps around to where the first one was
+    pBlocker->signal(1);
+    pRenderContext->submit(true);
+    upload(ring, 192, 128);
+    UploadRing::endFrame(pRenderContext);
+    EXPECT_EQ(ring.getCapacity(), 1024);
+
+    // Larger than the ring, it grows regardless of the maximum
+    upload(ring, 320, 512);
+    UploadRing::endFrame(pRenderContext);
+    EXPECT_EQ(ring.getCapacity(), 2048);
+
+    EXPECT_EQ(pBuffer->getElements<uint32_t>(), values);
+}
+
+} // namespace GraphEx::Test
@@ -0,0 +1,133 @@
+#include "ProjectArchiveTests.h"
+
+
+namespace GraphEx::Test
+{
+
+struct VectorSerializationTest : ProjectArchiveFixture {};
+
+
+TEST_F(VectorSerializationTest, BulkVectorArrays)
+{
+    std::vector<Falcor::float3> points(1000);
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const auto f = static_cast<float>(i);
+        points[i] = { f, -f, f * 0.25f };
+    }
+
+    std::ostringstream oss;
+    {
+        auto archive = Internal::SerializationManager::get().beginSave(oss);
+        ASSERT_NE(archive, std::nullopt);
+        (*archive)(SaveNamed("points", points));
+    }
+
+    // A single blob instead of a node for every component
+    EXPECT_NE(oss.str().find("\"littleEndian\""), std::string::npos);
+    EXPECT_EQ(oss.str().find("\"value0\""), std::string::npos);
+
+    std::vector<Falcor::float3> loaded;
+    std::istringstream iss(oss.str());
+    {
+        auto archive = Internal::SerializationManager::get().beginLoad(iss);
+        ASSERT_NE(archive, std::nullopt);
+        (*archive)(LoadNamed("points", loaded));
+    }
+
+    ASSERT_EQ(loaded.size(), points.size());
+    EXPECT_EQ(loaded[999].y, -999.0f);
+    EXPECT_EQ(loaded[999].z, 249.75f);
+
+    std::ostringstream binaryOss(std::ios::out | std::ios::binary);
+    {
+        BinaryOutputArchive archive(binaryOss);
+        archive(points);
+    }
+
+    // Raw components plus the size, nothing per element
+    EXPECT_LE(binaryOss.str().size(), points.size() * sizeof(Falcor::float3) + 16);
+
+    std::vector<Falcor::float3> binaryLoaded;
+    std::istringstream binaryIss(binaryOss.str(), std::ios::in | std::ios::binary);
+    {
+        BinaryInputArchive archive(binaryIss);
+        archive(binaryLoaded);
+    }
+
+    ASSERT_EQ(binaryLoaded.size(), points.size());
+    EXPECT_EQ(binaryLoaded[500].x, 500.0f);
+
+    // Written by older versions, one node per element
+    std::istringstream legacy(R"({ "points": [ { "value0": 1.0, "value1": 2.0, "value2": 3.0 }, { "value0": 4.0, "value1": 5.0, "value2": 6.0 } ] })");
+    std::vector<Falcor::float3> legacyLoaded;
+    {
+        auto archive = Internal::SerializationManager::get().beginLoad(legacy);
+        ASSERT_NE(archive, std::nullopt);
+        (*archive)(LoadNamed("points", legacyLoaded));
+    }
+
+    ASSERT_EQ(legacyLoaded.size(), 2);
+    EXPECT_EQ(legacyLoaded[1].z, 6.0f);
+}
+
+
+TEST_F(VectorSerializationTest, BulkScalarAndMatrixArrays)
+{
+    std::vector<float> weights(256);
+    std::vector<Falcor::float4x4> matrices(64, Falcor::float4x4::identity());
+
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        weights[i] = static_cast<float>(i) * 0.5f;
+    }
+
+    for (size_t i = 0; i < matrices.size(); ++i)
+    {
+        matrices[i][0][3] = static_cast<float>(i);
+    }
+
+    std::ostringstream oss;
+    {
+        auto archive = Internal::SerializationManager::get().beginSave(oss);
+        ASSERT_NE(archive, std::nullopt);
+        (*archive)(SaveNamed("weights", weights), SaveNamed("matrices", matrices));
+    }
+
+    EXPECT_EQ(oss.str().find("\"value0\""), std::string::npos);
+
+    std::vector<float> loadedWeights;
+    std::vector<Falcor::float4x4> loadedMatrices;
+    std::istringstream iss(oss.str());
+    {
+        auto archive = Internal::SerializationManager::get().beginLoad(iss);
+        ASSERT_NE(archive, std::nullopt);
+        (*archive)(LoadNamed("weights", loadedWeights), LoadNamed("matrices", loadedMatrices));
+    }
+
+    EXPECT_EQ(loadedWeights, weights);
+    ASSERT_EQ(loadedMatrices.size(), matrices.size());
+    EXPECT_EQ(loadedMatrices[63][0][3], 63.0f);
+    EXPECT_EQ(loadedMatrices[63][3][3], 1.0f);
+
+    std::ostringstream binaryOss(std::ios::out | std::ios::binary);
+    {
+        BinaryOutputArchive archive(binaryOss);
+        archive(matrices);
+    }
+
+    EXPECT_LE(binaryOss.str().size(), matrices.size() * sizeof(Falcor::float4x4) + 16);
+
+    std::vector<Falcor::float4x4> binaryLoaded;
+    std::istringstream binaryIss(binaryOss.str(), std::ios::in | std::ios::binary);
+    {
+        BinaryInputArchive archive(binaryIss);
+        archive(binaryLoaded);
+    }
+
+    ASSERT_EQ(binaryLoaded.size(), matrices.size());
+    EXPECT_EQ(binaryLoaded[10][0][3], 10.0f);
+}
+
+} // namespace GraphEx::Test